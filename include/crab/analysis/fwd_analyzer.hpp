@@ -3,6 +3,7 @@
 
 #include <crab/cfg/cfg.hpp>
 #include <crab/cfg/var_factory.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/iterators/fwd_fixpoint_iterators.hpp>
 #include <crab/analysis/liveness.hpp>
 #include <crab/analysis/abs_transformer.hpp>
@@ -11,6 +12,8 @@
 
 #include "boost/range/algorithm/set_algorithm.hpp"
 
+#include <list>
+
 namespace crab {
 
   namespace analyzer {
@@ -61,7 +64,8 @@ namespace crab {
 
       typedef ikos::interleaved_fwd_fixpoint_iterator<basic_block_label_t, CFG, abs_dom_t>
       fwd_iterator_t;
-      typedef boost::unordered_map<basic_block_label_t, abs_dom_t> invariant_map_t;
+      // shared with the fixpoint iterator
+      typedef typename fwd_iterator_t::invariant_table_t invariant_table_t;
       
      public:
 
@@ -76,37 +80,52 @@ namespace crab {
 
      public:
 
-      typedef typename invariant_map_t::iterator iterator;        
-      typedef typename invariant_map_t::const_iterator const_iterator;        
+      typedef typename invariant_table_t::iterator iterator;        
+      typedef typename invariant_table_t::const_iterator const_iterator;        
 
      private:
 
       abs_tr_ptr m_abs_tr; // the abstract transformer
+      // the context of the abstract values. It is the current context
+      // while the analyzer computes new invariants.
+      analysis_context& m_ctx;
       const liveness_t* m_live;
-      live_set_t m_formals;
+      // the variables that are dead at the exit of each block, except
+      // the formal parameters and return values. Computed once from
+      // the liveness information.
+      typedef boost::unordered_map<basic_block_label_t, std::vector<varname_t> > dead_map_t;
+      dead_map_t m_dead_vars;
       
-      // Preserve invariants at the entry and exit. This might be
-      // expensive in terms of memory. To mitigate this, we could
-      // compute the invariants at the exit by propagating locally
+      // The invariants at the entry and exit of each block are the
+      // tables of the fixpoint iterator. This might be expensive in
+      // terms of memory. To mitigate this, if m_keep_post is false
+      // then the invariants at the exit are discarded once the
+      // fixpoint is reached and get_post recomputes them locally
       // from the invariants at the entry.
-      invariant_map_t  m_pre_map;
-      invariant_map_t  m_post_map;
-
-      void prune_dead_variables (abs_dom_t &inv, basic_block_label_t node) {
-        if (!m_live) return;
-
+      bool m_keep_post;
+      // the most recently recomputed invariants at the exit (most
+      // recent first). Only used if m_keep_post is false.
+      typedef std::list<std::pair<basic_block_label_t, abs_dom_t> > post_cache_t;
+      mutable post_cache_t m_post_cache;
+      unsigned int m_post_cache_size;
+
+      void prune_dead_variables (abs_dom_t &inv, basic_block_label_t node) const {
+        if (m_dead_vars.empty ()) return;
+
+        auto it = m_dead_vars.find (node);
+        if (it == m_dead_vars.end ()) return;
         if (inv.is_bottom() || inv.is_top()) return;
-        auto dead = m_live->dead_exit (node);       
-
-        dead -= m_formals;
         domains::domain_traits<abs_dom_t>::forget (inv, 
-                                                   dead.begin (), 
-                                                   dead.end ());
+                                                   it->second.begin (), 
+                                                   it->second.end ());
       }
 
       //! Given a basic block and the invariant at the entry it produces
       //! the invariant at the exit of the block.
       void analyze (basic_block_label_t node, abs_dom_t &inv) 
+      { replay (node, inv); } 
+
+      void replay (basic_block_label_t node, abs_dom_t &inv) const
       { 
         auto &b = this->get_cfg().get_node (node);
 	// XXX: set takes a reference to inv so no copies here
@@ -115,32 +134,58 @@ namespace crab {
         prune_dead_variables (inv, node);
       } 
       
-      void process_pre (basic_block_label_t node, abs_dom_t inv) 
+      // Replace bottom and top with their canonical representation
+      // to release any memory kept by the domain.
+      static void canonicalize (abs_dom_t &inv)
       {
-        auto it = m_pre_map.find (node);
-        if (it == m_pre_map.end())
-        {          
-          if (inv.is_bottom ())
-            m_pre_map.insert(make_pair (node, abs_dom_t::bottom ()));
-          else if (inv.is_top ())
-            m_pre_map.insert(make_pair (node, abs_dom_t::top ()));
-          else
-            m_pre_map.insert(make_pair (node, inv));
-        }
+        if (inv.is_bottom ())
+          inv = abs_dom_t::bottom ();
+        else if (inv.is_top ())
+          inv = abs_dom_t::top ();
       }
       
-      void process_post (basic_block_label_t node, abs_dom_t inv) 
-      {
-        auto it = m_post_map.find (node);
-        if (it == m_post_map.end())
-        {
-          if (inv.is_bottom ())
-            m_post_map.insert(make_pair (node, abs_dom_t::bottom ()));
-          else if (inv.is_top ())
-            m_post_map.insert(make_pair (node, abs_dom_t::top ()));
-          else
-            m_post_map.insert(make_pair (node, inv));
+      void process_pre (basic_block_label_t /*node*/, abs_dom_t &inv) 
+      { canonicalize (inv); }
+      
+      void process_post (basic_block_label_t /*node*/, abs_dom_t &inv) 
+      { canonicalize (inv); }
+
+      abs_dom_t get_inv (const invariant_table_t &table, basic_block_label_t b) const {
+        if (const abs_dom_t* inv = table.find (b))
+          return *inv;
+        else
+          return abs_dom_t::top ();
+      }
+
+      abs_dom_t recompute_post (basic_block_label_t b) const {
+        const abs_dom_t* pre = this->get_pre_table ().find (b);
+        if (!pre)
+          return abs_dom_t::top ();
+
+        for (auto it = m_post_cache.begin (); it != m_post_cache.end (); ++it) {
+          if (it->first == b) {
+            m_post_cache.splice (m_post_cache.begin (), m_post_cache, it);
+            return it->second;
+          }
+        }
+
+        CRAB_STATS_SCOPE ("Fixpo.recompute_post");
+        analysis_context::scope ctx (m_ctx);
+        abs_dom_t post (*pre);
+        replay (b, post);
+        canonicalize (post);
+        if (m_post_cache_size > 0) {
+          if (m_post_cache.size () >= m_post_cache_size)
+            m_post_cache.pop_back ();
+          m_post_cache.push_front (std::make_pair (b, post));
         }
+        return post;
+      }
+
+      void discard_post () {
+        m_post_cache.clear ();
+        if (!m_keep_post)
+          this->get_post_table ().clear ();
       }
       
      public:
@@ -151,52 +196,99 @@ namespace crab {
                     unsigned int descending_iters,
                     size_t jump_set_size,
 		    // live can be nullptr if no live info is available
-		    const liveness_t* live)
+		    const liveness_t* live,
+		    // if false the invariants at the exit of the blocks
+		    // are recomputed on demand
+		    bool keep_post = true,
+		    // number of recomputed invariants to cache
+		    unsigned int post_cache_size = 0)
           : fwd_iterator_t (cfg, widening_delay, descending_iters, jump_set_size), 
             m_abs_tr (abs_tr),
-	    m_live (live) {
+	    m_ctx (analysis_context::current ()),
+	    m_live (live),
+	    m_keep_post (keep_post),
+	    m_post_cache_size (post_cache_size) {
         
         if (live)
 	{
           // --- collect formal parameters and return values
+          live_set_t formals;
           if (auto fdecl = this->get_cfg ().get_func_decl ()) {
 	    for (unsigned i=0; i < (*fdecl).get_num_params();i++)
-	      m_formals += (*fdecl).get_param_name (i); 
+	      formals += (*fdecl).get_param_name (i); 
 	    auto const& ret_vals = find_return_vars (this->get_cfg ());
-	    for (auto rv: ret_vals) {  m_formals += rv; }
+	    for (auto rv: ret_vals) {  formals += rv; }
 	  }
+          // --- collect the dead variables of each block
+          for (auto &b: boost::make_iterator_range (this->get_cfg ().begin (),
+                                                    this->get_cfg ().end ())) {
+            auto dead = live->dead_exit (b.label ());
+            dead -= formals;
+            if (dead.is_bottom ()) continue;
+            std::vector<varname_t> &vars = m_dead_vars [b.label ()];
+            for (auto v: dead) vars.push_back (v);
+          }
         }
 
       }
       
-      iterator       pre_begin ()       { return m_pre_map.begin(); } 
-      iterator       pre_end ()         { return m_pre_map.end();   }
-      const_iterator pre_begin () const { return m_pre_map.begin(); }
-      const_iterator pre_end ()   const { return m_pre_map.end();   }
+      iterator       pre_begin ()       { return this->get_pre_table ().begin(); } 
+      iterator       pre_end ()         { return this->get_pre_table ().end();   }
+      const_iterator pre_begin () const { return this->get_pre_table ().begin(); }
+      const_iterator pre_end ()   const { return this->get_pre_table ().end();   }
       
-      iterator       post_begin ()       { return m_post_map.begin(); } 
-      iterator       post_end ()         { return m_post_map.end();   }
-      const_iterator post_begin () const { return m_post_map.begin(); }
-      const_iterator post_end ()   const { return m_post_map.end();   }
+      // The invariants at the exit of the blocks are only available
+      // through these iterators if keep_post is true.
+      iterator       post_begin ()       { return this->get_post_table ().begin(); } 
+      iterator       post_end ()         { return this->get_post_table ().end();   }
+      const_iterator post_begin () const { return this->get_post_table ().begin(); }
+      const_iterator post_end ()   const { return this->get_post_table ().end();   }
       
       //! Trigger the fixpoint computation 
       void Run ()  {
-        // initialization of static data
+        analysis_context::scope ctx (m_ctx);
+        // initialization of the data shared by all abstract values
         domains::domain_traits<abs_dom_t>::do_initialization (this->get_cfg());
-        // XXX: inv was created before the static data is initialized
+        // XXX: inv was created before the shared data is initialized
         //      so it won't contain that data.
         this->run (m_abs_tr->inv());         
+        discard_post ();
       }      
 
       // XXX: we prefer not to use a template parameter here
       typedef std::map<basic_block_label_t, abs_dom_t> inv_map_t;
       void Run (inv_map_t &inv_map)  {
-        // initialization of static data
+        analysis_context::scope ctx (m_ctx);
+        // initialization of the data shared by all abstract values
         domains::domain_traits<abs_dom_t>::do_initialization (this->get_cfg());
-        // XXX: inv was created before the static data is initialized
+        // XXX: inv was created before the shared data is initialized
         //      so it won't contain that data.	
         this->run (m_abs_tr->inv(), inv_map);         
+        discard_post ();
       }      
+
+      //! Recompute the invariants after the blocks in changed (and
+      //! possibly some edges) of the CFG have been modified. Only
+      //! the blocks reachable from changed are re-analyzed. Note
+      //! that the liveness information, if any, is not updated.
+      void ReRun (const std::vector<basic_block_label_t> &changed) {
+        const abs_dom_t* init = this->get_pre_table ().find (this->get_cfg ().entry ());
+        if (!init) {
+          Run ();
+          return;
+        }
+        analysis_context::scope ctx (m_ctx);
+        domains::domain_traits<abs_dom_t>::do_initialization (this->get_cfg());
+        if (m_keep_post) {
+          this->rerun (changed);
+        } else {
+          // the invariants at the exit are needed to restart the
+          // fixpoint so we analyze again the whole CFG.
+          abs_dom_t entry_inv (*init);
+          this->run (entry_inv);
+        }
+        discard_post ();
+      }
       
       //! Propagate inv through statements
       abs_tr_ptr get_abs_transformer (abs_dom_t &inv) {
@@ -212,20 +304,15 @@ namespace crab {
       
       //! Return the invariants that hold at the entry of b
       abs_dom_t get_pre (basic_block_label_t b) const { 
-        auto it = m_pre_map.find (b);
-        if (it == m_pre_map.end ())
-          return abs_dom_t::top ();
-        else
-          return it->second;
+        return get_inv (this->get_pre_table (), b);
       }
       
       //! Return the invariants that hold at the exit of b
       abs_dom_t get_post (basic_block_label_t b) const {
-        auto it = m_post_map.find (b);
-        if (it == m_post_map.end ())
-          return abs_dom_t::top ();
-        else 
-          return it->second;      
+        if (m_keep_post)
+          return get_inv (this->get_post_table (), b);
+        else
+          return recompute_post (b);
       }
 
       //! Return the WTO of the CFG. The WTO contains also how many
@@ -233,6 +320,13 @@ namespace crab {
       const wto_t& get_WTO () const {
 	return this->get_wto ();
       }
+
+      //! Return the context of the abstract values computed by the
+      //! analyzer. It is the current context when the analyzer was
+      //! created.
+      analysis_context& get_context () const {
+        return m_ctx;
+      }
       
     }; 
 
@@ -278,12 +372,15 @@ namespace crab {
 				   // fixpoint parameters
 				   unsigned int widening_delay=1,
 				   unsigned int descending_iters=UINT_MAX,
-				   size_t jump_set_size=0):
+				   size_t jump_set_size=0,
+				   // keep the invariants at the exit of blocks
+				   bool keep_post=true,
+				   unsigned int post_cache_size=0):
 	m_init (init),
 	m_abs_tr (&m_init),
 	m_analyzer (cfg, &m_abs_tr, 
 		    widening_delay, descending_iters, jump_set_size,
-		    live) { }
+		    live, keep_post, post_cache_size) { }
       
       iterator       pre_begin ()       { return m_analyzer.pre_begin();} 
       iterator       pre_end ()         { return m_analyzer.pre_end();}
@@ -296,6 +393,9 @@ namespace crab {
       const_iterator post_end ()   const { return m_analyzer.post_end();}
 
       void run () { m_analyzer.Run ();}
+
+      void rerun (const std::vector<basic_block_label_t> &changed)
+      { m_analyzer.ReRun (changed);}
       
       abs_dom_t operator[] (basic_block_label_t b) const
       { return m_analyzer[b]; }
@@ -315,6 +415,9 @@ namespace crab {
       const wto_t& get_wto () const {
 	return m_analyzer.get_WTO ();
       }
+
+      analysis_context& get_context () const
+      { return m_analyzer.get_context (); }
       
     };
 
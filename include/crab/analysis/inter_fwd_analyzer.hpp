@@ -12,6 +12,8 @@
 
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
+#include <crab/common/parallel.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/cfg/cfg.hpp>
 #include <crab/cg/cg.hpp>
 #include <crab/domains/domain_traits.hpp>
@@ -20,6 +22,7 @@
 #include <crab/analysis/fwd_analyzer.hpp>
 #include <crab/analysis/liveness.hpp>
 #include <crab/analysis/inter_fwd_analyzer_ds.hpp>
+#include <crab/analysis/summary_cache.hpp>
 
 namespace crab {
 
@@ -55,6 +58,7 @@ namespace crab {
       typedef boost::shared_ptr<td_abs_tr> td_abs_tr_ptr;
       typedef fwd_analyzer<cfg_t, bu_abs_tr> bu_analyzer;
       typedef fwd_analyzer<cfg_t, td_abs_tr> td_analyzer;
+      typedef summary_cache<cfg_t, BU_Dom> summ_cache_t;
 
      public:
 
@@ -75,6 +79,12 @@ namespace crab {
       unsigned int m_widening_delay;
       unsigned int m_descending_iters;
       size_t m_jump_set_size; // max size of the jump set (=0 if jump set disabled)
+      unsigned int m_num_threads; // threads used by both phases
+      summ_cache_t* m_summ_cache; // persistent summaries (can be null)
+      // context of the abstract values shared by all the threads
+      analysis_context& m_ctx;
+      // cache key of each function (only if m_summ_cache)
+      boost::unordered_map<std::size_t, uint64_t> m_summ_keys;
       
       const liveness_t* get_live (const cfg_t& c) {
         if (m_live) {
@@ -85,16 +95,240 @@ namespace crab {
         return nullptr;
       }
       
+      //! Compute the cache keys of all functions. The key of a
+      //  function depends on its SCC and, transitively, on all its
+      //  callees.
+      void compute_summary_keys (graph_algo::scc_graph<CG> &Scc_g,
+                                 const std::vector<cg_node_t> &rev_order) {
+        CRAB_STATS_SCOPE ("Inter.SummaryCache.keys");
+        crab_string_os params;
+        params << m_widening_delay << "," << m_descending_iters << ","
+               << m_jump_set_size << "," << (m_live != nullptr);
+
+        boost::unordered_map<cg_node_t, uint64_t> scc_keys;
+        // callees are visited before callers
+        for (auto n: rev_order) {
+          auto &scc_mems = Scc_g.get_component_members (n);
+          std::vector<std::string> scc_cfgs;
+          for (auto m: scc_mems)
+            scc_cfgs.push_back (summary_cache_impl::to_string (m.get_cfg ()));
+          std::vector<uint64_t> callee_keys;
+          for (auto e: boost::make_iterator_range (Scc_g.succs (n)))
+            callee_keys.push_back (scc_keys [e.Dest ()]);
+
+          scc_keys [n] = summ_cache_t::make_key ("", scc_cfgs, callee_keys, params.str ());
+          for (auto m: scc_mems) {
+            auto fdecl = m.get_cfg ().get_func_decl ();
+            assert (fdecl);
+            m_summ_keys [cfg::cfg_hasher<cfg_t>::hash (*fdecl)] =
+                summ_cache_t::make_key ((*fdecl).get_func_name ().str (),
+                                        scc_cfgs, callee_keys, params.str ());
+          }
+        }
+      }
+
+      //! Compute the summaries of all the members of a SCC
+      void bottom_up (const std::vector<cg_node_t> &scc_mems) {
+        for (auto m: scc_mems) {
+          auto cfg = m.get_cfg ();
+          auto fdecl = cfg.get_func_decl ();            
+          assert (fdecl);
+
+          std::string fun_name = (*fdecl).get_func_name ().str();
+          if (fun_name != "main" && cfg.has_exit ()) {
+            // --- formal parameters and return values
+            std::vector<varname_t> formals, inputs, outputs;
+            formals.reserve ((*fdecl).get_num_params() + (*fdecl).get_lhs_types().size ());
+            inputs.reserve ((*fdecl).get_num_params());
+            outputs.reserve ((*fdecl).get_lhs_types().size ());
+
+            for (unsigned i=0; i < (*fdecl).get_num_params();i++) {
+              inputs.push_back ((*fdecl).get_param_name (i));
+              formals.push_back ((*fdecl).get_param_name (i));
+            }
+            auto const&ret_vals = find_return_vars (cfg);
+            for (auto rv: ret_vals)  {
+              outputs.push_back (rv);
+              formals.push_back (rv);
+            }
+
+            uint64_t key = 0;
+            if (m_summ_cache) {
+              key = m_summ_keys [cfg::cfg_hasher<cfg_t>::hash (*fdecl)];
+              BU_Dom inv = BU_Dom::top ();
+              if (m_summ_cache->lookup (key, formals, inv)) {
+                CRAB_LOG ("inter", 
+                          crab::outs() << "--- Reusing cached summary of "
+                                       << (*fdecl).get_func_name () << "\n");
+                m_summ_tbl.insert (*fdecl, inv, inputs, outputs);
+                continue;
+              }
+            }
+
+            CRAB_LOG ("inter", 
+                      crab::outs() << "--- Analyzing " << (*fdecl).get_func_name () << "\n");
+            // --- run the analysis
+            auto init_inv = BU_Dom::top ();
+            bu_abs_tr abs_tr (&init_inv, &m_summ_tbl);
+            bu_analyzer a (cfg, &abs_tr, 
+                           m_widening_delay, m_descending_iters, m_jump_set_size,
+                           get_live (cfg)) ; 
+            a.Run ();
+
+            // --- project onto formal parameters and return values
+            auto inv = a.get_post (cfg.exit ());
+            //crab::CrabStats::count (BU_Dom::getDomainName() + ".count.project");
+            domains::domain_traits<BU_Dom>::project (inv,
+                                                     formals.begin (), 
+                                                     formals.end ());            
+
+            m_summ_tbl.insert (*fdecl, inv, inputs, outputs);
+            if (m_summ_cache)
+              m_summ_cache->insert (key, formals, inv);
+          }
+        }
+      }
+      
+      //! Analyze the members of a SCC starting from their calling
+      //  contexts. The calling contexts are read from call_tbl after
+      //  joining into it those found in callers_tbls. Contexts
+      //  generated by the members are stored in call_tbl.
+      void top_down (const std::vector<cg_node_t> &scc_mems,
+                     bool is_root, const TD_Dom &init,
+                     const std::vector<const call_tbl_t*> &callers_tbls,
+                     call_tbl_t &call_tbl,
+                     std::vector<std::pair<std::size_t, td_analyzer_ptr> > &res) {
+        for (auto m: scc_mems) {
+          auto cfg = m.get_cfg ();
+          auto fdecl = cfg.get_func_decl ();
+          assert (fdecl);
+          CRAB_LOG ("inter", 
+                    crab::outs() << "--- Analyzing " 
+                                 << (*fdecl).get_func_name () << "\n");
+          for (auto tbl: callers_tbls) {
+            if (tbl->has_call_ctx (*fdecl))
+              call_tbl.insert (*fdecl, tbl->get_call_ctx (*fdecl));
+          }
+          
+          if (scc_mems.size () > 1) {
+            // If the node is recursive then what we have in call_tbl
+            // is incomplete and therefore it is unsound to use it. To
+            // remedy it, we insert another calling context with top
+            // value that approximates all the possible calling
+            // contexts during the recursive calls.
+            call_tbl.insert (*fdecl, TD_Dom::top ());
+          }
+	   
+          auto init_inv = init;	    
+          if (is_root)
+            is_root = false;
+          else
+          {
+            init_inv = call_tbl.get_call_ctx (*fdecl);	      
+            CRAB_LOG("inter",
+                     crab::outs() << "    Starting analysis of "
+                                  << *fdecl <<  " with " << init_inv << "\n");
+          }
+
+          auto abs_tr = boost::make_shared<td_abs_tr> (&init_inv, &m_summ_tbl, &call_tbl);
+          auto a = boost::make_shared<td_analyzer> (cfg, &*abs_tr, 
+                                                    m_widening_delay,
+                                                    m_descending_iters,
+                                                    m_jump_set_size,
+                                                    get_live (cfg));
+          a->Run();
+          res.push_back (std::make_pair (cfg::cfg_hasher<cfg_t>::hash(*fdecl), a));
+        }
+      }
+
+      //! Both phases of the analysis driven by the dependencies
+      //  between SCCs. In the bottom-up phase a SCC is analyzed as
+      //  soon as all the SCCs it calls have been summarized. In the
+      //  top-down phase a SCC is analyzed as soon as all its callers
+      //  have contributed with their calling contexts.
+      void run_parallel (graph_algo::scc_graph<CG> &Scc_g,
+                         const std::vector<cg_node_t> &rev_order,
+                         const TD_Dom &init) {
+        const std::size_t num_sccs = rev_order.size ();
+        boost::unordered_map<cg_node_t, std::size_t> scc_ids;
+        std::vector<std::vector<cg_node_t>*> scc_mems;
+        scc_mems.reserve (num_sccs);
+        for (auto n: rev_order) {
+          scc_ids.insert (std::make_pair (n, scc_mems.size ()));
+          scc_mems.push_back (&Scc_g.get_component_members (n));
+        }
+        // callers and callees are sorted by position in rev_order
+        std::vector<std::vector<std::size_t> > callers (num_sccs), callees (num_sccs);
+        for (std::size_t i=0; i < num_sccs; i++) {
+          for (auto e: boost::make_iterator_range (Scc_g.succs (rev_order [i]))) {
+            std::size_t j = scc_ids [e.Dest ()];
+            callers [j].push_back (i);
+            callees [i].push_back (j);
+          }
+        }
+        for (auto &cs: callees) std::sort (cs.begin (), cs.end ());
+
+        CRAB_LOG("inter",crab::outs() << "Bottom-up phase ...\n");
+        {
+          CRAB_STATS_SCOPE ("Inter.BottomUp");
+          parallel::run_dag (callers, m_num_threads,
+                             [&](std::size_t i) {
+                               analysis_context::scope ctx (m_ctx);
+                               bottom_up (*(scc_mems [i]));
+                             });
+        }
+
+        CRAB_LOG ("inter", crab::outs() << "Top-down phase ...\n");
+        {
+          CRAB_STATS_SCOPE ("Inter.TopDown");
+          // Each SCC stores the calling contexts it generates in its
+          // own table. Callers' tables are merged always in the same
+          // order so the result does not depend on the scheduling.
+          std::vector<boost::shared_ptr<call_tbl_t> > call_tbls (num_sccs);
+          for (auto &tbl: call_tbls) tbl = boost::make_shared<call_tbl_t> ();
+          std::vector<std::vector<std::pair<std::size_t, td_analyzer_ptr> > > res (num_sccs);
+          parallel::run_dag (callees, m_num_threads,
+                             [&](std::size_t i) {
+                               analysis_context::scope ctx (m_ctx);
+                               std::vector<const call_tbl_t*> callers_tbls;
+                               for (auto c: boost::make_iterator_range (callers [i].rbegin (),
+                                                                        callers [i].rend ()))
+                                 callers_tbls.push_back (&*(call_tbls [c]));
+                               top_down (*(scc_mems [i]), i == num_sccs - 1, init,
+                                         callers_tbls, *(call_tbls [i]), res [i]);
+                             });
+          
+          for (std::size_t i = num_sccs; i > 0; i--) {
+            m_call_tbl.merge (*(call_tbls [i-1]));
+            m_inv_map.insert (res [i-1].begin (), res [i-1].end ());
+          }
+        }
+      }
+      
      public:
       
       inter_fwd_analyzer (CG cg, const liveness_map_t* live,
                           unsigned int widening_delay=1,
                           unsigned int descending_iters=UINT_MAX,
-                          size_t jump_set_size=0)
+                          size_t jump_set_size=0,
+                          // If greater than 1 then SCCs of the call
+                          // graph without paths between them are
+                          // analyzed in parallel. All threads share
+                          // the current analysis context so this
+                          // requires BU_Dom and TD_Dom to be
+                          // thread-safe.
+                          unsigned int num_threads=1,
+                          // If not null then summaries found in
+                          // the cache are not recomputed and new
+                          // summaries are added to it.
+                          summ_cache_t* summ_cache=nullptr)
           : m_cg (cg), m_live (live),
             m_widening_delay (widening_delay), 
             m_descending_iters (descending_iters),
-            m_jump_set_size (jump_set_size) { }
+            m_jump_set_size (jump_set_size),
+            m_num_threads (num_threads),
+            m_summ_cache (summ_cache),
+            m_ctx (analysis_context::current ()) { }
       
       //! Trigger the whole analysis
       void Run (TD_Dom init = TD_Dom::top ())  {
@@ -102,7 +336,8 @@ namespace crab {
         CRAB_LOG("inter", 
                  m_cg.write (crab::outs()); crab::outs () << "\n");
                  
-        crab::ScopedCrabStats __st__("Inter");
+        CRAB_STATS_SCOPE ("Inter");
+        analysis_context::scope ctx (m_ctx);
 
         bool has_noedges = true;
         for (auto const &v: boost::make_iterator_range (vertices (m_cg))) {
@@ -123,7 +358,7 @@ namespace crab {
                    
 
           for (auto &v: boost::make_iterator_range (vertices (m_cg))) {
-            crab::ScopedCrabStats __st__("Inter.TopDown");
+            CRAB_STATS_SCOPE ("Inter.TopDown");
 
             auto cfg = v.get_cfg ();
             auto fdecl = cfg.get_func_decl ();
@@ -151,99 +386,31 @@ namespace crab {
         std::vector<cg_node_t> rev_order;
 	graph_algo::scc_graph<CG> Scc_g (m_cg);
         graph_algo::rev_topo_sort<graph_algo::scc_graph<CG> > (Scc_g, rev_order);
+
+        if (m_summ_cache)
+          compute_summary_keys (Scc_g, rev_order);
+
+        if (m_num_threads > 1) {
+          run_parallel (Scc_g, rev_order, init);
+          return;
+        }
        
         CRAB_LOG("inter",crab::outs() << "Bottom-up phase ...\n");
         for (auto n: rev_order) {
-          crab::ScopedCrabStats __st__("Inter.BottomUp");
-          std::vector<cg_node_t> &scc_mems = Scc_g.get_component_members (n);
-          for (auto m: scc_mems) {
-
-            auto cfg = m.get_cfg ();
-            auto fdecl = cfg.get_func_decl ();            
-            assert (fdecl);
-
-            std::string fun_name = (*fdecl).get_func_name ().str();
-            if (fun_name != "main" && cfg.has_exit ()) {
-              CRAB_LOG ("inter", 
-                        crab::outs() << "--- Analyzing " << (*fdecl).get_func_name () << "\n");
-              // --- run the analysis
-	      auto init_inv = BU_Dom::top ();
-	      bu_abs_tr abs_tr (&init_inv, &m_summ_tbl);
-              bu_analyzer a (cfg, &abs_tr, 
-                             m_widening_delay, m_descending_iters, m_jump_set_size,
-			     get_live (cfg)) ; 
-              a.Run ();
-	      
-              // --- build the summary
-              std::vector<varname_t> formals, inputs, outputs;
-              formals.reserve ((*fdecl).get_num_params() + (*fdecl).get_lhs_types().size ());
-              inputs.reserve ((*fdecl).get_num_params());
-              outputs.reserve ((*fdecl).get_lhs_types().size ());
-
-              for (unsigned i=0; i < (*fdecl).get_num_params();i++) {
-                inputs.push_back ((*fdecl).get_param_name (i));
-                formals.push_back ((*fdecl).get_param_name (i));
-              }
-              auto const&ret_vals = find_return_vars (cfg);
-              for (auto rv: ret_vals)  {
-                outputs.push_back (rv);
-                formals.push_back (rv);
-              }
-
-              // --- project onto formal parameters and return values
-              auto inv = a.get_post (cfg.exit ());
-              //crab::CrabStats::count (BU_Dom::getDomainName() + ".count.project");
-              domains::domain_traits<BU_Dom>::project (inv,
-                                                       formals.begin (), 
-                                                       formals.end ());            
-
-              m_summ_tbl.insert (*fdecl, inv, inputs, outputs);
-            }
-          }
-        } 
+          CRAB_STATS_SCOPE ("Inter.BottomUp");
+          bottom_up (Scc_g.get_component_members (n));
+        }
 
         CRAB_LOG ("inter", crab::outs() << "Top-down phase ...\n");
         bool is_root = true;
         for (auto n: boost::make_iterator_range (rev_order.rbegin(),
                                                  rev_order.rend ())) {
-          crab::ScopedCrabStats __st__("Inter.TopDown");
-          std::vector<cg_node_t> &scc_mems = Scc_g.get_component_members (n);
-          for (auto m: scc_mems) {
-            auto cfg = m.get_cfg ();
-            auto fdecl = cfg.get_func_decl ();
-            assert (fdecl);
-            CRAB_LOG ("inter", 
-                      crab::outs() << "--- Analyzing " 
-                                   << (*fdecl).get_func_name () << "\n");
-            if (scc_mems.size () > 1) {
-              // If the node is recursive then what we have in m_call_tbl
-              // is incomplete and therefore it is unsound to use it. To
-              // remedy it, we insert another calling context with top
-              // value that approximates all the possible calling
-              // contexts during the recursive calls.
-              m_call_tbl.insert (*fdecl, TD_Dom::top ());
-            }
-	   
-	    auto init_inv = init;	    
-            if (is_root)
-              is_root = false;
-            else
-	    {
-	      init_inv = m_call_tbl.get_call_ctx (*fdecl);	      
-              CRAB_LOG("inter",
-                       crab::outs() << "    Starting analysis of "
-  		                    << *fdecl <<  " with " << init_inv << "\n");
-            }
-
-	    auto abs_tr = boost::make_shared<td_abs_tr> (&init_inv, &m_summ_tbl, &m_call_tbl);
-            auto a = boost::make_shared<td_analyzer> (cfg, &*abs_tr, 
-                                                      m_widening_delay,
-						      m_descending_iters,
-						      m_jump_set_size,
-						      get_live (cfg));
-	    a->Run();
-            m_inv_map.insert (std::make_pair (cfg::cfg_hasher<cfg_t>::hash(*fdecl), a));
-          }
+          CRAB_STATS_SCOPE ("Inter.TopDown");
+          std::vector<std::pair<std::size_t, td_analyzer_ptr> > res;
+          top_down (Scc_g.get_component_members (n), is_root, init,
+                    std::vector<const call_tbl_t*> (), m_call_tbl, res);
+          is_root = false;
+          m_inv_map.insert (res.begin (), res.end ());
         }
       }
 
@@ -252,6 +419,12 @@ namespace crab {
         return m_cg;
       }
 
+      //! Return the context of the abstract values computed by the
+      //! analyzer
+      analysis_context& get_context () const {
+        return m_ctx;
+      }
+
       //! Return the invariants that hold at the entry of b in cfg
       TD_Dom get_pre (const cfg_t &cfg, 
                       typename cfg_t::basic_block_label_t b) const { 
@@ -1,6 +1,9 @@
 #ifndef INTER_FWD_ANALYSIS_DATASTRUCTURES_HPP
 #define INTER_FWD_ANALYSIS_DATASTRUCTURES_HPP
 
+#include <algorithm>
+#include <mutex>
+
 #include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
@@ -22,7 +25,12 @@ namespace crab {
     // context-sensitive approach we would need to allow multiple
     // summaries per function.
 
-    /* Store the calling contexts of each function */  
+    /* Store the calling contexts of each function.
+
+       The table is not synchronized. During a parallel top-down phase
+       each analysis records the contexts it generates in its own
+       table and the tables of all callers are merged, in a fixed
+       order, before a callee is analyzed. */  
     template <typename CFG, typename AbsDomain>
     class call_ctx_table: boost::noncopyable {
      public:
@@ -63,6 +71,12 @@ namespace crab {
         insert_helper (cfg::cfg_hasher<CFG>::hash (d), inv);
       }
 
+      // return true if some calling context has been stored for d
+      bool has_call_ctx (fdecl_t d) const {
+        auto it = m_call_table.find (cfg::cfg_hasher<CFG>::hash (d));
+        return (it != m_call_table.end ());
+      }
+
       AbsDomain get_call_ctx (fdecl_t d) const {
         auto it = m_call_table.find (cfg::cfg_hasher<CFG>::hash (d));
         if (it != m_call_table.end ())
@@ -71,9 +85,20 @@ namespace crab {
           return AbsDomain::top ();
       }
 
+      // join all the calling contexts stored in o into this table
+      void merge (const call_ctx_table<CFG, AbsDomain> &o) {
+        for (auto const &p: o.m_call_table)
+          insert_helper (p.first, p.second);
+      }
+
     };
 
-    /* Store the summaries for each function*/
+    /* Store the summaries for each function. 
+       
+       The table can be accessed concurrently: summaries are inserted
+       by the bottom-up phase while other threads may be looking up
+       summaries of already analyzed functions. Summaries are never
+       removed so references returned by get remain valid. */
     template<typename CFG, typename AbsDomain>
     class summary_table: boost::noncopyable {
 
@@ -166,6 +191,7 @@ namespace crab {
       typedef boost::unordered_map <std::size_t, summary_ptr> summary_table_t;
       
       summary_table_t m_sum_table;
+      mutable std::mutex m_mutex;
       
      public:
 
@@ -180,22 +206,26 @@ namespace crab {
         std::vector<varname_t> ps (params.begin(), params.end ());
         std::vector<varname_t> rvs (ret_vals.begin(), ret_vals.end ());
         summary_ptr sum_tuple (new Summary (d, sum, ps, rvs));
+        std::lock_guard<std::mutex> lock (m_mutex);
         m_sum_table.insert (std::make_pair (cfg::cfg_hasher<CFG>::hash (d), sum_tuple));
       }
 
       // return true if there is a summary
       bool hasSummary (callsite_t cs) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (cfg::cfg_hasher<CFG>::hash (cs));
         return (it != m_sum_table.end ());
       }
 
       bool hasSummary (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (cfg::cfg_hasher<CFG>::hash (d));
         return (it != m_sum_table.end ());
       }
 
       // get the summary
       Summary& get (callsite_t cs) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (cfg::cfg_hasher<CFG>::hash (cs));
         assert (it != m_sum_table.end ());
         
@@ -203,6 +233,7 @@ namespace crab {
       }
 
       Summary& get (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (cfg::cfg_hasher<CFG>::hash (d));
         assert (it != m_sum_table.end ());
         
@@ -210,8 +241,18 @@ namespace crab {
       }
 
       void write (crab_os &o) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         o << "--- Begin summary table: \n";
-        for (auto const &p: m_sum_table) {
+        // sort by key so that the output does not depend on the
+        // order in which summaries were inserted.
+        std::vector<std::pair<std::size_t, summary_ptr> > sorted_table
+            (m_sum_table.begin (), m_sum_table.end ());
+        std::sort (sorted_table.begin (), sorted_table.end (),
+                   [](const std::pair<std::size_t, summary_ptr> &p1,
+                      const std::pair<std::size_t, summary_ptr> &p2) {
+                     return p1.first < p2.first;
+                   });
+        for (auto const &p: sorted_table) {
           p.second->write (o);
           o << "\n";
         }
@@ -17,15 +17,21 @@ namespace crab {
    template<typename V>
    using liveness_domain = crab::domains::flat_killgen_domain<V>;       
 
+   // The fixpoint is computed on bitsets: the variables of the CFG
+   // are numbered from 0 so that the size of the bitsets is the
+   // number of variables of the CFG.
+   template<typename V>
+   using liveness_bitset = crab::domains::bitset_killgen_domain<V>;
     
    template<class CFG>
    class liveness_ops:
       public crab::iterators::
-      killgen_operations_api<CFG, liveness_domain<typename CFG::varname_t> > {
+      killgen_operations_api<CFG, liveness_bitset<typename CFG::varname_t> > {
 
    public:
      
-     typedef liveness_domain<typename CFG::varname_t> liveness_domain_t;
+     typedef typename CFG::varname_t varname_t;
+     typedef liveness_bitset<varname_t> liveness_domain_t;
      typedef typename CFG::basic_block_label_t basic_block_label_t;
 
    private:
@@ -33,8 +39,21 @@ namespace crab {
      typedef crab::iterators::killgen_operations_api<CFG, liveness_domain_t> this_type;
      typedef std::pair<liveness_domain_t, liveness_domain_t> binding_t;
      typedef boost::unordered_map<basic_block_label_t, binding_t> liveness_map_t;
+     typedef typename liveness_domain_t::universe_t universe_t;
      
      liveness_map_t _liveness_map;
+     // variables of the CFG and their positions in the bitsets
+     universe_t _vars;
+     boost::unordered_map<varname_t, std::size_t> _positions;
+
+     std::size_t position (const varname_t &v) {
+       auto it = _positions.find (v);
+       if (it != _positions.end ()) return it->second;
+       std::size_t pos = _vars.size ();
+       _vars.push_back (v);
+       _positions.insert (std::make_pair (v, pos));
+       return pos;
+     }
 
     public:
 
@@ -43,24 +62,25 @@ namespace crab {
      virtual bool is_forward () { return false; }
 
      virtual liveness_domain_t entry() 
-     { return liveness_domain_t::bottom();}
+     { return liveness_domain_t (&_vars);}
 
      virtual liveness_domain_t merge(liveness_domain_t d1,  liveness_domain_t d2)
-     { return d1 | d2; }
+     { d1 += d2; return d1; }
 
      virtual void init_fixpoint() {
         for (auto &b: boost::make_iterator_range(this->_cfg.begin(),this->_cfg.end())) {
-          liveness_domain_t kill, gen;
+          liveness_domain_t kill (&_vars), gen (&_vars);
           for (auto &s: boost::make_iterator_range(b.rbegin(),b.rend())) { 
              auto live = s.get_live();
              for (auto d: boost::make_iterator_range(live.defs_begin(), 
                                                      live.defs_end())) {
-               kill += d; 
-               gen -= d;
+               std::size_t pos = position (d);
+               kill.add (pos); 
+               gen.remove (pos);
              }
              for (auto u: boost::make_iterator_range(live.uses_begin(), 
                                                      live.uses_end())) {
-               gen  += u; 
+               gen.add (position (u)); 
              }
           }
           _liveness_map.insert(std::make_pair(b.label(), binding_t(kill, gen)));
@@ -76,6 +96,12 @@ namespace crab {
       }
 
       virtual std::string name () { return "liveness";}
+
+      //! whether v belongs to a set computed by the analysis
+      bool contains (const liveness_domain_t &s, const varname_t &v) const {
+        auto it = _positions.find (v);
+        return it != _positions.end () && s.contains (it->second);
+      }
    };
 
    //! Live variable analysis
@@ -93,7 +119,8 @@ namespace crab {
     private:
 
      typedef liveness_ops<CFG> liveness_ops_t;
-     typedef typename liveness_ops_t::liveness_domain_t liveness_domain_t;
+     typedef typename liveness_ops_t::liveness_domain_t live_bitset_t;
+     typedef liveness_domain<varname_t> liveness_domain_t;
      typedef crab::iterators::killgen_fixpoint_iterator<CFG,liveness_ops_t> 
              killgen_fixpoint_iterator_t;
      
@@ -115,11 +142,14 @@ namespace crab {
      unsigned _total_blks;
 
      void process_post (basic_block_label_t bb, 
-                        liveness_domain_t live_out) {
+                        live_bitset_t live_out) {
        // --- Collect dead variables at the exit of bb
        if (!live_out.is_bottom ()) {
-         liveness_domain_t dead_set = this->_cfg.get_node(bb).live();
-         dead_set -= live_out;
+         liveness_domain_t dead_set;
+         for (auto v: this->_cfg.get_node(bb).live()) {
+           if (!this->get_analysis ().contains (live_out, v))
+             dead_set += v;
+         }
          CRAB_LOG("liveness",
                   crab::outs() << cfg_impl::get_label_str(bb) 
                                << " dead variables=" << dead_set <<"\n";);
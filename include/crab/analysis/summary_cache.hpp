@@ -0,0 +1,318 @@
+#ifndef SUMMARY_CACHE_HPP
+#define SUMMARY_CACHE_HPP
+
+/*
+   A persistent store of function summaries.
+
+   Summaries are keyed by a stable hash of the function's CFG and the
+   keys of all the functions it (transitively) calls so a summary can
+   be reused by a later run as long as neither the function nor its
+   callees changed.
+
+   A summary is stored as the linear constraint system of the
+   abstract state, where variables are replaced with their position
+   among the formal parameters and return values of the function.
+   This is exact for domains such as intervals and SplitDBM, and
+   sound for any numerical domain (e.g., the reduced products in
+   combined_domains.hpp).
+
+   File format (native endianness):
+
+     magic    : "CRABSUM1"
+     domain   : string
+     #records : u32
+     records  : (key: u64, size: u32, payload: size bytes)*
+
+   where strings are a u32 length followed by the characters and
+   the payload of a record is
+
+     is_bottom : u8
+     #csts     : u32
+     csts      : (kind: u8, constant: string, #terms: u32,
+                  (coefficient: string, formal: u32)*)*
+
+   The file is memory-mapped when loaded and records are decoded only
+   when they are looked up.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <crab/common/types.hpp>
+#include <crab/common/binary_io.hpp>
+#include <crab/common/debug.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/domains/linear_constraints.hpp>
+
+namespace crab {
+
+  namespace analyzer {
+
+    namespace summary_cache_impl {
+
+      // 64-bit FNV-1a: unlike std::hash it is stable across runs
+      // and platforms.
+      inline uint64_t hash_bytes (uint64_t h, const char* s, std::size_t n) {
+        for (std::size_t i=0; i < n; i++) {
+          h ^= (unsigned char) s[i];
+          h *= 1099511628211ULL;
+        }
+        return h;
+      }
+
+      inline uint64_t hash_string (uint64_t h, const std::string &s) {
+        // include the length so that concatenations are not ambiguous
+        uint64_t n = s.size ();
+        h = hash_bytes (h, (const char*) &n, sizeof (n));
+        return hash_bytes (h, s.data (), s.size ());
+      }
+
+      inline uint64_t hash_combine (uint64_t h, uint64_t k) {
+        return hash_bytes (h, (const char*) &k, sizeof (k));
+      }
+
+      const uint64_t hash_seed = 14695981039346656037ULL;
+
+      using binary_io::writer;
+      using binary_io::reader;
+
+      template<typename T>
+      inline std::string to_string (const T &v) {
+        crab_string_os os;
+        os << v;
+        return os.str ();
+      }
+    } // end namespace summary_cache_impl
+
+    /* The cache can be accessed concurrently by a parallel bottom-up
+       phase. */
+    template<typename CFG, typename AbsDomain>
+    class summary_cache: boost::noncopyable {
+
+     public:
+
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::number_t number_t;
+      typedef typename AbsDomain::linear_constraint_t linear_constraint_t;
+      typedef typename AbsDomain::linear_constraint_system_t linear_constraint_system_t;
+      typedef typename AbsDomain::linear_expression_t linear_expression_t;
+      typedef typename AbsDomain::variable_t variable_t;
+
+     private:
+
+      typedef std::pair<const char*, uint32_t> mapped_record_t;
+
+      // records of the loaded file
+      boost::unordered_map<uint64_t, mapped_record_t> m_mapped;
+      // records added by the current run
+      boost::unordered_map<uint64_t, std::string> m_added;
+      binary_io::mapped_file m_map;
+      unsigned m_hits;
+      mutable std::mutex m_mutex;
+
+      static const char* magic () { return "CRABSUM1"; }
+
+      void unmap () {
+        m_map.close ();
+        m_mapped.clear ();
+      }
+
+      static bool encode (const AbsDomain &sum, const std::vector<varname_t> &formals,
+                          std::string &buf) {
+        using namespace summary_cache_impl;
+        writer w (buf);
+        AbsDomain tmp (sum);
+        w.write<uint8_t> (tmp.is_bottom ());
+        if (tmp.is_bottom ()) {
+          w.write<uint32_t> (0);
+          return true;
+        }
+        linear_constraint_system_t csts = tmp.to_linear_constraint_system ();
+        std::vector<const linear_constraint_t*> cs;
+        for (auto const &c: csts) cs.push_back (&c);
+        w.write<uint32_t> (cs.size ());
+        for (auto c: cs) {
+          w.write<uint8_t> (c->kind ());
+          w.write (to_string (c->expression ().constant ()));
+          w.write<uint32_t> (c->size ());
+          for (auto const &t: *c) {
+            auto it = std::find (formals.begin (), formals.end (), t.second.name ());
+            if (it == formals.end ()) {
+              // the summary is not expressed only in terms of the formals
+              return false;
+            }
+            w.write (to_string (t.first));
+            w.write<uint32_t> (it - formals.begin ());
+          }
+        }
+        return true;
+      }
+
+      static bool decode (const char* begin, const char* end,
+                          const std::vector<varname_t> &formals, AbsDomain &sum) {
+        using namespace summary_cache_impl;
+        reader r (begin, end);
+        bool is_bottom = r.read<uint8_t> ();
+        uint32_t num_csts = r.read<uint32_t> ();
+        if (!r.ok ()) return false;
+        if (is_bottom) {
+          sum = AbsDomain::bottom ();
+          return true;
+        }
+        linear_constraint_system_t csts;
+        for (uint32_t i=0; i < num_csts; i++) {
+          uint8_t kind = r.read<uint8_t> ();
+          linear_expression_t e (number_t (r.read_string ()));
+          uint32_t num_terms = r.read<uint32_t> ();
+          if (!r.ok ()) return false;
+          for (uint32_t j=0; j < num_terms; j++) {
+            number_t coef (r.read_string ());
+            uint32_t idx = r.read<uint32_t> ();
+            if (!r.ok () || idx >= formals.size ()) return false;
+            e = e + coef * variable_t (formals [idx]);
+          }
+          if (kind > linear_constraint_t::INEQUALITY) return false;
+          csts += linear_constraint_t (e, (typename linear_constraint_t::kind_t) kind);
+        }
+        sum = AbsDomain::top ();
+        sum += csts;
+        return true;
+      }
+
+     public:
+
+      summary_cache ()
+          : m_hits (0) { }
+
+      ~summary_cache () { unmap (); }
+
+      //! Load the summaries stored in file. Return false if the file
+      //! does not exist or it was not created for AbsDomain.
+      bool load (const std::string &file) {
+        using namespace summary_cache_impl;
+        std::lock_guard<std::mutex> lock (m_mutex);
+        unmap ();
+        if (!m_map.open (file)) return false;
+
+        reader r (m_map.begin (), m_map.end ());
+        const char* m = r.skip (std::strlen (magic ()));
+        if (!m || std::memcmp (m, magic (), std::strlen (magic ())) != 0 ||
+            r.read_string () != AbsDomain::getDomainName ()) {
+          CRAB_WARN ("summary cache ", file, " ignored: incompatible format or domain");
+          unmap ();
+          return false;
+        }
+        uint32_t num_records = r.read<uint32_t> ();
+        for (uint32_t i=0; r.ok () && i < num_records; i++) {
+          uint64_t key = r.read<uint64_t> ();
+          uint32_t size = r.read<uint32_t> ();
+          const char* payload = r.skip (size);
+          if (r.ok ())
+            m_mapped.insert (std::make_pair (key, mapped_record_t (payload, size)));
+        }
+        if (!r.ok ()) {
+          CRAB_WARN ("summary cache ", file, " is truncated");
+        }
+        return true;
+      }
+
+      //! Write all the summaries (loaded and added) to file.
+      bool save (const std::string &file) const {
+        using namespace summary_cache_impl;
+        std::lock_guard<std::mutex> lock (m_mutex);
+        std::vector<std::pair<uint64_t, std::string> > records;
+        for (auto const &kv: m_added)
+          records.push_back (kv);
+        for (auto const &kv: m_mapped) {
+          if (m_added.find (kv.first) == m_added.end ())
+            records.push_back (std::make_pair (kv.first,
+                                               std::string (kv.second.first, kv.second.second)));
+        }
+        std::sort (records.begin (), records.end ());
+
+        std::string buf (magic ());
+        writer w (buf);
+        w.write (AbsDomain::getDomainName ());
+        w.write<uint32_t> (records.size ());
+        for (auto const &kv: records) {
+          w.write<uint64_t> (kv.first);
+          w.write (kv.second);
+        }
+        return binary_io::write_file (file, buf);
+      }
+
+      //! Key of a function given the textual representation of its
+      //! strongly connected component and the keys of the callees
+      //! outside the component.
+      static uint64_t make_key (const std::string &fun_name,
+                                std::vector<std::string> scc_cfgs,
+                                std::vector<uint64_t> callee_keys,
+                                const std::string &params) {
+        using namespace summary_cache_impl;
+        std::sort (scc_cfgs.begin (), scc_cfgs.end ());
+        std::sort (callee_keys.begin (), callee_keys.end ());
+        uint64_t h = hash_string (hash_seed, AbsDomain::getDomainName ());
+        h = hash_string (h, params);
+        for (auto const &s: scc_cfgs) h = hash_string (h, s);
+        for (auto k: callee_keys) h = hash_combine (h, k);
+        return hash_string (h, fun_name);
+      }
+
+      //! Return true and the summary in sum if key is in the cache
+      bool lookup (uint64_t key, const std::vector<varname_t> &formals, AbsDomain &sum) {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        bool found = false;
+        auto it = m_added.find (key);
+        if (it != m_added.end ()) {
+          found = decode (it->second.data (), it->second.data () + it->second.size (),
+                          formals, sum);
+        } else {
+          auto mit = m_mapped.find (key);
+          if (mit != m_mapped.end ())
+            found = decode (mit->second.first, mit->second.first + mit->second.second,
+                            formals, sum);
+        }
+        if (found) {
+          m_hits++;
+          CRAB_STATS_COUNT ("Inter.SummaryCache.hit");
+        } else {
+          CRAB_STATS_COUNT ("Inter.SummaryCache.miss");
+        }
+        return found;
+      }
+
+      //! Add the summary of a function expressed in terms of formals
+      void insert (uint64_t key, const std::vector<varname_t> &formals, const AbsDomain &sum) {
+        std::string buf;
+        if (!encode (sum, formals, buf)) return;
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_added [key] = buf;
+      }
+
+      //! Number of successful lookups
+      unsigned num_hits () const {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        return m_hits;
+      }
+
+      std::size_t size () const {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        std::size_t n = m_added.size ();
+        for (auto const &kv: m_mapped)
+          if (m_added.find (kv.first) == m_added.end ()) n++;
+        return n;
+      }
+    };
+
+  } // end namespace
+} // end namespace
+
+#endif
@@ -21,6 +21,10 @@
  *   class cfg_ref that wraps cfg references into copyable and
  *   assignable objects.
  * 
+ * - statements and basic blocks are allocated in an arena owned by
+ *   the cfg. They are only freed when the cfg is destroyed, even if a
+ *   block is removed.
+ * 
  * - During the construction of a cfg there is no type checking so the
  *   client must ensure that types are compatible.
  * 
@@ -38,6 +42,7 @@
 
 #include <crab/common/types.hpp>
 #include <crab/common/bignums.hpp>
+#include <crab/common/arena.hpp>
 #include <crab/iterators/thresholds.hpp>
 #include <crab/domains/linear_constraints.hpp>
 #include <crab/domains/intervals.hpp>
@@ -359,7 +364,8 @@ namespace crab {
       
       virtual void write(crab_os& o) const = 0 ;
       
-      virtual boost::shared_ptr<statement <Number,VariableName> > clone () const = 0;
+      //! copy the statement into the arena
+      virtual statement <Number,VariableName>* clone (arena &a) const = 0;
       
       virtual ~statement() { }
       
@@ -421,11 +427,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef binary_op<Number, VariableName> binary_op_t;
-        return boost::static_pointer_cast<statement_t, binary_op_t>
-            (boost::make_shared<binary_op_t>(m_lhs, m_op, m_op1, m_op2));
+        return a.make<binary_op_t> (*this);
       }
       
       virtual void write (crab_os& o) const
@@ -469,11 +474,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef assignment <Number, VariableName> assignment_t;
-        return boost::static_pointer_cast< statement_t, assignment_t >
-            (boost::make_shared<assignment_t>(m_lhs, m_rhs));
+        return a.make<assignment_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -514,11 +518,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef assume_stmt <Number, VariableName> assume_t;
-        return boost::static_pointer_cast< statement_t, assume_t >
-            (boost::make_shared<assume_t>(m_cst));
+        return a.make<assume_t> (*this);
       }
       
       virtual void write (crab_os & o) const
@@ -542,11 +545,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef unreachable_stmt <Number, VariableName> unreachable_t;
-        return boost::static_pointer_cast< statement_t, unreachable_t >
-            (boost::make_shared<unreachable_t>());
+        return a.make<unreachable_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -579,11 +581,10 @@ namespace crab {
         v->visit (*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef havoc_stmt <Number, VariableName> havoc_t;
-        return boost::static_pointer_cast< statement_t, havoc_t >
-            (boost::make_shared<havoc_t>(m_lhs));
+        return a.make<havoc_t> (*this);
       }
       
       void write (crab_os& o) const
@@ -649,11 +650,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef select_stmt <Number, VariableName> select_t;
-        return boost::static_pointer_cast< statement_t, select_t >
-            (boost::make_shared<select_t>(m_lhs, m_cond, m_e1, m_e2));
+        return a.make<select_t> (*this);
       }
       
       virtual void write (crab_os& o) const
@@ -695,11 +695,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef assert_stmt <Number, VariableName> assert_t;
-        return boost::static_pointer_cast< statement_t, assert_t >
-            (boost::make_shared<assert_t>(m_cst));
+        return a.make<assert_t> (*this);
       }
       
       virtual void write (crab_os & o) const
@@ -762,11 +761,10 @@ namespace crab {
         v->visit (*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef array_assume_stmt <Number, VariableName> array_assume_t;
-        return boost::static_pointer_cast< statement_t, array_assume_t >
-            (boost::make_shared<array_assume_t>(m_arr, m_arr_ty, m_lb, m_ub, m_var));
+        return a.make<array_assume_t> (*this);
       }
       
       void write (crab_os& o) const
@@ -832,12 +830,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef array_store_stmt <Number, VariableName> array_store_t;
-        return boost::static_pointer_cast< statement_t, array_store_t>
-            (boost::make_shared<array_store_t>(m_arr, m_arr_ty, m_index, m_value, 
-                                               m_elem_size, m_is_singleton));
+        return a.make<array_store_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -899,12 +895,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef array_load_stmt <Number, VariableName> array_load_t;
-        return boost::static_pointer_cast< statement_t, array_load_t>
-            (boost::make_shared<array_load_t>(m_lhs, m_array, m_arr_ty, m_index, m_elem_size));
-                                              
+        return a.make<array_load_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -950,11 +944,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef array_assign_stmt <Number, VariableName> arr_assign_t;
-        return boost::static_pointer_cast< statement_t, arr_assign_t >
-            (boost::make_shared<arr_assign_t>(m_lhs, m_rhs, m_ty));
+        return a.make<arr_assign_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -999,11 +992,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t > clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_load_stmt <Number, VariableName> ptr_load_t;
-        return boost::static_pointer_cast< statement_t, ptr_load_t >
-            (boost::make_shared<ptr_load_t>(m_lhs, m_rhs));
+        return a.make<ptr_load_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1044,11 +1036,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_store_stmt <Number, VariableName> ptr_store_t;
-        return boost::static_pointer_cast< statement_t, ptr_store_t >
-            (boost::make_shared<ptr_store_t>(m_lhs, m_rhs));
+        return a.make<ptr_store_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1095,11 +1086,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_assign_stmt <Number, VariableName> ptr_assign_t;
-        return boost::static_pointer_cast< statement_t, ptr_assign_t >
-            (boost::make_shared<ptr_assign_t>(m_lhs, m_rhs, m_offset));
+        return a.make<ptr_assign_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1138,11 +1128,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_object_stmt <Number, VariableName> ptr_object_t;
-        return boost::static_pointer_cast< statement_t, ptr_object_t>
-            (boost::make_shared<ptr_object_t>(m_lhs, m_address));
+        return a.make<ptr_object_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1179,11 +1168,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_function_stmt <Number, VariableName> ptr_function_t;
-        return boost::static_pointer_cast< statement_t, ptr_function_t>
-            (boost::make_shared<ptr_function_t>(lhs (), rhs ()));
+        return a.make<ptr_function_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1216,11 +1204,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_null_stmt <Number, VariableName> ptr_null_t;
-        return boost::static_pointer_cast<statement_t, ptr_null_t>
-            (boost::make_shared<ptr_null_t>(m_lhs));
+        return a.make<ptr_null_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1265,11 +1252,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_assume_stmt <Number, VariableName> ptr_assume_t;
-        return boost::static_pointer_cast<statement_t, ptr_assume_t>
-            (boost::make_shared<ptr_assume_t>(m_cst));
+        return a.make<ptr_assume_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1314,11 +1300,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef ptr_assert_stmt <Number, VariableName> ptr_assert_t;
-        return boost::static_pointer_cast< statement_t, ptr_assert_t>
-            (boost::make_shared<ptr_assert_t>(m_cst));
+        return a.make<ptr_assert_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1402,11 +1387,10 @@ namespace crab {
         v->visit(*this);
       }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef callsite_stmt <Number, VariableName> call_site_t;
-        return boost::static_pointer_cast< statement_t, call_site_t>
-            (boost::make_shared<call_site_t> (m_lhs, m_func_name, m_args));
+        return a.make<call_site_t> (*this);
       }
 
       virtual void write(crab_os& o) const
@@ -1477,11 +1461,10 @@ namespace crab {
         v->visit(*this);
       }
 
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef return_stmt <Number, VariableName> return_t;
-        return boost::static_pointer_cast<statement_t, return_t>
-            (boost::make_shared<return_t>(m_ret));
+        return a.make<return_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1538,11 +1521,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number, VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_assign_cst <Number, VariableName> bool_assign_cst_t;
-        return boost::static_pointer_cast< statement_t, bool_assign_cst_t >
-	  (boost::make_shared<bool_assign_cst_t>(m_lhs, m_rhs));
+        return a.make<bool_assign_cst_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1588,11 +1570,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number, VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_assign_var <Number, VariableName> bool_assign_var_t;
-        return boost::static_pointer_cast< statement_t, bool_assign_var_t >
-	  (boost::make_shared<bool_assign_var_t>(m_lhs, m_rhs));
+        return a.make<bool_assign_var_t> (*this);
       }
       
       virtual void write(crab_os& o) const
@@ -1641,11 +1622,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number,VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_binary_op<Number, VariableName> bool_binary_op_t;
-        return boost::static_pointer_cast<statement_t, bool_binary_op_t>
-            (boost::make_shared<bool_binary_op_t>(m_lhs, m_op, m_op1, m_op2));
+        return a.make<bool_binary_op_t> (*this);
       }
       
       virtual void write (crab_os& o) const
@@ -1678,11 +1658,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number, VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_assume_stmt <Number, VariableName> bool_assume_t;
-        return boost::static_pointer_cast< statement_t, bool_assume_t >
-	  (boost::make_shared<bool_assume_t>(m_var, m_is_negated));
+        return a.make<bool_assume_t> (*this);
       }
       
       virtual void write (crab_os & o) const
@@ -1735,11 +1714,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number, VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_select_stmt <Number, VariableName> bool_select_t;
-        return boost::static_pointer_cast< statement_t, bool_select_t >
-            (boost::make_shared<bool_select_t>(m_lhs, m_cond, m_b1, m_b2));
+        return a.make<bool_select_t> (*this);
       }
       
       virtual void write (crab_os& o) const
@@ -1772,11 +1750,10 @@ namespace crab {
       virtual void accept(statement_visitor <Number, VariableName> *v) 
       { v->visit(*this); }
       
-      virtual boost::shared_ptr<statement_t> clone () const
+      virtual statement_t* clone (arena &a) const
       {
         typedef bool_assert_stmt <Number, VariableName> bool_assert_t;
-        return boost::static_pointer_cast< statement_t, bool_assert_t >
-            (boost::make_shared<bool_assert_t>(m_var));
+        return a.make<bool_assert_t> (*this);
       }
       
       virtual void write (crab_os & o) const
@@ -1785,6 +1762,9 @@ namespace crab {
     
     template< class BasicBlockLabel, class VariableName, class Number>
     class Cfg;
+
+    // builds basic blocks in bulk from a serialized CFG
+    template<class Any> class cfg_reader;
   
     template< class BasicBlockLabel, class VariableName, class Number>
     class basic_block: public boost::noncopyable
@@ -1792,6 +1772,7 @@ namespace crab {
       
       // TODO: support for removing statements 
       friend class Cfg< BasicBlockLabel, VariableName, Number>;
+      template<class Any> friend class cfg_reader;
       
      public:
       
@@ -1809,7 +1790,8 @@ namespace crab {
      private:
       
       typedef std::vector< BasicBlockLabel > bb_id_set_t;
-      typedef boost::shared_ptr< statement_t > statement_ptr;
+      // statements are owned by the arena of the cfg
+      typedef statement_t* statement_ptr;
       typedef std::vector< statement_ptr > stmt_list_t;
       
      public:
@@ -1861,38 +1843,6 @@ namespace crab {
 
      private:
 
-      typedef boost::shared_ptr<havoc_t> havoc_ptr;
-      typedef boost::shared_ptr<unreach_t> unreach_ptr;
-      
-      typedef boost::shared_ptr<bin_op_t> bin_op_ptr;
-      typedef boost::shared_ptr<assign_t> assign_ptr;
-      typedef boost::shared_ptr<assume_t> assume_ptr;
-      typedef boost::shared_ptr<select_t> select_ptr;
-      typedef boost::shared_ptr<assert_t> assert_ptr;
-      
-      typedef boost::shared_ptr<callsite_t> callsite_ptr;      
-      typedef boost::shared_ptr<return_t> return_ptr;      
-      typedef boost::shared_ptr<arr_assume_t> arr_assume_ptr;
-      typedef boost::shared_ptr<arr_store_t> arr_store_ptr;
-      typedef boost::shared_ptr<arr_load_t> arr_load_ptr;    
-      typedef boost::shared_ptr<arr_assign_t> arr_assign_ptr;    
-      typedef boost::shared_ptr<ptr_store_t> ptr_store_ptr;
-      typedef boost::shared_ptr<ptr_load_t> ptr_load_ptr;    
-      typedef boost::shared_ptr<ptr_assign_t> ptr_assign_ptr;
-      typedef boost::shared_ptr<ptr_object_t> ptr_object_ptr;    
-      typedef boost::shared_ptr<ptr_function_t> ptr_function_ptr;    
-      typedef boost::shared_ptr<ptr_null_t> ptr_null_ptr;    
-      typedef boost::shared_ptr<ptr_assume_t> ptr_assume_ptr;    
-      typedef boost::shared_ptr<ptr_assert_t> ptr_assert_ptr;    
-
-      typedef boost::shared_ptr<bool_bin_op_t> bool_bin_op_ptr;
-      typedef boost::shared_ptr<bool_assign_cst_t> bool_assign_cst_ptr;
-      typedef boost::shared_ptr<bool_assign_var_t> bool_assign_var_ptr;      
-      typedef boost::shared_ptr<bool_assume_t> bool_assume_ptr;
-      typedef boost::shared_ptr<bool_select_t> bool_select_ptr;
-      typedef boost::shared_ptr<bool_assert_t> bool_assert_ptr;
-      
-      
       BasicBlockLabel m_bb_id;
       stmt_list_t m_stmts;
       bb_id_set_t m_prev, m_next;
@@ -1906,6 +1856,8 @@ namespace crab {
 
       // set of used/def variables 
       live_domain_t m_live; 
+      // where the statements are allocated
+      arena* m_arena;
       
       void insert_adjacent (bb_id_set_t &c, BasicBlockLabel e)
       { 
@@ -1919,16 +1871,33 @@ namespace crab {
           c.erase (std::remove(c.begin (), c.end (), e), c.end ());
       }
       
-      basic_block (BasicBlockLabel bb_id, tracked_precision track_prec): 
+      basic_block (BasicBlockLabel bb_id, tracked_precision track_prec, arena &a): 
           m_bb_id (bb_id), m_track_prec (track_prec), 
           m_insert_point_at_front (false), 
-          m_live (live_domain_t::bottom ())
+          m_live (live_domain_t::bottom ()),
+          m_arena (&a)
       { }
       
-      static boost::shared_ptr< basic_block_t > 
-      create (BasicBlockLabel bb_id, tracked_precision track_prec) 
+      static basic_block_t* 
+      create (BasicBlockLabel bb_id, tracked_precision track_prec, arena &a) 
       {
-        return boost::shared_ptr<basic_block_t>(new basic_block_t(bb_id, track_prec));
+        basic_block_t* b = new (a.allocate (sizeof (basic_block_t), alignof (basic_block_t)))
+            basic_block_t (bb_id, track_prec, a);
+        a.own (b);
+        return b;
+      }
+
+      // copy the block into a, including its statements
+      basic_block_t* clone (arena &a) const
+      {
+        basic_block_t* b = create (label (), m_track_prec, a);
+        b->m_stmts.reserve (m_stmts.size ());
+        for (auto s : m_stmts)
+          b->m_stmts.push_back (s->clone (a)); 
+        b->m_prev = m_prev;
+        b->m_next = m_next;
+        b->m_live = m_live;
+        return b;
       }
       
       void insert(statement_ptr stmt) 
@@ -1941,7 +1910,7 @@ namespace crab {
         else
           m_stmts.push_back(stmt);
 
-        auto ls = stmt->get_live ();
+        const auto &ls = stmt->get_live ();
         for (auto &v : boost::make_iterator_range (ls.uses_begin (), ls.uses_end ()))
           m_live += v;
         for (auto &v : boost::make_iterator_range (ls.defs_begin (), ls.defs_end ()))
@@ -1955,23 +1924,6 @@ namespace crab {
         m_insert_point_at_front = true;
       }
       
-      boost::shared_ptr<basic_block_t> clone () const
-      {
-        boost::shared_ptr<basic_block_t> b (new basic_block_t(label (), m_track_prec));
-        
-        for (auto &s : boost::make_iterator_range (begin (), end ()))
-          b->m_stmts.push_back (s.clone ()); 
-        
-        for (auto id : boost::make_iterator_range (prev_blocks ())) 
-          b->m_prev.push_back (id);
-        
-        for (auto id : boost::make_iterator_range (next_blocks ()))
-          b->m_next.push_back (id);
-
-        b->m_live = m_live;
-        return b;
-      }
-
       BasicBlockLabel label () const { return m_bb_id; }
 
       std::string name () const {
@@ -2095,14 +2047,12 @@ namespace crab {
       
       void add (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert(boost::static_pointer_cast< statement_t, bin_op_t >
-               (boost::make_shared<bin_op_t>(lhs, BINOP_ADD, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_ADD, op1, op2));
       }
       
       void add (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert(boost::static_pointer_cast< statement_t, bin_op_t > 
-               (boost::make_shared<bin_op_t>(lhs, BINOP_ADD, op1,  op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_ADD, op1,  op2));
       }
       
       void add (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2119,8 +2069,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs(Number(op1.constant () + op2.constant ()));
-          insert(boost::static_pointer_cast< statement_t, assign_t >
-                 (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("add operands unexpected");
@@ -2128,14 +2077,12 @@ namespace crab {
 
       void sub (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SUB, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SUB, op1, op2));
       }
       
       void sub (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SUB, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SUB, op1, op2));
       }
       
       void sub (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2149,8 +2096,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant () - op2.constant ()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("sub operands unexpected");
@@ -2158,14 +2104,12 @@ namespace crab {
 
       void mul (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert(boost::static_pointer_cast< statement_t, bin_op_t >
-               (boost::make_shared<bin_op_t>(lhs, BINOP_MUL, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_MUL, op1, op2));
       }
       
       void mul (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_MUL, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_MUL, op1, op2));
       }
       
       void mul(variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2182,8 +2126,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs(Number(op1.constant () * op2.constant ()));
-          insert(boost::static_pointer_cast< statement_t, assign_t >
-                 (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("mul operands unexpected");
@@ -2192,14 +2135,12 @@ namespace crab {
       // signed division
       void div (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SDIV, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SDIV, op1, op2));
       }
       
       void div (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SDIV, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SDIV, op1, op2));
       }
       
       void div (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2213,8 +2154,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant() / op2.constant()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("div operands unexpected");
@@ -2223,14 +2163,12 @@ namespace crab {
       // unsigned division
       void udiv (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_UDIV, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_UDIV, op1, op2));
       }
       
       void udiv (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_UDIV, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_UDIV, op1, op2));
       }
       
       void udiv (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2248,14 +2186,12 @@ namespace crab {
       // signed rem
       void rem (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SREM, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SREM, op1, op2));
       }
       
       void rem (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_SREM, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_SREM, op1, op2));
       }
       
       void rem (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2269,8 +2205,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant() % op2.constant()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t> (lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("rem operands unexpected");
@@ -2279,14 +2214,12 @@ namespace crab {
       // unsigned rem
       void urem (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_UREM, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_UREM, op1, op2));
       }
       
       void urem (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_UREM, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_UREM, op1, op2));
       }
       
       void urem (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2304,14 +2237,12 @@ namespace crab {
       
       void bitwise_and (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_AND, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_AND, op1, op2));
       }
       
       void bitwise_and (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t> (lhs, BINOP_AND, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_AND, op1, op2));
       }
       
       void bitwise_and (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2328,8 +2259,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant () & op2.constant ()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("and operands unexpected");
@@ -2337,14 +2267,12 @@ namespace crab {
 
       void bitwise_or (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t> (lhs, BINOP_OR, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_OR, op1, op2));
       }
       
       void bitwise_or (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_OR, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_OR, op1, op2));
       }
       
       void bitwise_or (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2361,8 +2289,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant () | op2.constant ()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t>(lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("or operands unexpected");
@@ -2370,14 +2297,12 @@ namespace crab {
 
       void bitwise_xor (variable_t lhs, variable_t op1, variable_t op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_XOR, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_XOR, op1, op2));
       }
       
       void bitwise_xor (variable_t lhs, variable_t op1, Number op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bin_op_t >
-                (boost::make_shared<bin_op_t>(lhs, BINOP_XOR, op1, op2)));
+        insert (m_arena->make<bin_op_t> (lhs, BINOP_XOR, op1, op2));
       }
       
       void bitwise_xor (variable_t lhs, lin_exp_t op1, lin_exp_t op2) 
@@ -2394,8 +2319,7 @@ namespace crab {
         else if (op1.is_constant () && op2.is_constant ()) 
         {
           lin_exp_t rhs (Number (op1.constant () ^ op2.constant ()));
-          insert (boost::static_pointer_cast< statement_t, assign_t >
-                  (boost::make_shared<assign_t> (lhs, rhs)));
+          insert (m_arena->make<assign_t> (lhs, rhs));
         }
         else
           CRAB_ERROR("xor operands unexpected");
@@ -2403,52 +2327,44 @@ namespace crab {
       
       void assign (variable_t lhs, lin_exp_t rhs) 
       {
-        insert (boost::static_pointer_cast< statement_t, assign_t >
-                (boost::make_shared<assign_t> (lhs, rhs)));
+        insert (m_arena->make<assign_t> (lhs, rhs));
       }
 
       void assume (lin_cst_t cst) 
       {
-        insert (boost::static_pointer_cast< statement_t, assume_t >
-                (boost::make_shared<assume_t> (cst)));
+        insert (m_arena->make<assume_t> (cst));
       }
       
       void havoc(VariableName lhs) 
       {
-        insert (boost::static_pointer_cast< statement_t, havoc_t > 
-                (boost::make_shared<havoc_t> (lhs)));
+        insert (m_arena->make<havoc_t> (lhs));
       }
       
       void unreachable() 
       {
-        insert (boost::static_pointer_cast< statement_t, unreach_t > 
-                (boost::make_shared<unreach_t> ()));
+        insert (m_arena->make<unreach_t> ());
       }
       
       void select (variable_t lhs, variable_t v, lin_exp_t e1, lin_exp_t e2) 
       {
         lin_cst_t cond = (v >= Number(1));
-        insert(boost::static_pointer_cast< statement_t, select_t >
-               (boost::make_shared<select_t>(lhs, cond, e1, e2)));
+        insert (m_arena->make<select_t> (lhs, cond, e1, e2));
       }
       
       void select (variable_t lhs, lin_cst_t cond, lin_exp_t e1, lin_exp_t e2) 
       {
-        insert(boost::static_pointer_cast< statement_t, select_t >
-               (boost::make_shared<select_t>(lhs, cond, e1, e2)));
+        insert (m_arena->make<select_t> (lhs, cond, e1, e2));
       }
 
       void assertion (lin_cst_t cst, debug_info di = debug_info ()) 
       {
-	insert (boost::static_pointer_cast< statement_t, assert_t >
-		(boost::make_shared<assert_t> (cst, di)));
+	insert (m_arena->make<assert_t> (cst, di));
       }
 
       void callsite (VariableName func, 
                      const std::vector<std::pair <VariableName,variable_type> > &args) 
       {
-        insert(boost::static_pointer_cast< statement_t, callsite_t >
-               (boost::make_shared<callsite_t>(func, args)));
+        insert (m_arena->make<callsite_t> (func, args));
       }
       
       
@@ -2457,178 +2373,152 @@ namespace crab {
                      const std::vector<std::pair<VariableName,variable_type> > &args) 
       {
         std::vector<std::pair <VariableName,variable_type> > v_lhs = { lhs };
-        insert(boost::static_pointer_cast< statement_t, callsite_t >
-               (boost::make_shared<callsite_t>(v_lhs, func, args)));
+        insert (m_arena->make<callsite_t> (v_lhs, func, args));
       }
 
       void callsite (const std::vector<std::pair<VariableName,variable_type> > &lhs, 
                      VariableName func, 
                      const std::vector<std::pair<VariableName,variable_type> > &args) 
       {
-        insert(boost::static_pointer_cast< statement_t, callsite_t >
-               (boost::make_shared<callsite_t>(lhs, func, args)));
+        insert (m_arena->make<callsite_t> (lhs, func, args));
       }
       
       
       void ret (VariableName var, variable_type ty) 
       {
         std::vector<std::pair <VariableName,variable_type> > ret_vals = { std::make_pair(var,ty) };        
-        insert(boost::static_pointer_cast< statement_t, return_t >
-               (boost::make_shared<return_t>(ret_vals)));
+        insert (m_arena->make<return_t> (ret_vals));
       }
 
       void ret (const std::vector<std::pair<VariableName,variable_type> > &ret_vals) 
       {
-        insert(boost::static_pointer_cast< statement_t, return_t >
-               (boost::make_shared<return_t>(ret_vals)));
+        insert (m_arena->make<return_t> (ret_vals));
       }
             
 
       void array_assume (VariableName a, variable_type arr_ty, 
                          lin_exp_t lb_idx, lin_exp_t ub_idx, VariableName v) {
         if (m_track_prec == ARR)
-          insert (boost::static_pointer_cast< statement_t, arr_assume_t> 
-                  (boost::make_shared<arr_assume_t> (a, arr_ty, lb_idx, ub_idx, v)));
+          insert (m_arena->make<arr_assume_t> (a, arr_ty, lb_idx, ub_idx, v));
       }
       
       void array_store (VariableName arr, variable_type arr_ty, 
                         lin_exp_t idx, VariableName val, 
                         ikos::z_number elem_size, bool is_singleton = false)  {
         if (m_track_prec == ARR)
-          insert(boost::static_pointer_cast< statement_t, arr_store_t >
-                 (boost::make_shared<arr_store_t>(arr, arr_ty, idx, val, elem_size, is_singleton)));
+          insert (m_arena->make<arr_store_t> (arr, arr_ty, idx, val, elem_size, is_singleton));
       }
       
       void array_load (VariableName lhs, VariableName arr, variable_type arr_ty, 
                        lin_exp_t idx, ikos::z_number elem_size) {
         if (m_track_prec == ARR)
-          insert(boost::static_pointer_cast< statement_t, arr_load_t >
-                 (boost::make_shared<arr_load_t>(lhs, arr, arr_ty, idx, elem_size)));
+          insert (m_arena->make<arr_load_t> (lhs, arr, arr_ty, idx, elem_size));
       }
 
       void array_assign (VariableName lhs, VariableName rhs, variable_type ty) {
         if (m_track_prec == ARR)
-          insert(boost::static_pointer_cast< statement_t, arr_assign_t >
-                 (boost::make_shared<arr_assign_t>(lhs, rhs, ty)));
+          insert (m_arena->make<arr_assign_t> (lhs, rhs, ty));
       }
             
       void ptr_store (VariableName lhs, VariableName rhs) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_store_t >
-                 (boost::make_shared<ptr_store_t> (lhs, rhs)));
+          insert (m_arena->make<ptr_store_t> (lhs, rhs));
       }
       
       void ptr_load (VariableName lhs, VariableName rhs) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_load_t >
-                 (boost::make_shared<ptr_load_t> (lhs, rhs)));
+          insert (m_arena->make<ptr_load_t> (lhs, rhs));
       }
       
       void ptr_assign (VariableName lhs, VariableName rhs, lin_exp_t offset) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_assign_t >
-                 (boost::make_shared<ptr_assign_t> (lhs, rhs, offset)));
+          insert (m_arena->make<ptr_assign_t> (lhs, rhs, offset));
       }
       
       void ptr_new_object (VariableName lhs, ikos::index_t address) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_object_t >
-                 (boost::make_shared<ptr_object_t> (lhs, address)));
+          insert (m_arena->make<ptr_object_t> (lhs, address));
       }
       
       void ptr_new_func (VariableName lhs, ikos::index_t func) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_function_t >
-                 (boost::make_shared<ptr_function_t> (lhs, func)));
+          insert (m_arena->make<ptr_function_t> (lhs, func));
       }
 
       void ptr_null (VariableName lhs) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_null_t >
-                 (boost::make_shared<ptr_null_t> (lhs)));
+          insert (m_arena->make<ptr_null_t> (lhs));
       }
 
       void ptr_assume (pointer_constraint<VariableName> cst) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_assume_t >
-                 (boost::make_shared<ptr_assume_t> (cst)));
+          insert (m_arena->make<ptr_assume_t> (cst));
       }
 
       void ptr_assertion (pointer_constraint<VariableName> cst) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_assert_t >
-                 (boost::make_shared<ptr_assert_t> (cst)));
+          insert (m_arena->make<ptr_assert_t> (cst));
       }
 
       void ptr_assertion (pointer_constraint<VariableName> cst, debug_info di) 
       {
         if (m_track_prec >= PTR)
-          insert(boost::static_pointer_cast< statement_t, ptr_assert_t >
-                 (boost::make_shared<ptr_assert_t> (cst, di)));
+          insert (m_arena->make<ptr_assert_t> (cst, di));
       }
 
 
       void bool_assign (VariableName lhs, ikos::linear_constraint<Number, VariableName> rhs) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_assign_cst_t >
-                (boost::make_shared<bool_assign_cst_t> (lhs, rhs)));
+        insert (m_arena->make<bool_assign_cst_t> (lhs, rhs));
       }
 
 
       void bool_assign (VariableName lhs, VariableName rhs) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_assign_var_t >
-                (boost::make_shared<bool_assign_var_t> (lhs, rhs)));
+        insert (m_arena->make<bool_assign_var_t> (lhs, rhs));
       }
       
       void bool_assume (VariableName c) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_assume_t >
-                (boost::make_shared<bool_assume_t> (c, false)));
+        insert (m_arena->make<bool_assume_t> (c, false));
       }
 
       void bool_not_assume (VariableName c) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_assume_t >
-                (boost::make_shared<bool_assume_t> (c, true)));
+        insert (m_arena->make<bool_assume_t> (c, true));
       }
       
       void bool_assert (VariableName c) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_assert_t >
-                (boost::make_shared<bool_assert_t> (c)));
+        insert (m_arena->make<bool_assert_t> (c));
       }
 
       void bool_select (VariableName lhs, VariableName cond, VariableName b1, VariableName b2) 
       {
-        insert(boost::static_pointer_cast< statement_t, bool_select_t >
-               (boost::make_shared<bool_select_t>(lhs, cond, b1, b2)));
+        insert (m_arena->make<bool_select_t> (lhs, cond, b1, b2));
       }
       
       void bool_and (VariableName lhs, VariableName op1, VariableName op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_bin_op_t >
-                (boost::make_shared<bool_bin_op_t>(lhs, BINOP_BAND, op1, op2)));
+        insert (m_arena->make<bool_bin_op_t> (lhs, BINOP_BAND, op1, op2));
       }
 
       void bool_or (VariableName lhs, VariableName op1, VariableName op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_bin_op_t >
-                (boost::make_shared<bool_bin_op_t>(lhs, BINOP_BOR, op1, op2)));
+        insert (m_arena->make<bool_bin_op_t> (lhs, BINOP_BOR, op1, op2));
       }
 
       void bool_xor (VariableName lhs, VariableName op1, VariableName op2) 
       {
-        insert (boost::static_pointer_cast< statement_t, bool_bin_op_t >
-                (boost::make_shared<bool_bin_op_t>(lhs, BINOP_BXOR, op1, op2)));
+        insert (m_arena->make<bool_bin_op_t> (lhs, BINOP_BXOR, op1, op2));
       }
       
       
@@ -2885,6 +2775,9 @@ namespace crab {
      
     template< class BasicBlockLabel, class VariableName, class Number>
     class Cfg: public boost::noncopyable {
+
+      template<class Any> friend class cfg_reader;
+
      public:
 
       typedef Number number_t; 
@@ -2909,7 +2802,8 @@ namespace crab {
      private:
       
       typedef Cfg<BasicBlockLabel, VariableName, Number> cfg_t;
-      typedef boost::shared_ptr< basic_block_t > basic_block_ptr;
+      // blocks are owned by the arena of the cfg
+      typedef basic_block_t* basic_block_ptr;
       typedef boost::unordered_map< BasicBlockLabel, basic_block_ptr > basic_block_map_t;
       typedef typename basic_block_map_t::value_type binding_t;
       typedef typename basic_block_t::live_domain_t live_domain_t;
@@ -2945,6 +2839,9 @@ namespace crab {
       BasicBlockLabel m_entry;
       BasicBlockLabel m_exit;
       bool m_has_exit;
+      // statements and blocks are allocated here. Memory is released
+      // only when the cfg is destroyed.
+      arena m_arena;
       basic_block_map_t m_blocks;
       tracked_precision m_track_prec;
       //! we allow to define a cfg without being associated with a
@@ -2990,7 +2887,7 @@ namespace crab {
             m_has_exit (false),
             m_track_prec (track_prec) {
         m_blocks.insert (binding_t (m_entry, 
-                                    basic_block_t::create (m_entry, m_track_prec)));
+                                    basic_block_t::create (m_entry, m_track_prec, m_arena)));
       }
       
       Cfg (BasicBlockLabel entry, BasicBlockLabel exit, 
@@ -3000,7 +2897,7 @@ namespace crab {
             m_has_exit (true),
             m_track_prec (track_prec) {
         m_blocks.insert (binding_t (m_entry, 
-                                    basic_block_t::create (m_entry, m_track_prec)));
+                                    basic_block_t::create (m_entry, m_track_prec, m_arena)));
       }
       
       Cfg (BasicBlockLabel entry, BasicBlockLabel exit, 
@@ -3012,19 +2909,24 @@ namespace crab {
             m_track_prec (track_prec),
             m_func_decl (boost::optional<fdecl_t> (func_decl)) {
         m_blocks.insert (binding_t (m_entry, 
-                                    basic_block_t::create (m_entry, m_track_prec)));
+                                    basic_block_t::create (m_entry, m_track_prec, m_arena)));
       }
       
       boost::shared_ptr<cfg_t> clone () const
       {
-        boost::shared_ptr<cfg_t> _cfg (new cfg_t (m_entry, m_track_prec));
+        boost::shared_ptr<cfg_t> _cfg (new cfg_t ());
+        _cfg->m_entry = m_entry;
         _cfg->m_has_exit = m_has_exit ;
         if (_cfg->m_has_exit)
           _cfg->m_exit = m_exit ;
+        _cfg->m_track_prec = m_track_prec;
         _cfg->m_func_decl = m_func_decl;
+        // the copies of all blocks and statements are contiguous
+        _cfg->m_arena.reserve (m_arena.allocated ());
+        _cfg->m_blocks.reserve (m_blocks.size ());
         for (auto const &BB: boost::make_iterator_range (begin (), end ()))
         {
-          boost::shared_ptr <basic_block_t> copyBB = BB.clone ();
+          basic_block_ptr copyBB = BB.clone (_cfg->m_arena);
           _cfg->m_blocks.insert (binding_t (copyBB->label (), copyBB));
         }
         return _cfg;
@@ -3113,7 +3015,7 @@ namespace crab {
         auto it = m_blocks.find (bb_id);
         if (it != m_blocks.end ()) return *(it->second);
         
-        basic_block_ptr block = basic_block_t::create (bb_id, m_track_prec);
+        basic_block_ptr block = basic_block_t::create (bb_id, m_track_prec, m_arena);
         m_blocks.insert (binding_t (bb_id, block));
         return *block;
       }
@@ -0,0 +1,947 @@
+#ifndef CFG_BINARY_HPP
+#define CFG_BINARY_HPP
+
+/*
+   A compact binary format for CFGs and call graphs.
+
+   A file contains a sequence of CFGs (e.g., all the functions of a
+   call graph). The CFGs are written once and then loaded by mapping
+   the file into memory. The loader builds each basic block in bulk:
+   statements are created with their final debug information,
+   storage is reserved upfront, the set of variables of the block
+   is read at once instead of being updated after each statement,
+   and edges are added without the duplicate checks done by
+   basic_block::operator>>.
+
+   File format (native endianness):
+
+     magic    : "CRABCFG\0"
+     version  : u32
+     number   : u8 ('z' for z_number and 'q' for q_number)
+     #vars    : u32
+     vars     : string*
+     #labels  : u32
+     labels   : string*
+     #files   : u32
+     files    : string*
+     #cfgs    : u32
+     cfgs     : cfg*
+
+   where strings are a u32 length followed by the characters. Each
+   variable, block label and file name is stored once in its table
+   and referred to by its position (u32) in the table.
+
+     cfg      : entry: u32, has_exit: u8, [exit: u32],
+                track_prec: u8, has_decl: u8, [decl],
+                #blocks: u32, block*
+     decl     : name: u32, #lhs types: u32, (type: u8)*,
+                #params: u32, (var: u32, type: u8)*
+     block    : label: u32, #stmts: u32, stmt*, #live: u32, (var: u32)*,
+                #succs: u32, (label: u32)*, #preds: u32, (label: u32)*
+     stmt     : code: u8, has_debug: u8,
+                [file: u32, line: i32, column: i32], operands
+
+   The operands of each statement are listed in cfg_writer. Numbers
+   that fit into a machine integer are stored as an i64 and
+   otherwise as a string.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <crab/common/types.hpp>
+#include <crab/common/debug.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/common/bignums.hpp>
+#include <crab/common/binary_io.hpp>
+#include <crab/cfg/cfg.hpp>
+
+namespace crab {
+
+  namespace cfg {
+
+    namespace cfg_binary_impl {
+
+      const uint32_t version = 1;
+
+      inline const char* magic () { return "CRABCFG"; }
+
+      // includes the terminating null character
+      const uint32_t magic_size = 8;
+
+      template<typename Number>
+      struct number_codec;
+
+      template<>
+      struct number_codec<ikos::z_number> {
+        static const uint8_t tag = 'z';
+
+        static void write (binary_io::writer &w, const ikos::z_number &n) {
+          if (n.fits_slong ()) {
+            w.write<uint8_t> (0);
+            w.write<int64_t> ((long) n);
+          } else {
+            w.write<uint8_t> (1);
+            w.write (n.get_str ());
+          }
+        }
+
+        static ikos::z_number read (binary_io::reader &r) {
+          if (r.read<uint8_t> () == 0) {
+            return ikos::z_number ((signed long long) r.read<int64_t> ());
+          } else {
+            std::string s = r.read_string ();
+            return r.ok () ? ikos::z_number (s) : ikos::z_number (0);
+          }
+        }
+      };
+
+      template<>
+      struct number_codec<ikos::q_number> {
+        static const uint8_t tag = 'q';
+
+        static void write (binary_io::writer &w, const ikos::q_number &n) {
+          number_codec<ikos::z_number>::write (w, n.numerator ());
+          number_codec<ikos::z_number>::write (w, n.denominator ());
+        }
+
+        static ikos::q_number read (binary_io::reader &r) {
+          ikos::z_number num = number_codec<ikos::z_number>::read (r);
+          ikos::z_number den = number_codec<ikos::z_number>::read (r);
+          if (!r.ok () || den == 0) return ikos::q_number (0);
+          return ikos::q_number (num, den);
+        }
+      };
+
+      template<typename T>
+      inline std::string to_string (const T &v) {
+        crab_string_os os;
+        os << v;
+        return os.str ();
+      }
+
+    } // end namespace cfg_binary_impl
+
+    //! Serialize CFGs into a string or a file.
+    template<class CFG>
+    class cfg_writer: public boost::noncopyable {
+
+     public:
+
+      typedef typename CFG::basic_block_label_t basic_block_label_t;
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::number_t number_t;
+      typedef typename CFG::fdecl_t fdecl_t;
+      typedef typename CFG::basic_block_t basic_block_t;
+      typedef typename CFG::statement_t statement_t;
+
+     private:
+
+      typedef ikos::linear_expression<number_t, varname_t> lin_exp_t;
+      typedef ikos::linear_constraint<number_t, varname_t> lin_cst_t;
+      typedef pointer_constraint<varname_t> ptr_cst_t;
+      typedef std::pair<varname_t, variable_type> typed_variable_t;
+      typedef cfg_binary_impl::number_codec<number_t> codec_t;
+
+      std::vector<std::string> m_vars;
+      std::vector<std::string> m_labels;
+      std::vector<std::string> m_files;
+      boost::unordered_map<varname_t, uint32_t> m_var_index;
+      boost::unordered_map<basic_block_label_t, uint32_t> m_label_index;
+      boost::unordered_map<std::string, uint32_t> m_file_index;
+      std::string m_body;
+      binary_io::writer m_w;
+      uint32_t m_num_cfgs;
+
+      template<typename T>
+      static uint32_t table_index (boost::unordered_map<T, uint32_t> &index,
+                                   std::vector<std::string> &table,
+                                   const T &v, std::function<std::string (const T&)> to_str) {
+        auto it = index.find (v);
+        if (it == index.end ()) {
+          it = index.insert (std::make_pair (v, (uint32_t) table.size ())).first;
+          table.push_back (to_str (v));
+        }
+        return it->second;
+      }
+
+      void write_var (const varname_t &v) {
+        m_w.write<uint32_t> (table_index<varname_t> (m_var_index, m_vars, v,
+                                                      cfg_binary_impl::to_string<varname_t>));
+      }
+
+      void write_label (const basic_block_label_t &l) {
+        m_w.write<uint32_t> (table_index<basic_block_label_t>
+                             (m_label_index, m_labels, l,
+                              cfg_impl::get_label_str<basic_block_label_t>));
+      }
+
+      void write_file_name (const std::string &f) {
+        m_w.write<uint32_t> (table_index<std::string>
+                             (m_file_index, m_files, f,
+                              [] (const std::string &s) { return s; }));
+      }
+
+      void write_typed_vars (const std::vector<typed_variable_t> &vs) {
+        m_w.write<uint32_t> (vs.size ());
+        for (auto const &v: vs) {
+          write_var (v.first);
+          m_w.write<uint8_t> (v.second);
+        }
+      }
+
+      void write_number (const number_t &n) { codec_t::write (m_w, n); }
+
+      void write_lin_exp (const lin_exp_t &e) {
+        write_number (e.constant ());
+        m_w.write<uint32_t> (e.size ());
+        for (auto const &t: e) {
+          write_number (t.first);
+          write_var (t.second.name ());
+        }
+      }
+
+      void write_lin_cst (const lin_cst_t &c) {
+        m_w.write<uint8_t> (c.kind ());
+        write_lin_exp (c.expression ());
+      }
+
+      // bit 0: has lhs, bit 1: has rhs, bit 2: disequality
+      void write_ptr_cst (const ptr_cst_t &c) {
+        uint8_t flags = c.is_disequality () ? 4 : 0;
+        if (c.is_unary ()) flags |= 1;
+        if (c.is_binary ()) flags |= 3;
+        m_w.write<uint8_t> (flags);
+        if (flags & 1) write_var (c.lhs ());
+        if (flags & 2) write_var (c.rhs ());
+      }
+
+      void write_header (stmt_code code, const statement_t &s) {
+        m_w.write<uint8_t> (code);
+        const debug_info &dbg = s.get_debug_info ();
+        m_w.write<uint8_t> (dbg.has_debug ());
+        if (dbg.has_debug ()) {
+          write_file_name (dbg.m_file);
+          m_w.write<int32_t> (dbg.m_line);
+          m_w.write<int32_t> (dbg.m_col);
+        }
+      }
+
+      struct stmt_writer: public statement_visitor<number_t, varname_t> {
+        typedef statement_visitor<number_t, varname_t> visitor_t;
+        typedef typename visitor_t::bin_op_t bin_op_t;
+        typedef typename visitor_t::assign_t assign_t;
+        typedef typename visitor_t::assume_t assume_t;
+        typedef typename visitor_t::select_t select_t;
+        typedef typename visitor_t::assert_t assert_t;
+        typedef typename visitor_t::unreach_t unreach_t;
+        typedef typename visitor_t::havoc_t havoc_t;
+        typedef typename visitor_t::callsite_t callsite_t;
+        typedef typename visitor_t::return_t return_t;
+        typedef typename visitor_t::arr_assume_t arr_assume_t;
+        typedef typename visitor_t::arr_store_t arr_store_t;
+        typedef typename visitor_t::arr_load_t arr_load_t;
+        typedef typename visitor_t::arr_assign_t arr_assign_t;
+        typedef typename visitor_t::ptr_store_t ptr_store_t;
+        typedef typename visitor_t::ptr_load_t ptr_load_t;
+        typedef typename visitor_t::ptr_assign_t ptr_assign_t;
+        typedef typename visitor_t::ptr_object_t ptr_object_t;
+        typedef typename visitor_t::ptr_function_t ptr_function_t;
+        typedef typename visitor_t::ptr_null_t ptr_null_t;
+        typedef typename visitor_t::ptr_assume_t ptr_assume_t;
+        typedef typename visitor_t::ptr_assert_t ptr_assert_t;
+        typedef typename visitor_t::bool_bin_op_t bool_bin_op_t;
+        typedef typename visitor_t::bool_assign_cst_t bool_assign_cst_t;
+        typedef typename visitor_t::bool_assign_var_t bool_assign_var_t;
+        typedef typename visitor_t::bool_assume_t bool_assume_t;
+        typedef typename visitor_t::bool_select_t bool_select_t;
+        typedef typename visitor_t::bool_assert_t bool_assert_t;
+        typedef cfg_binary_impl::number_codec<ikos::z_number> z_codec_t;
+
+        cfg_writer &m_out;
+        binary_io::writer &m_w;
+
+        stmt_writer (cfg_writer &out): m_out (out), m_w (out.m_w) { }
+
+        void visit (bin_op_t &s) {
+          m_out.write_header (BIN_OP, s);
+          m_out.write_var (s.lhs ().name ());
+          m_w.write<uint8_t> (s.op ());
+          m_out.write_lin_exp (s.left ());
+          m_out.write_lin_exp (s.right ());
+        }
+
+        void visit (assign_t &s) {
+          m_out.write_header (ASSIGN, s);
+          m_out.write_var (s.lhs ().name ());
+          m_out.write_lin_exp (s.rhs ());
+        }
+
+        void visit (assume_t &s) {
+          m_out.write_header (ASSUME, s);
+          m_out.write_lin_cst (s.constraint ());
+        }
+
+        void visit (select_t &s) {
+          m_out.write_header (SELECT, s);
+          m_out.write_var (s.lhs ().name ());
+          m_out.write_lin_cst (s.cond ());
+          m_out.write_lin_exp (s.left ());
+          m_out.write_lin_exp (s.right ());
+        }
+
+        void visit (assert_t &s) {
+          m_out.write_header (ASSERT, s);
+          m_out.write_lin_cst (s.constraint ());
+        }
+
+        void visit (unreach_t &s) {
+          m_out.write_header (UNREACH, s);
+        }
+
+        void visit (havoc_t &s) {
+          m_out.write_header (HAVOC, s);
+          m_out.write_var (s.variable ());
+        }
+
+        void visit (callsite_t &s) {
+          m_out.write_header (CALLSITE, s);
+          m_out.write_typed_vars (s.get_lhs ());
+          m_out.write_var (s.get_func_name ());
+          m_out.write_typed_vars (s.get_args ());
+        }
+
+        void visit (return_t &s) {
+          m_out.write_header (RETURN, s);
+          m_out.write_typed_vars (s.get_ret_vals ());
+        }
+
+        void visit (arr_assume_t &s) {
+          m_out.write_header (ARR_ASSUME, s);
+          m_out.write_var (s.array ());
+          m_w.write<uint8_t> (s.array_type ());
+          m_out.write_lin_exp (s.lb_index ());
+          m_out.write_lin_exp (s.ub_index ());
+          m_out.write_var (s.var ());
+        }
+
+        void visit (arr_store_t &s) {
+          m_out.write_header (ARR_STORE, s);
+          m_out.write_var (s.array ());
+          m_w.write<uint8_t> (s.array_type ());
+          m_out.write_lin_exp (s.index ());
+          m_out.write_var (s.value ());
+          z_codec_t::write (m_w, s.elem_size ());
+          m_w.write<uint8_t> (s.is_singleton ());
+        }
+
+        void visit (arr_load_t &s) {
+          m_out.write_header (ARR_LOAD, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.array ());
+          m_w.write<uint8_t> (s.array_type ());
+          m_out.write_lin_exp (s.index ());
+          z_codec_t::write (m_w, s.elem_size ());
+        }
+
+        void visit (arr_assign_t &s) {
+          m_out.write_header (ARR_ASSIGN, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+          m_w.write<uint8_t> (s.array_type ());
+        }
+
+        void visit (ptr_store_t &s) {
+          m_out.write_header (PTR_STORE, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+        }
+
+        void visit (ptr_load_t &s) {
+          m_out.write_header (PTR_LOAD, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+        }
+
+        void visit (ptr_assign_t &s) {
+          m_out.write_header (PTR_ASSIGN, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+          m_out.write_lin_exp (s.offset ());
+        }
+
+        void visit (ptr_object_t &s) {
+          m_out.write_header (PTR_OBJECT, s);
+          m_out.write_var (s.lhs ());
+          m_w.write<uint64_t> (s.rhs ());
+        }
+
+        void visit (ptr_function_t &s) {
+          m_out.write_header (PTR_FUNCTION, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+        }
+
+        void visit (ptr_null_t &s) {
+          m_out.write_header (PTR_NULL, s);
+          m_out.write_var (s.lhs ());
+        }
+
+        void visit (ptr_assume_t &s) {
+          m_out.write_header (PTR_ASSUME, s);
+          m_out.write_ptr_cst (s.constraint ());
+        }
+
+        void visit (ptr_assert_t &s) {
+          m_out.write_header (PTR_ASSERT, s);
+          m_out.write_ptr_cst (s.constraint ());
+        }
+
+        void visit (bool_bin_op_t &s) {
+          m_out.write_header (BOOL_BIN_OP, s);
+          m_out.write_var (s.lhs ());
+          m_w.write<uint8_t> (s.op ());
+          m_out.write_var (s.left ());
+          m_out.write_var (s.right ());
+        }
+
+        void visit (bool_assign_cst_t &s) {
+          m_out.write_header (BOOL_ASSIGN_CST, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_lin_cst (s.rhs ());
+        }
+
+        void visit (bool_assign_var_t &s) {
+          m_out.write_header (BOOL_ASSIGN_VAR, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.rhs ());
+        }
+
+        void visit (bool_assume_t &s) {
+          m_out.write_header (BOOL_ASSUME, s);
+          m_out.write_var (s.cond ());
+          m_w.write<uint8_t> (s.is_negated ());
+        }
+
+        void visit (bool_select_t &s) {
+          m_out.write_header (BOOL_SELECT, s);
+          m_out.write_var (s.lhs ());
+          m_out.write_var (s.cond ());
+          m_out.write_var (s.left ());
+          m_out.write_var (s.right ());
+        }
+
+        void visit (bool_assert_t &s) {
+          m_out.write_header (BOOL_ASSERT, s);
+          m_out.write_var (s.cond ());
+        }
+      };
+
+     public:
+
+      cfg_writer (): m_w (m_body), m_num_cfgs (0) { }
+
+      //! Add a CFG to the output
+      void add (CFG &cfg) {
+        m_num_cfgs++;
+        write_label (cfg.entry ());
+        m_w.write<uint8_t> (cfg.has_exit ());
+        if (cfg.has_exit ()) write_label (cfg.exit ());
+        m_w.write<uint8_t> (cfg.get_track_prec ());
+
+        boost::optional<fdecl_t> decl = cfg.get_func_decl ();
+        m_w.write<uint8_t> ((bool) decl);
+        if (decl) {
+          write_var (decl->get_func_name ());
+          m_w.write<uint32_t> (decl->get_lhs_types ().size ());
+          for (auto ty: decl->get_lhs_types ())
+            m_w.write<uint8_t> (ty);
+          write_typed_vars (decl->get_params ());
+        }
+
+        m_w.write<uint32_t> (std::distance (cfg.begin (), cfg.end ()));
+        stmt_writer vis (*this);
+        for (auto &b: boost::make_iterator_range (cfg.begin (), cfg.end ())) {
+          write_label (b.label ());
+          m_w.write<uint32_t> (b.size ());
+          for (auto &s: b)
+            s.accept (&vis);
+          std::vector<varname_t> live;
+          for (auto v: b.live ()) live.push_back (v);
+          m_w.write<uint32_t> (live.size ());
+          for (auto const &v: live) write_var (v);
+          m_w.write<uint32_t> (std::distance (b.next_blocks ().first, b.next_blocks ().second));
+          for (auto l: boost::make_iterator_range (b.next_blocks ()))
+            write_label (l);
+          m_w.write<uint32_t> (std::distance (b.prev_blocks ().first, b.prev_blocks ().second));
+          for (auto l: boost::make_iterator_range (b.prev_blocks ()))
+            write_label (l);
+        }
+      }
+
+      //! Add all the CFGs of a call graph to the output
+      template<typename CG>
+      void add_call_graph (CG &cg) {
+        for (auto &v: boost::make_iterator_range (cg.nodes ()))
+          add (v.get_cfg ().get ());
+      }
+
+      //! Return the binary representation of all the added CFGs
+      std::string str () const {
+        std::string buf (cfg_binary_impl::magic (), cfg_binary_impl::magic_size);
+        binary_io::writer w (buf);
+        w.write<uint32_t> (cfg_binary_impl::version);
+        w.write<uint8_t> (codec_t::tag);
+        for (auto table: { &m_vars, &m_labels, &m_files }) {
+          w.write<uint32_t> (table->size ());
+          for (auto const &s: *table) w.write (s);
+        }
+        w.write<uint32_t> (m_num_cfgs);
+        buf.append (m_body);
+        return buf;
+      }
+
+      bool save (const std::string &file) const {
+        return binary_io::write_file (file, str ());
+      }
+    };
+
+    //! Build CFGs from their binary representation.
+    template<class CFG>
+    class cfg_reader: public boost::noncopyable {
+
+     public:
+
+      typedef typename CFG::basic_block_label_t basic_block_label_t;
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::number_t number_t;
+      typedef typename CFG::fdecl_t fdecl_t;
+      typedef typename CFG::basic_block_t basic_block_t;
+      typedef typename CFG::statement_t statement_t;
+      typedef boost::shared_ptr<CFG> cfg_ptr;
+
+      //! To map the names stored in the file to variables and labels
+      typedef std::function<varname_t (const std::string&)> make_var_t;
+      typedef std::function<basic_block_label_t (const std::string&)> make_label_t;
+
+     private:
+
+      typedef ikos::variable<number_t, varname_t> variable_t;
+      typedef ikos::linear_expression<number_t, varname_t> lin_exp_t;
+      typedef ikos::linear_constraint<number_t, varname_t> lin_cst_t;
+      typedef pointer_constraint<varname_t> ptr_cst_t;
+      typedef std::pair<varname_t, variable_type> typed_variable_t;
+      typedef cfg_binary_impl::number_codec<number_t> codec_t;
+      typedef cfg_binary_impl::number_codec<ikos::z_number> z_codec_t;
+
+      make_var_t m_mk_var;
+      make_label_t m_mk_label;
+      std::vector<varname_t> m_vars;
+      std::vector<basic_block_label_t> m_labels;
+      std::vector<std::string> m_files;
+      binary_io::mapped_file m_map;
+
+      template<typename T>
+      static bool read_table (binary_io::reader &r, std::vector<T> &table,
+                              std::function<T (const std::string&)> mk) {
+        uint32_t n = r.read<uint32_t> ();
+        table.clear ();
+        if (!r.ok ()) return false;
+        table.reserve (n);
+        for (uint32_t i=0; i < n; i++) {
+          std::string s = r.read_string ();
+          if (!r.ok ()) return false;
+          table.push_back (mk (s));
+        }
+        return true;
+      }
+
+      // Set e to the element of table whose index is read from r
+      template<typename T>
+      static bool read_index (binary_io::reader &r, const std::vector<T> &table,
+                              const T* &e) {
+        uint32_t idx = r.read<uint32_t> ();
+        if (!r.ok () || idx >= table.size ()) return false;
+        e = &table [idx];
+        return true;
+      }
+
+      bool read_var (binary_io::reader &r, const varname_t* &v) {
+        return read_index (r, m_vars, v);
+      }
+
+      bool read_label (binary_io::reader &r, const basic_block_label_t* &l) {
+        return read_index (r, m_labels, l);
+      }
+
+      bool read_type (binary_io::reader &r, variable_type &ty) {
+        uint8_t t = r.read<uint8_t> ();
+        if (!r.ok () || t > UNK_TYPE) return false;
+        ty = (variable_type) t;
+        return true;
+      }
+
+      bool read_array_type (binary_io::reader &r, variable_type &ty) {
+        return read_type (r, ty) && (ty == ARR_INT_TYPE || ty == ARR_PTR_TYPE);
+      }
+
+      bool read_typed_vars (binary_io::reader &r, std::vector<typed_variable_t> &vs) {
+        uint32_t n = r.read<uint32_t> ();
+        if (!r.ok ()) return false;
+        vs.reserve (n);
+        for (uint32_t i=0; i < n; i++) {
+          const varname_t* v;
+          variable_type ty;
+          if (!read_var (r, v) || !read_type (r, ty)) return false;
+          vs.push_back (typed_variable_t (*v, ty));
+        }
+        return true;
+      }
+
+      bool read_lin_exp (binary_io::reader &r, lin_exp_t &e) {
+        number_t cst = codec_t::read (r);
+        uint32_t n = r.read<uint32_t> ();
+        if (!r.ok ()) return false;
+        for (uint32_t i=0; i < n; i++) {
+          number_t coef = codec_t::read (r);
+          const varname_t* v;
+          if (!read_var (r, v)) return false;
+          if (i == 0) e = lin_exp_t (coef, variable_t (*v));
+          else        e = e + lin_exp_t (coef, variable_t (*v));
+        }
+        // adding a constant does not copy the terms
+        e = (n == 0) ? lin_exp_t (cst) : e + cst;
+        return true;
+      }
+
+      bool read_lin_cst (binary_io::reader &r, lin_cst_t &c) {
+        uint8_t kind = r.read<uint8_t> ();
+        lin_exp_t e;
+        if (!r.ok () || kind > lin_cst_t::INEQUALITY || !read_lin_exp (r, e))
+          return false;
+        c = lin_cst_t (e, (typename lin_cst_t::kind_t) kind);
+        return true;
+      }
+
+      bool read_ptr_cst (binary_io::reader &r, ptr_cst_t &c) {
+        uint8_t flags = r.read<uint8_t> ();
+        if (!r.ok ()) return false;
+        bool is_eq = !(flags & 4);
+        const varname_t *lhs = nullptr, *rhs = nullptr;
+        if ((flags & 1) && !read_var (r, lhs)) return false;
+        if ((flags & 2) && !read_var (r, rhs)) return false;
+        switch (flags & 3) {
+          case 0: c = is_eq ? ptr_cst_t::mk_true () : ptr_cst_t::mk_false (); break;
+          case 1: c = is_eq ? ptr_cst_t::mk_eq_null (*lhs) : ptr_cst_t::mk_diseq_null (*lhs); break;
+          case 3: c = is_eq ? ptr_cst_t::mk_eq (*lhs, *rhs) : ptr_cst_t::mk_diseq (*lhs, *rhs); break;
+          default: return false;
+        }
+        return true;
+      }
+
+      template<typename Stmt, typename ... Args>
+      static void insert (basic_block_t &b, Args&& ... args) {
+        // the live variables of the block are read separately
+        b.m_stmts.push_back (b.m_arena->template make<Stmt> (std::forward<Args> (args)...));
+      }
+
+      bool read_stmt (binary_io::reader &r, basic_block_t &b) {
+        uint8_t code = r.read<uint8_t> ();
+        debug_info dbg;
+        if (r.read<uint8_t> ()) {
+          const std::string* file;
+          if (!read_index (r, m_files, file)) return false;
+          dbg.m_file = *file;
+          dbg.m_line = r.read<int32_t> ();
+          dbg.m_col = r.read<int32_t> ();
+        }
+        if (!r.ok ()) return false;
+
+        const varname_t *x, *y, *z, *w;
+        lin_exp_t e1, e2;
+        lin_cst_t c;
+        ptr_cst_t pc;
+        variable_type ty;
+        std::vector<typed_variable_t> vs1, vs2;
+
+        switch (code) {
+          case BIN_OP: {
+            uint8_t op;
+            if (!read_var (r, x)) return false;
+            op = r.read<uint8_t> ();
+            if (op > BINOP_ASHR || !read_lin_exp (r, e1) || !read_lin_exp (r, e2)) return false;
+            insert<typename basic_block_t::bin_op_t> (b, variable_t (*x), (binary_operation_t) op,
+                                                      e1, e2, dbg);
+            break;
+          }
+          case ASSIGN:
+            if (!read_var (r, x) || !read_lin_exp (r, e1)) return false;
+            insert<typename basic_block_t::assign_t> (b, variable_t (*x), e1);
+            break;
+          case ASSUME:
+            if (!read_lin_cst (r, c)) return false;
+            insert<typename basic_block_t::assume_t> (b, c);
+            break;
+          case UNREACH:
+            insert<typename basic_block_t::unreach_t> (b);
+            break;
+          case SELECT:
+            if (!read_var (r, x) || !read_lin_cst (r, c) ||
+                !read_lin_exp (r, e1) || !read_lin_exp (r, e2)) return false;
+            insert<typename basic_block_t::select_t> (b, variable_t (*x), c, e1, e2);
+            break;
+          case ASSERT:
+            if (!read_lin_cst (r, c)) return false;
+            insert<typename basic_block_t::assert_t> (b, c, dbg);
+            break;
+          case HAVOC:
+            if (!read_var (r, x)) return false;
+            insert<typename basic_block_t::havoc_t> (b, *x);
+            break;
+          case CALLSITE:
+            if (!read_typed_vars (r, vs1) || !read_var (r, x) || !read_typed_vars (r, vs2))
+              return false;
+            insert<typename basic_block_t::callsite_t> (b, vs1, *x, vs2);
+            break;
+          case RETURN:
+            if (!read_typed_vars (r, vs1)) return false;
+            insert<typename basic_block_t::return_t> (b, vs1);
+            break;
+          case ARR_ASSUME:
+            if (!read_var (r, x) || !read_array_type (r, ty) || !read_lin_exp (r, e1) ||
+                !read_lin_exp (r, e2) || !read_var (r, y)) return false;
+            insert<typename basic_block_t::arr_assume_t> (b, *x, ty, e1, e2, *y);
+            break;
+          case ARR_STORE: {
+            if (!read_var (r, x) || !read_array_type (r, ty) ||
+                !read_lin_exp (r, e1) || !read_var (r, y)) return false;
+            ikos::z_number sz = z_codec_t::read (r);
+            bool is_sing = r.read<uint8_t> ();
+            if (!r.ok ()) return false;
+            insert<typename basic_block_t::arr_store_t> (b, *x, ty, e1, *y, sz, is_sing);
+            break;
+          }
+          case ARR_LOAD: {
+            if (!read_var (r, x) || !read_var (r, y) || !read_array_type (r, ty) ||
+                !read_lin_exp (r, e1)) return false;
+            ikos::z_number sz = z_codec_t::read (r);
+            if (!r.ok ()) return false;
+            insert<typename basic_block_t::arr_load_t> (b, *x, *y, ty, e1, sz);
+            break;
+          }
+          case ARR_ASSIGN:
+            if (!read_var (r, x) || !read_var (r, y) || !read_array_type (r, ty)) return false;
+            insert<typename basic_block_t::arr_assign_t> (b, *x, *y, ty);
+            break;
+          case PTR_STORE:
+            if (!read_var (r, x) || !read_var (r, y)) return false;
+            insert<typename basic_block_t::ptr_store_t> (b, *x, *y, dbg);
+            break;
+          case PTR_LOAD:
+            if (!read_var (r, x) || !read_var (r, y)) return false;
+            insert<typename basic_block_t::ptr_load_t> (b, *x, *y, dbg);
+            break;
+          case PTR_ASSIGN:
+            if (!read_var (r, x) || !read_var (r, y) || !read_lin_exp (r, e1)) return false;
+            insert<typename basic_block_t::ptr_assign_t> (b, *x, *y, e1);
+            break;
+          case PTR_OBJECT: {
+            if (!read_var (r, x)) return false;
+            ikos::index_t addr = r.read<uint64_t> ();
+            if (!r.ok ()) return false;
+            insert<typename basic_block_t::ptr_object_t> (b, *x, addr);
+            break;
+          }
+          case PTR_FUNCTION:
+            if (!read_var (r, x) || !read_var (r, y)) return false;
+            insert<typename basic_block_t::ptr_function_t> (b, *x, *y);
+            break;
+          case PTR_NULL:
+            if (!read_var (r, x)) return false;
+            insert<typename basic_block_t::ptr_null_t> (b, *x);
+            break;
+          case PTR_ASSUME:
+            if (!read_ptr_cst (r, pc)) return false;
+            insert<typename basic_block_t::ptr_assume_t> (b, pc);
+            break;
+          case PTR_ASSERT:
+            if (!read_ptr_cst (r, pc)) return false;
+            insert<typename basic_block_t::ptr_assert_t> (b, pc, dbg);
+            break;
+          case BOOL_BIN_OP: {
+            uint8_t op;
+            if (!read_var (r, x)) return false;
+            op = r.read<uint8_t> ();
+            if (op > BINOP_BXOR || !read_var (r, y) || !read_var (r, z)) return false;
+            insert<typename basic_block_t::bool_bin_op_t> (b, *x, (bool_binary_operation_t) op,
+                                                           *y, *z, dbg);
+            break;
+          }
+          case BOOL_ASSIGN_CST:
+            if (!read_var (r, x) || !read_lin_cst (r, c)) return false;
+            insert<typename basic_block_t::bool_assign_cst_t> (b, *x, c);
+            break;
+          case BOOL_ASSIGN_VAR:
+            if (!read_var (r, x) || !read_var (r, y)) return false;
+            insert<typename basic_block_t::bool_assign_var_t> (b, *x, *y);
+            break;
+          case BOOL_ASSUME: {
+            if (!read_var (r, x)) return false;
+            bool is_negated = r.read<uint8_t> ();
+            if (!r.ok ()) return false;
+            insert<typename basic_block_t::bool_assume_t> (b, *x, is_negated);
+            break;
+          }
+          case BOOL_SELECT:
+            if (!read_var (r, x) || !read_var (r, y) || !read_var (r, z) || !read_var (r, w))
+              return false;
+            insert<typename basic_block_t::bool_select_t> (b, *x, *y, *z, *w);
+            break;
+          case BOOL_ASSERT:
+            if (!read_var (r, x)) return false;
+            insert<typename basic_block_t::bool_assert_t> (b, *x, dbg);
+            break;
+          default:
+            return false;
+        }
+        return true;
+      }
+
+      bool read_edges (binary_io::reader &r, std::vector<basic_block_label_t> &edges) {
+        uint32_t n = r.read<uint32_t> ();
+        if (!r.ok ()) return false;
+        edges.reserve (n);
+        for (uint32_t i=0; i < n; i++) {
+          const basic_block_label_t* l;
+          if (!read_label (r, l)) return false;
+          edges.push_back (*l);
+        }
+        return true;
+      }
+
+      cfg_ptr read_cfg (binary_io::reader &r) {
+        const basic_block_label_t *entry, *exit = nullptr;
+        if (!read_label (r, entry)) return nullptr;
+        bool has_exit = r.read<uint8_t> ();
+        if (has_exit && !read_label (r, exit)) return nullptr;
+        uint8_t track_prec = r.read<uint8_t> ();
+        if (!r.ok () || track_prec > ARR) return nullptr;
+
+        cfg_ptr cfg (new CFG (*entry, (tracked_precision) track_prec));
+        if (has_exit) cfg->set_exit (*exit);
+
+        bool has_decl = r.read<uint8_t> ();
+        if (has_decl) {
+          const varname_t* name;
+          if (!read_var (r, name)) return nullptr;
+          uint32_t num_lhs = r.read<uint32_t> ();
+          // function_decl only supports one return type
+          variable_type lhs_ty;
+          if (!r.ok () || num_lhs != 1 || !read_type (r, lhs_ty)) return nullptr;
+          std::vector<typed_variable_t> params;
+          if (!read_typed_vars (r, params)) return nullptr;
+          cfg->set_func_decl (fdecl_t (lhs_ty, *name, params));
+        }
+
+        uint32_t num_blocks = r.read<uint32_t> ();
+        if (!r.ok ()) return nullptr;
+        cfg->m_blocks.reserve (num_blocks);
+        for (uint32_t i=0; i < num_blocks; i++) {
+          const basic_block_label_t* l;
+          if (!read_label (r, l)) return nullptr;
+          basic_block_t &b = cfg->insert (*l);
+          uint32_t num_stmts = r.read<uint32_t> ();
+          if (!r.ok ()) return nullptr;
+          b.m_stmts.reserve (num_stmts);
+          for (uint32_t j=0; j < num_stmts; j++) {
+            if (!read_stmt (r, b)) return nullptr;
+          }
+          uint32_t num_live = r.read<uint32_t> ();
+          if (!r.ok ()) return nullptr;
+          for (uint32_t j=0; j < num_live; j++) {
+            const varname_t* v;
+            if (!read_var (r, v)) return nullptr;
+            b.m_live += *v;
+          }
+          // the edges were already deduplicated when the CFG was built
+          if (!read_edges (r, b.m_next) || !read_edges (r, b.m_prev)) return nullptr;
+        }
+
+        // all the edges must be between blocks of the CFG
+        for (auto const &kv: cfg->m_blocks) {
+          for (auto l: boost::make_iterator_range (kv.second->next_blocks ()))
+            if (cfg->m_blocks.find (l) == cfg->m_blocks.end ()) return nullptr;
+          for (auto l: boost::make_iterator_range (kv.second->prev_blocks ()))
+            if (cfg->m_blocks.find (l) == cfg->m_blocks.end ()) return nullptr;
+        }
+        if (has_exit && cfg->m_blocks.find (*exit) == cfg->m_blocks.end ()) return nullptr;
+        return cfg;
+      }
+
+     public:
+
+      cfg_reader (make_var_t mk_var, make_label_t mk_label)
+          : m_mk_var (mk_var), m_mk_label (mk_label) { }
+
+      //! Build the CFGs stored in [begin, end). Return false if the
+      //! input is not a valid serialized CFG.
+      bool read (const char* begin, const char* end, std::vector<cfg_ptr> &cfgs) {
+        using namespace cfg_binary_impl;
+        CRAB_STATS_SCOPE ("CFG.binary.load");
+
+        binary_io::reader r (begin, end);
+        const char* m = r.skip (magic_size);
+        if (!m || std::memcmp (m, magic (), magic_size) != 0) {
+          CRAB_WARN ("not a serialized CFG");
+          return false;
+        }
+        uint32_t v = r.read<uint32_t> ();
+        uint8_t tag = r.read<uint8_t> ();
+        if (v != version || tag != codec_t::tag) {
+          CRAB_WARN ("serialized CFG has version ", v, " and number type ", (char) tag,
+                     " but expected version ", version, " and number type ", (char) codec_t::tag);
+          return false;
+        }
+
+        if (!read_table (r, m_vars, m_mk_var) ||
+            !read_table (r, m_labels, m_mk_label) ||
+            !read_table<std::string> (r, m_files, [] (const std::string &s) { return s; })) {
+          CRAB_WARN ("serialized CFG is truncated");
+          return false;
+        }
+
+        uint32_t num_cfgs = r.read<uint32_t> ();
+        std::vector<cfg_ptr> res;
+        for (uint32_t i=0; r.ok () && i < num_cfgs; i++) {
+          cfg_ptr cfg = read_cfg (r);
+          if (!cfg) break;
+          res.push_back (cfg);
+        }
+        if (!r.ok () || res.size () != num_cfgs) {
+          CRAB_WARN ("serialized CFG is corrupted or truncated");
+          return false;
+        }
+        cfgs.insert (cfgs.end (), res.begin (), res.end ());
+        return true;
+      }
+
+      //! Map file into memory and build the CFGs stored in it.
+      bool load (const std::string &file, std::vector<cfg_ptr> &cfgs) {
+        if (!m_map.open (file)) return false;
+        bool res = read (m_map.begin (), m_map.end (), cfgs);
+        m_map.close ();
+        return res;
+      }
+    };
+
+  } // end namespace cfg
+} // end namespace crab
+
+#endif
@@ -6,6 +6,11 @@
  */
 
 #include <crab/common/types.hpp>
+#include <crab/common/analysis_context.hpp>
+
+#include <mutex>
+#include <limits>
+#include <vector>
 
 #include <boost/optional.hpp>
 #include <boost/noncopyable.hpp>
@@ -31,6 +36,15 @@ namespace crab {
        // 
        // The factory uses a counter of type index_t to generate variable
        // id's that always increases.
+       //
+       // Variable names are 32-bit handles: each element of type T is
+       // stored once in the factory and it is only looked up when the
+       // name is printed. Thus, the factory must outlive all the
+       // variables it creates.
+       //
+       // New variables can be requested concurrently (e.g., by abstract
+       // domains that create temporary variables during parallel
+       // analyses).
        template< class T>
        class variable_factory : public boost::noncopyable
        {
@@ -54,38 +68,23 @@ namespace crab {
            // typedef ikos::z_number index_t;
            
           private:
-	   boost::optional<T> _s;
-           index_t _id;
+           uint32_t _id;
            variable_factory* _vfac;
            
-           indexed_string();
+           indexed_string(): _id(0), _vfac(nullptr) { }
            
-           indexed_string(index_t id, variable_factory *vfac): 
+           indexed_string(uint32_t id, variable_factory *vfac): 
 	     _id(id), _vfac(vfac) { }
 	   
-           indexed_string(T s, index_t id, variable_factory *vfac): 
-	     _s(s), _id(id), _vfac(vfac) { }
-           
           public:
 
-	   ~indexed_string () {}
-	   
-           indexed_string(const indexed_string& is)
-               : _s(is._s), _id(is._id), _vfac(is._vfac) { }
-           
-           indexed_string& operator=(indexed_string is) {
-             _s = is._s;
-             _id = is._id;
-             _vfac = is._vfac;
-             return *this;
-           }
-           
            index_t index() const { return this->_id; }
            
            std::string str() const 
            { 
-             if (_s) {
-	       return indexed_string_impl::get_str<T>(*_s);
+             boost::optional<T> s = get();
+             if (s) {
+	       return indexed_string_impl::get_str<T>(*s);
 	     } else {
 	       // unlikely prefix
                return "@V_" + std::to_string(_id);
@@ -93,15 +92,15 @@ namespace crab {
            }
            
            boost::optional<T> get() const{
-	     return _s ? *_s : boost::optional<T> ();
+             return _vfac->get_name(_id);
            }
            
            variable_factory& get_var_factory () { return *_vfac; }
            
-           bool operator<(indexed_string s)  const 
+           bool operator<(const indexed_string& s)  const 
            { return (_id < s._id); }
            
-           bool operator==(indexed_string s) const 
+           bool operator==(const indexed_string& s) const 
            { return (_id == s._id);}
            
            void write(crab_os& o) 
@@ -109,16 +108,15 @@ namespace crab {
              o << str();
            }
            
-           friend crab_os& operator<<(crab_os& o, indexed_string s) 
+           friend crab_os& operator<<(crab_os& o, const indexed_string& s) 
            {
              o << s.str ();
              return o;
            }
            
-           friend size_t hash_value (indexed_string  s)
+           friend size_t hash_value (const indexed_string& s)
            {
-             boost::hash<index_t> hasher;
-             return hasher(s.index());
+             return s._id;
            }
          }; 
 
@@ -132,9 +130,32 @@ namespace crab {
          typedef boost::unordered_map< index_t, indexed_string > shadow_map_t;      
          
          index_t _next_id;
+         index_t _start_id;
          t_map_t _map;
+         // the element of each variable id, from _start_id. The keys
+         // of _map do not move so each element is only stored there.
+         // The shadow variables have no element.
+         std::vector<const T*> _names;
          shadow_map_t _shadow_map;
          std::vector<indexed_string> _shadow_vars;
+         mutable std::mutex _mutex;
+
+         // must be called with _mutex locked
+         indexed_string make (const T* name)
+         {
+           if (_next_id > std::numeric_limits<uint32_t>::max ()) {
+             CRAB_ERROR ("too many variables in the variable factory");
+           }
+           _names.push_back (name);
+           return indexed_string ((uint32_t) _next_id++, this);
+         }
+
+         boost::optional<T> get_name (uint32_t id) const
+         {
+           std::lock_guard<std::mutex> lock (_mutex);
+           const T* name = _names [id - _start_id];
+           return name ? *name : boost::optional<T> ();
+         }
          
         public:
          typedef indexed_string varname_t;
@@ -145,12 +166,14 @@ namespace crab {
          
         public:
 	 
-         variable_factory (): _next_id (1) { }
+         variable_factory (): _next_id (1), _start_id (1) { }
          
-         variable_factory (index_t start_id): _next_id (start_id) { }
+         variable_factory (index_t start_id)
+           : _next_id (start_id), _start_id (start_id) { }
 
 	 virtual ~variable_factory () {
 	   _map.clear ();
+	   _names.clear ();
 	   _shadow_map.clear ();
 	   _shadow_vars.clear ();
 	 }
@@ -160,7 +183,8 @@ namespace crab {
          // XXX: do not use it unless strictly necessary.
          virtual indexed_string get ()
          {
-           indexed_string is (_next_id++, this);
+           std::lock_guard<std::mutex> lock (_mutex);
+           indexed_string is = make (nullptr);
            _shadow_vars.push_back (is);
            return is;
          }
@@ -170,10 +194,11 @@ namespace crab {
          // XXX: do not use it unless strictly necessary.
          virtual indexed_string get (index_t key)
          {
+           std::lock_guard<std::mutex> lock (_mutex);
            auto it = _shadow_map.find (key);
            if (it == _shadow_map.end()) 
            {
-             indexed_string is (_next_id++, this);
+             indexed_string is = make (nullptr);
              _shadow_map.insert (typename shadow_map_t::value_type (key, is));
              _shadow_vars.push_back (is);
              return is;
@@ -184,12 +209,13 @@ namespace crab {
          
          virtual indexed_string operator[](T s) 
          {
+           std::lock_guard<std::mutex> lock (_mutex);
            auto it = _map.find (s);
            if (it == _map.end()) 
            {
-             indexed_string is (s, _next_id++, this);
-             _map.insert (typename t_map_t::value_type (s, is));
-             return is;
+             it = _map.insert (typename t_map_t::value_type (s, indexed_string ())).first;
+             it->second = make (&(it->first));
+             return it->second;
            }
            else 
              return it->second;
@@ -240,12 +266,15 @@ namespace crab {
   
        //! Three-coloured variable allocation. So the number of variables
        //  is bounded by 3|Tbl|, rather than always increasing.
+       //
+       //  The variables are created by the factory of the current
+       //  analysis context so that independent analyses do not share
+       //  it.
        class str_var_alloc_col {
          static const char** col_prefix;
         public:
          
          typedef str_variable_factory::varname_t varname_t;
-         static str_variable_factory vfac;
          
          str_var_alloc_col()
              : colour(0), next_id(0)
@@ -272,7 +301,7 @@ namespace crab {
          
          str_variable_factory::varname_t next() {
            std::string v = col_prefix[colour] + std::to_string(next_id++);
-           return vfac[v];
+           return analysis_context::current().get<str_variable_factory>()[v];
          }
          
         protected:
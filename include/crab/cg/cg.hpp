@@ -227,7 +227,7 @@ namespace crab {
 
         template<typename CFGIt>
         void build_call_graph (CFGIt I, CFGIt E) {
-          crab::ScopedCrabStats __st__("call_graph");
+          CRAB_STATS_SCOPE ("call_graph");
 
           // --- add vertices in the call graph
           for (auto cfg: boost::make_iterator_range(I,E)) {
@@ -7,6 +7,7 @@
 
 #include <crab/common/types.hpp>
 #include <crab/common/stats.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/checkers/base_property.hpp>
 #include <crab/analysis/fwd_analyzer.hpp>
 #include <crab/analysis/inter_fwd_analyzer.hpp>
@@ -79,12 +80,14 @@ namespace crab {
         : base_checker_t (checkers), m_analyzer (analyzer) { }
     
     virtual void run () override {
-      crab::ScopedCrabStats __st__("Checker");
+      CRAB_STATS_SCOPE ("Checker");
+      // the invariants are checked in the context of the analysis
+      analysis_context::scope ctx (m_analyzer.get_context ());
       cfg_t cfg = m_analyzer.get_cfg ();
 
-      // --- initialization of static data
-      // XXX: static data is overwritten each time a new CFG is
-      // analyzed. Here we re-initialize the static data.
+      // --- initialization of the data shared by all abstract values
+      // XXX: the shared data is overwritten each time a new CFG is
+      // analyzed in the same context. Here we re-initialize it.
       domains::domain_traits<abs_dom_t>::do_initialization (cfg);
         
       for (auto &bb: cfg) {
@@ -126,14 +129,15 @@ namespace crab {
         : base_checker_t (checkers), m_analyzer (analyzer) { }
     
     virtual void run () override {
-      crab::ScopedCrabStats __st__("Checker");
+      CRAB_STATS_SCOPE ("Checker");
+      analysis_context::scope ctx (m_analyzer.get_context ());
       cg_t& cg = m_analyzer.get_call_graph (); 
       for (auto &v: boost::make_iterator_range (vertices (cg))) {
         cfg_t cfg = v.get_cfg ();
 
-        // --- initialization of static data
-        // XXX: static data is overwritten each time a new CFG is
-        // analyzed. Here we re-initialize the static data.
+        // --- initialization of the data shared by all abstract values
+        // XXX: the shared data is overwritten each time a new CFG is
+        // analyzed in the same context. Here we re-initialize it.
         domains::domain_traits<abs_dom_t>::do_initialization (cfg);
         
         for (auto &bb: cfg) {
@@ -0,0 +1,124 @@
+#ifndef CRAB_ANALYSIS_CONTEXT_HPP
+#define CRAB_ANALYSIS_CONTEXT_HPP
+
+/*
+   Mutable state shared by all the abstract values of an analysis.
+
+   Some abstract domains need data that is not part of each abstract
+   value (e.g., the variable factory used by the term domain to name
+   its terms, the landmarks of the array graph domain or the managers
+   of external libraries). This data lives in an analysis_context
+   instead of in static members so that independent analyses can run
+   concurrently, one context per thread:
+
+     crab::analysis_context ctx;
+     crab::analysis_context::scope s (ctx);
+     ... build and run the analyzer ...
+
+   The context installed by a scope is the current one of the calling
+   thread until the scope is destroyed. If no scope is active the
+   current context is a process-wide default one, so analyses that do
+   not care about contexts behave as before.
+
+   All the abstract values of an analysis must be created and used
+   under the same context, and the context must outlive them.
+*/
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+namespace crab {
+
+  class analysis_context: public boost::noncopyable {
+
+    struct entry_base {
+      virtual ~entry_base () { }
+    };
+
+    template<typename T>
+    struct entry: public entry_base {
+      T m_value;
+    };
+
+    typedef std::map<std::type_index, boost::shared_ptr<entry_base> > state_map_t;
+
+    // unique among all contexts created by the process
+    const unsigned long m_id;
+    state_map_t m_state;
+    // the default context can be accessed by several threads
+    std::mutex m_mutex;
+
+    static unsigned long new_id () {
+      static std::atomic<unsigned long> next (1);
+      return next.fetch_add (1);
+    }
+
+    template<typename T>
+    T& lookup () {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      auto it = m_state.find (std::type_index (typeid (T)));
+      if (it == m_state.end ()) {
+        boost::shared_ptr<entry_base> e = boost::make_shared<entry<T> > ();
+        it = m_state.insert (std::make_pair (std::type_index (typeid (T)), e)).first;
+      }
+      return static_cast<entry<T>*> (it->second.get ())->m_value;
+    }
+
+    static analysis_context*& current_ptr () {
+      static thread_local analysis_context* ctx = nullptr;
+      return ctx;
+    }
+
+   public:
+
+    analysis_context (): m_id (new_id ()) { }
+
+    //! Return the data of type T owned by the context. It is default
+    //! constructed the first time it is requested.
+    template<typename T>
+    T& get () {
+      // Each thread remembers the last data of type T it obtained so
+      // that domains can call get from their transfer functions
+      // without taking the lock. Contexts are identified by id rather
+      // than by address since a context can be destroyed and another
+      // one allocated at the same address.
+      static thread_local std::pair<unsigned long, T*> last (0, nullptr);
+      if (last.first != m_id)
+        last = std::make_pair (m_id, &lookup<T> ());
+      return *last.second;
+    }
+
+    //! Return the process-wide default context
+    static analysis_context& global () {
+      static analysis_context ctx;
+      return ctx;
+    }
+
+    //! Return the context of the calling thread
+    static analysis_context& current () {
+      analysis_context* ctx = current_ptr ();
+      return ctx ? *ctx : global ();
+    }
+
+    //! Make a context the current one of the calling thread during
+    //! the lifetime of the scope. Scopes can be nested.
+    class scope: public boost::noncopyable {
+      analysis_context* m_prev;
+     public:
+      explicit scope (analysis_context &ctx): m_prev (current_ptr ()) {
+        current_ptr () = &ctx;
+      }
+      ~scope () { current_ptr () = m_prev; }
+    };
+  };
+
+} // end namespace crab
+
+#endif
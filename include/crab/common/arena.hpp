@@ -0,0 +1,125 @@
+#ifndef CRAB_ARENA_HPP
+#define CRAB_ARENA_HPP
+
+/*
+   A bump allocator for objects that live as long as their owner
+   (e.g., the statements and basic blocks of a CFG).
+
+   Objects are placed one after the other in large chunks so that
+   objects allocated in sequence are contiguous in memory. Memory is
+   only released when the arena is destroyed: objects are then
+   destroyed in reverse order of allocation.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace crab {
+
+  class arena: public boost::noncopyable {
+
+    struct chunk {
+      char* m_data;
+      std::size_t m_size;
+    };
+
+    struct destructor {
+      void* m_obj;
+      void (*m_fn) (void*);
+    };
+
+    static const std::size_t min_chunk_size = 4096;
+    static const std::size_t max_chunk_size = 1 << 20;
+
+    std::vector<chunk> m_chunks;
+    std::vector<destructor> m_dtors;
+    char* m_cur;
+    char* m_end;
+    std::size_t m_allocated;
+
+    template<typename T>
+    static void destroy (void* obj) {
+      static_cast<T*> (obj)->~T ();
+    }
+
+    void add_chunk (std::size_t bytes) {
+      // chunks grow geometrically so that the number of chunks is
+      // logarithmic in the size of the arena
+      std::size_t sz = m_chunks.empty () ?
+          min_chunk_size : std::min (2 * m_chunks.back ().m_size, max_chunk_size);
+      if (sz < bytes) sz = bytes;
+      char* data = static_cast<char*> (std::malloc (sz));
+      if (!data) throw std::bad_alloc ();
+      m_chunks.push_back (chunk {data, sz});
+      m_cur = data;
+      m_end = data + sz;
+    }
+
+   public:
+
+    arena (): m_cur (nullptr), m_end (nullptr), m_allocated (0) { }
+
+    ~arena () {
+      for (auto it = m_dtors.rbegin (); it != m_dtors.rend (); ++it)
+        it->m_fn (it->m_obj);
+      for (auto &c: m_chunks)
+        std::free (c.m_data);
+    }
+
+    //! Return uninitialized memory
+    void* allocate (std::size_t bytes, std::size_t align) {
+      std::size_t pad = (align - ((std::size_t) m_cur % align)) % align;
+      if (!m_cur || (std::size_t) (m_end - m_cur) < pad + bytes) {
+        add_chunk (bytes + align);
+        pad = (align - ((std::size_t) m_cur % align)) % align;
+      }
+      char* p = m_cur + pad;
+      m_cur = p + bytes;
+      m_allocated += bytes;
+      return p;
+    }
+
+    //! The destructor of obj will be called when the arena is
+    //! destroyed.
+    //! pre: obj has been allocated in the arena
+    template<typename T>
+    void own (T* obj) {
+      if (!std::is_trivially_destructible<T>::value)
+        m_dtors.push_back (destructor {obj, &destroy<T>});
+    }
+
+    template<typename T, typename... Args>
+    T* make (Args&&... args) {
+      T* obj = new (allocate (sizeof (T), alignof (T))) T (std::forward<Args> (args)...);
+      own (obj);
+      return obj;
+    }
+
+    //! Make sure that the next allocations of up to bytes in total are
+    //! contiguous
+    void reserve (std::size_t bytes) {
+      if (!m_cur || (std::size_t) (m_end - m_cur) < bytes)
+        add_chunk (bytes);
+    }
+
+    //! Number of bytes handed out by the arena
+    std::size_t allocated () const { return m_allocated; }
+
+    //! Number of bytes requested from the system
+    std::size_t capacity () const {
+      std::size_t n = 0;
+      for (auto const &c: m_chunks) n += c.m_size;
+      return n;
+    }
+  };
+
+} // end namespace crab
+
+#endif
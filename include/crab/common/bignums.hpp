@@ -43,156 +43,296 @@
 #define IKOS_BIGNUMS_HPP
 
 #include <climits>
+#include <string>
 #include <gmpxx.h>
 #include <boost/functional/hash.hpp>
 #include <crab/common/types.hpp>
 
+/*
+ * Both z_number and q_number keep small values inline in machine
+ * integers and only fall back to GMP when an operation overflows.
+ * The representation is canonical: a value is stored in a GMP object
+ * if and only if it does not fit into the inline representation.
+ */
+
 namespace ikos {
 
 class z_number {
   friend class q_number;
 
 private:
-  mpz_class _n;
+  typedef signed long small_t;
+
+  // if _big is null then the number is _small
+  small_t _small;
+  mpz_class* _big;
+
+  bool is_small() const { return !_big; }
+
+  mpz_class to_mpz() const {
+    if (is_small()) {
+      return mpz_class(_small);
+    } else {
+      return *_big;
+    }
+  }
+
+  void set_small(small_t n) {
+    if (_big) {
+      delete _big;
+      _big = nullptr;
+    }
+    _small = n;
+  }
+
+  void set_big(const mpz_class& n) {
+    if (n.fits_slong_p()) {
+      set_small(n.get_si());
+    } else if (_big) {
+      *_big = n;
+    } else {
+      _big = new mpz_class(n);
+    }
+  }
+
+  // slow paths
+  static z_number slow_add(const z_number& x, const z_number& y) {
+    mpz_class r = x.to_mpz() + y.to_mpz();
+    return z_number(r);
+  }
+
+  static z_number slow_sub(const z_number& x, const z_number& y) {
+    mpz_class r = x.to_mpz() - y.to_mpz();
+    return z_number(r);
+  }
+
+  static z_number slow_mul(const z_number& x, const z_number& y) {
+    mpz_class r = x.to_mpz() * y.to_mpz();
+    return z_number(r);
+  }
+
+  static int slow_cmp(const z_number& x, const z_number& y) {
+    if (x.is_small()) {
+      return -mpz_cmp_si(y._big->get_mpz_t(), x._small);
+    } else if (y.is_small()) {
+      return mpz_cmp_si(x._big->get_mpz_t(), y._small);
+    } else {
+      return ::mpz_cmp(x._big->get_mpz_t(), y._big->get_mpz_t());
+    }
+  }
+
+  int cmp(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return (_small < x._small ? -1 : (_small > x._small ? 1 : 0));
+    } else {
+      return slow_cmp(*this, x);
+    }
+  }
 
 public:
 
-  z_number(mpz_class n) : _n(n) {}
+  z_number(mpz_class n) : _small(0), _big(nullptr) { set_big(n); }
 
   static z_number from_ulong(unsigned long n) {
-    mpz_class b(n);
-    return z_number(b);
+    if (n <= (unsigned long) LONG_MAX) {
+      return z_number((signed long long) n);
+    } else {
+      mpz_class b(n);
+      return z_number(b);
+    }
   }
 
   static z_number from_slong(signed long n) {
-    mpz_class b(n);
-    return z_number(b);
+    return z_number((signed long long) n);
   }
 
+  // true iff the number can be converted to a signed long integer
+  bool fits_slong() const { return is_small(); }
+
   // overloaded typecast operators
   explicit operator long() const { 
-    if (_n.fits_slong_p ()) {
-      return _n.get_si ();
-    }
-    else {
-      CRAB_ERROR("mpz_class ", _n.get_str(), " does not fit into a signed long integer");
+    if (is_small()) {
+      return _small;
+    } else {
+      CRAB_ERROR("mpz_class ", _big->get_str(), " does not fit into a signed long integer");
     }
   } 
 
   explicit operator int() const { 
-    if (_n.fits_sint_p ()) {
-      // get_si returns a signed long so we cast it to int
-      return (int) _n.get_si ();
-    }
-    else {
-      CRAB_ERROR("mpz_class ", _n.get_str(), " does not fit into a signed integer");
+    if (is_small() && _small >= INT_MIN && _small <= INT_MAX) {
+      return (int) _small;
+    } else {
+      CRAB_ERROR("mpz_class ", get_str(), " does not fit into a signed integer");
     }
   } 
 
   explicit operator mpz_class() const { 
-    return _n;
+    return to_mpz();
   } 
 
 public:
 
-  z_number() : _n(0) {}
+  z_number() : _small(0), _big(nullptr) {}
 
-  z_number(std::string s) {
+  z_number(std::string s) : _small(0), _big(nullptr) {
     try {
-      this->_n = s;
+      mpz_class n(s);
+      set_big(n);
     } catch (std::invalid_argument& e) {
       CRAB_ERROR ("z_number: invalid string in constructor", s);
     }
   }
 
-  z_number(signed long long int n) : _n((signed long int) n) {
-    if (n > LONG_MAX) {
+  z_number(signed long long int n) : _small((small_t) n), _big(nullptr) {
+    if (n > LONG_MAX || n < LONG_MIN) {
       CRAB_ERROR(n, " cannot fit into a signed long int: use another mpz_class constructor");
     }
   }
 
+  z_number(const z_number& o)
+      : _small(o._small), _big(o._big ? new mpz_class(*o._big) : nullptr) {}
+
+  z_number(z_number&& o) : _small(o._small), _big(o._big) {
+    o._big = nullptr;
+  }
+
+  z_number& operator=(const z_number& o) {
+    if (this != &o) {
+      if (o.is_small()) {
+        set_small(o._small);
+      } else {
+        set_big(*o._big);
+      }
+    }
+    return *this;
+  }
+
+  z_number& operator=(z_number&& o) {
+    if (this != &o) {
+      delete _big;
+      _small = o._small;
+      _big = o._big;
+      o._big = nullptr;
+    }
+    return *this;
+  }
+
+  ~z_number() { delete _big; }
+
   std::string get_str () const {
-    return _n.get_str();
+    if (is_small()) {
+      return std::to_string(_small);
+    } else {
+      return _big->get_str();
+    }
   }
 
-  z_number operator+(z_number x) const {
-    mpz_class r = this->_n + x._n;
-    return z_number(r);
+  z_number operator+(const z_number& x) const {
+    small_t r;
+    if (is_small() && x.is_small() &&
+        !__builtin_add_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    return slow_add(*this, x);
   }
 
-  z_number operator*(z_number x) const {
-    mpz_class r = this->_n * x._n;
-    return z_number(r);
+  z_number operator*(const z_number& x) const {
+    small_t r;
+    if (is_small() && x.is_small() &&
+        !__builtin_mul_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    return slow_mul(*this, x);
   }
 
-  z_number operator-(z_number x) const {
-    mpz_class r = this->_n - x._n;
-    return z_number(r);
+  z_number operator-(const z_number& x) const {
+    small_t r;
+    if (is_small() && x.is_small() &&
+        !__builtin_sub_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    return slow_sub(*this, x);
   }
 
   z_number operator-() const {
-    mpz_class r = -this->_n;
+    if (is_small() && _small != LONG_MIN) {
+      return z_number((signed long long) -_small);
+    }
+    mpz_class r = -to_mpz();
     return z_number(r);
   }
 
-  z_number operator/(z_number x) const {
-    if (x._n == 0) {
+  z_number operator/(const z_number& x) const {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [1]");
+    } else if (is_small() && x.is_small() && !(_small == LONG_MIN && x._small == -1)) {
+      return z_number((signed long long) (_small / x._small));
     } else {
-      mpz_class r = this->_n / x._n;
+      mpz_class r = to_mpz() / x.to_mpz();
       return z_number(r);
     }
   }
 
-  z_number operator%(z_number x) const {
-    if (x._n == 0) {
+  z_number operator%(const z_number& x) const {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [2]");
+    } else if (is_small() && x.is_small()) {
+      // x % -1 is always 0 but LONG_MIN % -1 overflows
+      return z_number((signed long long) (x._small == -1 ? 0 : _small % x._small));
     } else {
-      mpz_class r = this->_n % x._n;
+      mpz_class r = to_mpz() % x.to_mpz();
       return z_number(r);
     }
   }
 
-  z_number& operator+=(z_number x) {
-    this->_n += x._n;
+  z_number& operator+=(const z_number& x) {
+    *this = *this + x;
     return *this;
   }
 
-  z_number& operator*=(z_number x) {
-    this->_n *= x._n;
+  z_number& operator*=(const z_number& x) {
+    *this = *this * x;
     return *this;
   }
 
-  z_number& operator-=(z_number x) {
-    this->_n -= x._n;
+  z_number& operator-=(const z_number& x) {
+    *this = *this - x;
     return *this;
   }
 
-  z_number& operator/=(z_number x) {
-    if (x._n == 0) {
+  z_number& operator/=(const z_number& x) {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [3]");
     } else {
-      this->_n /= x._n;
+      *this = *this / x;
       return *this;
     }
   }
 
-  z_number& operator%=(z_number x) {
-    if (x._n == 0) {
+  z_number& operator%=(const z_number& x) {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [4]");
     } else {
-      this->_n %= x._n;
+      *this = *this % x;
       return *this;
     }
   }
 
   z_number& operator--() {
-    --(this->_n);
+    if (is_small() && _small != LONG_MIN) {
+      --_small;
+    } else {
+      *this -= 1;
+    }
     return *this;
   }
 
   z_number& operator++() {
-    ++(this->_n);
+    if (is_small() && _small != LONG_MAX) {
+      ++_small;
+    } else {
+      *this += 1;
+    }
     return *this;
   }
 
@@ -208,50 +348,102 @@ public:
     return r;
   }
 
-  bool operator==(z_number x) const { return this->_n == x._n; }
+  bool operator==(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return _small == x._small;
+    } else if (is_small() || x.is_small()) {
+      // canonical representation
+      return false;
+    } else {
+      return *_big == *x._big;
+    }
+  }
 
-  bool operator!=(z_number x) const { return this->_n != x._n; }
+  bool operator!=(const z_number& x) const { return !(*this == x); }
 
-  bool operator<(z_number x) const { return this->_n < x._n; }
+  bool operator<(const z_number& x) const { return cmp(x) < 0; }
 
-  bool operator<=(z_number x) const { return this->_n <= x._n; }
+  bool operator<=(const z_number& x) const { return cmp(x) <= 0; }
 
-  bool operator>(z_number x) const { return this->_n > x._n; }
+  bool operator>(const z_number& x) const { return cmp(x) > 0; }
 
-  bool operator>=(z_number x) const { return this->_n >= x._n; }
+  bool operator>=(const z_number& x) const { return cmp(x) >= 0; }
 
-  z_number operator&(z_number x) const { return z_number(this->_n & x._n); }
+  z_number operator&(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small & x._small));
+    }
+    mpz_class r = to_mpz() & x.to_mpz();
+    return z_number(r);
+  }
 
-  z_number operator|(z_number x) const { return z_number(this->_n | x._n); }
+  z_number operator|(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small | x._small));
+    }
+    mpz_class r = to_mpz() | x.to_mpz();
+    return z_number(r);
+  }
 
-  z_number operator^(z_number x) const { return z_number(this->_n ^ x._n); }
+  z_number operator^(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small ^ x._small));
+    }
+    mpz_class r = to_mpz() ^ x.to_mpz();
+    return z_number(r);
+  }
 
-  z_number operator<<(z_number x) const {
+  z_number operator<<(const z_number& x) const {
+    small_t r;
+    if (is_small() && x.is_small() && x._small >= 0 && x._small < 63 &&
+        !__builtin_mul_overflow(_small, ((small_t) 1) << x._small, &r)) {
+      return z_number((signed long long) r);
+    }
     mpz_t tmp;
     mpz_init(tmp);
-    mpz_mul_2exp(tmp, this->_n.get_mpz_t(), mpz_get_ui(x._n.get_mpz_t()));
+    mpz_class n = to_mpz();
+    mpz_mul_2exp(tmp, n.get_mpz_t(), mpz_get_ui(x.to_mpz().get_mpz_t()));
     mpz_class result(tmp);
+    mpz_clear(tmp);
     return z_number(result);
   }
 
-  z_number operator>>(z_number x) const {
-    mpz_class tmp(this->_n);
-    return z_number(tmp.operator>>=(mpz_get_ui(x._n.get_mpz_t())));
+  z_number operator>>(const z_number& x) const {
+    if (is_small() && x.is_small() && x._small >= 0) {
+      // rounding towards minus infinity as GMP does
+      if (x._small >= 63) {
+        return z_number((signed long long) (_small < 0 ? -1 : 0));
+      } else {
+        return z_number((signed long long) (_small >> x._small));
+      }
+    }
+    mpz_class tmp(to_mpz());
+    return z_number(tmp.operator>>=(mpz_get_ui(x.to_mpz().get_mpz_t())));
   }
 
   z_number fill_ones() const {
-    assert(this->_n >= 0);
-    if (this->_n == 0) {
+    assert(*this >= 0);
+    if (*this == 0) {
       return z_number(0);
     }
 
-    mpz_class result;
-    for (result = 1; result < this->_n; result = 2 * result + 1)
+    z_number result(1);
+    for (; result < *this; result = result * 2 + 1)
       ;
-    return z_number(result);
+    return result;
   }
 
-  void write(crab::crab_os& o) { o << this->_n.get_str(); }
+  void write(crab::crab_os& o) { o << get_str(); }
+
+  friend std::size_t hash_value(const z_number& n) {
+    if (n.is_small()) {
+      boost::hash<small_t> hasher;
+      return hasher(n._small);
+    } else {
+      boost::hash<std::string> hasher;
+      return hasher(n.get_str());
+    }
+  }
 
 }; // class z_number
 
@@ -260,104 +452,263 @@ inline crab::crab_os& operator<<(crab::crab_os& o, z_number z) {
   return o;
 }
 
-inline std::size_t hash_value(const z_number& n) {
-  boost::hash<std::string> hasher;
-  return hasher(n.get_str());
-}
-
 class q_number {
 private:
-  mpq_class _n;
+  typedef signed long small_t;
+
+  // if _big is null then the number is _num/_den where _den > 0 and
+  // gcd(_num, _den) = 1.
+  small_t _num;
+  small_t _den;
+  mpq_class* _big;
+
+  bool is_small() const { return !_big; }
+
+  mpq_class to_mpq() const {
+    if (is_small()) {
+      return mpq_class(mpz_class(_num), mpz_class(_den));
+    } else {
+      return *_big;
+    }
+  }
+
+  static small_t gcd(small_t a, small_t b) {
+    // pre: b > 0 and a != LONG_MIN
+    if (a < 0) a = -a;
+    while (b != 0) {
+      small_t t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+
+  // Store num/den in canonical form. Return false if it cannot be
+  // stored inline.
+  bool try_set_small(small_t num, small_t den) {
+    if (den == 0 || num == LONG_MIN || den == LONG_MIN) {
+      return false;
+    }
+    if (den < 0) {
+      num = -num;
+      den = -den;
+    }
+    small_t g = gcd(num, den);
+    if (_big) {
+      delete _big;
+      _big = nullptr;
+    }
+    _num = num / g;
+    _den = den / g;
+    return true;
+  }
+
+  // pre: n is canonical
+  void set_big(const mpq_class& n) {
+    if (n.get_num().fits_slong_p() && n.get_den().fits_slong_p() &&
+        try_set_small(n.get_num().get_si(), n.get_den().get_si())) {
+      return;
+    } else if (_big) {
+      *_big = n;
+    } else {
+      _big = new mpq_class(n);
+    }
+  }
+
+  int cmp(const q_number& x) const {
+    if (is_small() && x.is_small()) {
+      small_t l, r;
+      if (!__builtin_mul_overflow(_num, x._den, &l) &&
+          !__builtin_mul_overflow(x._num, _den, &r)) {
+        return (l < r ? -1 : (l > r ? 1 : 0));
+      }
+    }
+    return ::cmp(to_mpq(), x.to_mpq());
+  }
 
 public:
   
-  q_number() : _n(0) {}
+  q_number() : _num(0), _den(1), _big(nullptr) {}
 
-  q_number(mpq_class n) : _n(n) {}
+  q_number(mpq_class n) : _num(0), _den(1), _big(nullptr) {
+    n.canonicalize();
+    set_big(n);
+  }
   
-  q_number(std::string s) {
+  q_number(std::string s) : _num(0), _den(1), _big(nullptr) {
     try {
-      this->_n = s;
-      this->_n.canonicalize();
+      mpq_class n(s);
+      n.canonicalize();
+      set_big(n);
     } catch (std::invalid_argument& e) {
       CRAB_ERROR("q_number: invalid string in constructor ",s);
     }
   }
 
-  q_number(double n): _n(n) { this->_n.canonicalize(); }
+  q_number(double n) : _num(0), _den(1), _big(nullptr) {
+    mpq_class q(n);
+    q.canonicalize();
+    set_big(q);
+  }
   
-  q_number(z_number n) : _n(n._n) { this->_n.canonicalize(); }
+  q_number(z_number n) : _num(0), _den(1), _big(nullptr) {
+    if (!n.is_small() || !try_set_small(n._small, 1)) {
+      set_big(mpq_class(n.to_mpz()));
+    }
+  }
 
-  q_number(z_number n, z_number d) : _n(n._n, d._n) { this->_n.canonicalize(); }
+  q_number(z_number n, z_number d) : _num(0), _den(1), _big(nullptr) {
+    if (!n.is_small() || !d.is_small() || !try_set_small(n._small, d._small)) {
+      mpq_class q(n.to_mpz(), d.to_mpz());
+      q.canonicalize();
+      set_big(q);
+    }
+  }
+
+  q_number(const q_number& o)
+      : _num(o._num), _den(o._den),
+        _big(o._big ? new mpq_class(*o._big) : nullptr) {}
+
+  q_number(q_number&& o) : _num(o._num), _den(o._den), _big(o._big) {
+    o._big = nullptr;
+  }
+
+  q_number& operator=(const q_number& o) {
+    if (this != &o) {
+      if (o.is_small()) {
+        if (_big) {
+          delete _big;
+          _big = nullptr;
+        }
+        _num = o._num;
+        _den = o._den;
+      } else {
+        set_big(*o._big);
+      }
+    }
+    return *this;
+  }
+
+  q_number& operator=(q_number&& o) {
+    if (this != &o) {
+      delete _big;
+      _num = o._num;
+      _den = o._den;
+      _big = o._big;
+      o._big = nullptr;
+    }
+    return *this;
+  }
+
+  ~q_number() { delete _big; }
 
   explicit operator mpq_class() const { 
-    return _n;
+    return to_mpq();
   } 
 
   std::string get_str () const {
-    return _n.get_str();
+    if (is_small()) {
+      if (_den == 1) {
+        return std::to_string(_num);
+      } else {
+        return std::to_string(_num) + "/" + std::to_string(_den);
+      }
+    } else {
+      return _big->get_str();
+    }
   }
 
-  q_number operator+(q_number x) const {
-    mpq_class r = this->_n + x._n;
+  q_number operator+(const q_number& x) const {
+    if (is_small() && x.is_small()) {
+      small_t l, r, n, d;
+      q_number res;
+      if (!__builtin_mul_overflow(_num, x._den, &l) &&
+          !__builtin_mul_overflow(x._num, _den, &r) &&
+          !__builtin_add_overflow(l, r, &n) &&
+          !__builtin_mul_overflow(_den, x._den, &d) &&
+          res.try_set_small(n, d)) {
+        return res;
+      }
+    }
+    mpq_class r = to_mpq() + x.to_mpq();
     return q_number(r);
   }
 
-  q_number operator*(q_number x) const {
-    mpq_class r = this->_n * x._n;
+  q_number operator*(const q_number& x) const {
+    if (is_small() && x.is_small()) {
+      small_t n, d;
+      q_number res;
+      if (!__builtin_mul_overflow(_num, x._num, &n) &&
+          !__builtin_mul_overflow(_den, x._den, &d) &&
+          res.try_set_small(n, d)) {
+        return res;
+      }
+    }
+    mpq_class r = to_mpq() * x.to_mpq();
     return q_number(r);
   }
 
-  q_number operator-(q_number x) const {
-    mpq_class r = this->_n - x._n;
-    return q_number(r);
+  q_number operator-(const q_number& x) const {
+    return *this + (-x);
   }
 
   q_number operator-() const {
-    mpq_class r = -this->_n;
+    if (is_small() && _num != LONG_MIN) {
+      q_number res(*this);
+      res._num = -res._num;
+      return res;
+    }
+    mpq_class r = -to_mpq();
     return q_number(r);
   }
 
-  q_number operator/(q_number x) const {
-    if (x._n == 0) {
+  q_number operator/(const q_number& x) const {
+    if (x == 0) {
       CRAB_ERROR("q_number: division by zero [1]");
-    } else {
-      mpq_class r = this->_n / x._n;
-      return q_number(r);
+    } else if (is_small() && x.is_small()) {
+      small_t n, d;
+      q_number res;
+      if (!__builtin_mul_overflow(_num, x._den, &n) &&
+          !__builtin_mul_overflow(_den, x._num, &d) &&
+          res.try_set_small(n, d)) {
+        return res;
+      }
     }
+    mpq_class r = to_mpq() / x.to_mpq();
+    return q_number(r);
   }
 
-  q_number& operator+=(q_number x) {
-    this->_n += x._n;
+  q_number& operator+=(const q_number& x) {
+    *this = *this + x;
     return *this;
   }
 
-  q_number& operator*=(q_number x) {
-    this->_n *= x._n;
+  q_number& operator*=(const q_number& x) {
+    *this = *this * x;
     return *this;
   }
 
-  q_number& operator-=(q_number x) {
-    this->_n -= x._n;
+  q_number& operator-=(const q_number& x) {
+    *this = *this - x;
     return *this;
   }
 
-  q_number& operator/=(q_number x) {
-    if (x._n == 0) {
+  q_number& operator/=(const q_number& x) {
+    if (x == 0) {
       CRAB_ERROR("q_number: division by zero [2]");
     } else {
-      this->_n /= x._n;
+      *this = *this / x;
       return *this;
     }
   }
 
   q_number& operator--() {
-    --(this->_n);
+    *this -= 1;
     return *this;
   }
 
   q_number& operator++() {
-    ++(this->_n);
+    *this += 1;
     return *this;
   }
 
@@ -373,21 +724,42 @@ public:
     return r;
   }
 
-  bool operator==(q_number x) const { return this->_n == x._n; }
+  bool operator==(const q_number& x) const {
+    if (is_small() && x.is_small()) {
+      return _num == x._num && _den == x._den;
+    } else if (is_small() || x.is_small()) {
+      // canonical representation
+      return false;
+    } else {
+      return *_big == *x._big;
+    }
+  }
 
-  bool operator!=(q_number x) const { return this->_n != x._n; }
+  bool operator!=(const q_number& x) const { return !(*this == x); }
 
-  bool operator<(q_number x) const { return this->_n < x._n; }
+  bool operator<(const q_number& x) const { return cmp(x) < 0; }
 
-  bool operator<=(q_number x) const { return this->_n <= x._n; }
+  bool operator<=(const q_number& x) const { return cmp(x) <= 0; }
 
-  bool operator>(q_number x) const { return this->_n > x._n; }
+  bool operator>(const q_number& x) const { return cmp(x) > 0; }
 
-  bool operator>=(q_number x) const { return this->_n >= x._n; }
+  bool operator>=(const q_number& x) const { return cmp(x) >= 0; }
 
-  z_number numerator() const { return z_number(this->_n.get_num()); }
+  z_number numerator() const {
+    if (is_small()) {
+      return z_number((signed long long) _num);
+    } else {
+      return z_number(_big->get_num());
+    }
+  }
 
-  z_number denominator() const { return z_number(this->_n.get_den()); }
+  z_number denominator() const {
+    if (is_small()) {
+      return z_number((signed long long) _den);
+    } else {
+      return z_number(_big->get_den());
+    }
+  }
 
   z_number round_to_upper() const {
     z_number num = numerator();
@@ -413,7 +785,19 @@ public:
     }
   }
 
-  void write(crab::crab_os& o) { o << this->_n.get_str(); }
+  void write(crab::crab_os& o) { o << get_str(); }
+
+  friend std::size_t hash_value(const q_number& n) {
+    if (n.is_small()) {
+      std::size_t seed = 0;
+      boost::hash_combine(seed, n._num);
+      boost::hash_combine(seed, n._den);
+      return seed;
+    } else {
+      boost::hash<std::string> hasher;
+      return hasher(n.get_str());
+    }
+  }
 
 }; // class q_number
 
@@ -422,10 +806,6 @@ inline crab::crab_os& operator<<(crab::crab_os& o, q_number q) {
   return o;
 }
 
-inline std::size_t hash_value(const q_number& n) {
-  boost::hash<std::string> hasher;
-  return hasher(n.get_str());
-}
 }
 
 #endif // IKOS_BIGNUMS_HPP
@@ -0,0 +1,147 @@
+#ifndef CRAB_BINARY_IO_HPP
+#define CRAB_BINARY_IO_HPP
+
+/*
+   Helpers to write and read the binary files produced by Crab (e.g.,
+   the summary cache or serialized CFGs).
+
+   Values are stored in native endianness. Strings are a u32 length
+   followed by the characters.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace crab {
+
+  namespace binary_io {
+
+    class writer {
+      std::string &m_buf;
+     public:
+      writer (std::string &buf): m_buf (buf) { }
+
+      template<typename T>
+      void write (T v) {
+        m_buf.append ((const char*) &v, sizeof (T));
+      }
+
+      void write (const std::string &s) {
+        write<uint32_t> (s.size ());
+        m_buf.append (s);
+      }
+
+      std::size_t size () const { return m_buf.size (); }
+    };
+
+    class reader {
+      const char* m_cur;
+      const char* m_end;
+      bool m_ok;
+     public:
+      reader (const char* begin, const char* end)
+          : m_cur (begin), m_end (end), m_ok (true) { }
+
+      bool ok () const { return m_ok; }
+
+      const char* pos () const { return m_cur; }
+
+      template<typename T>
+      T read () {
+        T v = T ();
+        if (!m_ok || m_end - m_cur < (std::ptrdiff_t) sizeof (T)) {
+          m_ok = false;
+          return v;
+        }
+        std::memcpy (&v, m_cur, sizeof (T));
+        m_cur += sizeof (T);
+        return v;
+      }
+
+      std::string read_string () {
+        uint32_t n = read<uint32_t> ();
+        const char* p = skip (n);
+        return p ? std::string (p, n) : std::string ();
+      }
+
+      const char* skip (uint32_t n) {
+        if (!m_ok || (uint64_t) (m_end - m_cur) < n) {
+          m_ok = false;
+          return nullptr;
+        }
+        const char* p = m_cur;
+        m_cur += n;
+        return p;
+      }
+    };
+
+    // A read-only memory mapping of a whole file
+    class mapped_file: public boost::noncopyable {
+      void* m_addr;
+      std::size_t m_size;
+
+     public:
+      mapped_file (): m_addr (nullptr), m_size (0) { }
+
+      ~mapped_file () { close (); }
+
+      //! Return false if the file does not exist or it is empty
+      bool open (const std::string &file) {
+        close ();
+        int fd = ::open (file.c_str (), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat (fd, &st) < 0 || st.st_size == 0) {
+          ::close (fd);
+          return false;
+        }
+        void* addr = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close (fd);
+        if (addr == MAP_FAILED) return false;
+        m_addr = addr;
+        m_size = st.st_size;
+        return true;
+      }
+
+      void close () {
+        if (m_addr) {
+          munmap (m_addr, m_size);
+          m_addr = nullptr;
+          m_size = 0;
+        }
+      }
+
+      bool is_open () const { return m_addr != nullptr; }
+
+      const char* begin () const { return (const char*) m_addr; }
+
+      const char* end () const { return begin () + m_size; }
+
+      std::size_t size () const { return m_size; }
+    };
+
+    //! Write buf to file through a temporary file so that a
+    //! concurrent reader never sees a partial file.
+    inline bool write_file (const std::string &file, const std::string &buf) {
+      std::string tmp_file = file + ".tmp";
+      FILE* f = std::fopen (tmp_file.c_str (), "wb");
+      if (!f) return false;
+      bool ok = (std::fwrite (buf.data (), 1, buf.size (), f) == buf.size ());
+      ok = (std::fclose (f) == 0) && ok;
+      ok = ok && (std::rename (tmp_file.c_str (), file.c_str ()) == 0);
+      return ok;
+    }
+
+  } // end namespace binary_io
+} // end namespace crab
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef CRAB_PARALLEL_HPP
+#define CRAB_PARALLEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+   Work-stealing scheduler for a DAG of tasks.
+*/
+
+namespace crab {
+
+  namespace parallel {
+
+    namespace dag_impl {
+      struct worker_queue {
+        std::mutex m_mutex;
+        std::deque<std::size_t> m_tasks;
+      };
+    } // end namespace dag_impl
+
+    // Run fn(i) for each task i in [0, succs.size ()) such that fn(i)
+    // starts only after fn(j) has finished for all j with i in
+    // succs[j].
+    //
+    // Each worker owns a deque: tasks that become ready are pushed
+    // and popped at its back and idle workers steal from the front of
+    // the others. The calling thread is one of the workers.
+    //
+    // pre: succs describes a DAG.
+    template<typename Fn>
+    void run_dag (const std::vector<std::vector<std::size_t> > &succs,
+                  unsigned int num_threads, Fn fn) {
+
+      typedef dag_impl::worker_queue worker_queue_t;
+
+      const std::size_t n = succs.size ();
+      if (n == 0) return;
+
+      std::vector<std::size_t> indegree (n, 0);
+      for (auto const &ss: succs)
+        for (auto s: ss) indegree [s]++;
+
+      if (num_threads <= 1) {
+        // -- sequential fallback: plain Kahn's algorithm
+        std::deque<std::size_t> ready;
+        for (std::size_t i=0; i < n; i++)
+          if (indegree [i] == 0) ready.push_back (i);
+        while (!ready.empty ()) {
+          std::size_t t = ready.front ();
+          ready.pop_front ();
+          fn (t);
+          for (auto s: succs [t])
+            if (--indegree [s] == 0) ready.push_back (s);
+        }
+        return;
+      }
+
+      std::vector<std::atomic<std::size_t> > pending (n);
+      for (std::size_t i=0; i < n; i++) pending [i].store (indegree [i]);
+
+      std::vector<worker_queue_t> queues (num_threads);
+      // all the fields below are protected by idle_mutex
+      std::mutex idle_mutex;
+      std::condition_variable idle_cv;
+      std::size_t num_ready = 0;
+      std::size_t num_done = 0;
+      std::exception_ptr error;
+
+      auto push = [&](unsigned int w, std::size_t t) {
+        {
+          std::lock_guard<std::mutex> lk (queues [w].m_mutex);
+          queues [w].m_tasks.push_back (t);
+        }
+        {
+          std::lock_guard<std::mutex> lk (idle_mutex);
+          num_ready++;
+        }
+        idle_cv.notify_one ();
+      };
+
+      auto pop = [&](unsigned int w, std::size_t &t) -> bool {
+        bool found = false;
+        for (unsigned int k=0; k < num_threads && !found; k++) {
+          worker_queue_t &q = queues [(w + k) % num_threads];
+          std::lock_guard<std::mutex> lk (q.m_mutex);
+          if (q.m_tasks.empty ()) continue;
+          if (k == 0) { // own queue
+            t = q.m_tasks.back ();
+            q.m_tasks.pop_back ();
+          } else {      // steal
+            t = q.m_tasks.front ();
+            q.m_tasks.pop_front ();
+          }
+          found = true;
+        }
+        if (found) {
+          std::lock_guard<std::mutex> lk (idle_mutex);
+          num_ready--;
+        }
+        return found;
+      };
+
+      auto worker = [&](unsigned int w) {
+        while (true) {
+          std::size_t t;
+          if (pop (w, t)) {
+            try {
+              fn (t);
+            } catch (...) {
+              std::lock_guard<std::mutex> lk (idle_mutex);
+              if (!error) error = std::current_exception ();
+              idle_cv.notify_all ();
+              return;
+            }
+            for (auto s: succs [t])
+              if (--pending [s] == 0) push (w, s);
+            std::lock_guard<std::mutex> lk (idle_mutex);
+            if (++num_done == n) idle_cv.notify_all ();
+            continue;
+          }
+          std::unique_lock<std::mutex> lk (idle_mutex);
+          idle_cv.wait (lk, [&]{ return num_ready > 0 || num_done == n || error; });
+          if (error || (num_ready == 0 && num_done == n)) return;
+        }
+      };
+
+      // distribute the initial tasks in round-robin
+      unsigned int next = 0;
+      for (std::size_t i=0; i < n; i++) {
+        if (indegree [i] == 0) {
+          queues [next].m_tasks.push_back (i);
+          num_ready++;
+          next = (next + 1) % num_threads;
+        }
+      }
+
+      std::vector<std::thread> threads;
+      threads.reserve (num_threads - 1);
+      for (unsigned int w=1; w < num_threads; w++)
+        threads.push_back (std::thread (worker, w));
+      worker (0);
+      for (auto &th: threads) th.join ();
+
+      if (error) std::rethrow_exception (error);
+    }
+
+  } // end namespace parallel
+} // end namespace crab
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef CRAB_POOL_HPP
+#define CRAB_POOL_HPP
+
+/*
+   A pool of fixed-size blocks for small objects that are allocated
+   and freed very often (e.g., the nodes of patricia trees).
+
+   Each thread keeps its own list of free blocks so that allocating
+   and freeing a block does not require any synchronization. A block
+   can be freed by a thread different from the one that allocated
+   it: it is then reused by the thread that freed it. Blocks are
+   carved out of large chunks which are never returned to the
+   system. The free blocks of a thread that terminates are given
+   back to a shared list so that other threads can reuse them.
+*/
+
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace crab {
+
+  template<std::size_t Size>
+  class fixed_size_pool {
+
+    struct block {
+      block* m_next;
+    };
+
+    // Size of each block: large enough to hold a block and aligned
+    // as any object
+    static const std::size_t align = alignof (std::max_align_t);
+    static const std::size_t block_size =
+        ((Size < sizeof (block) ? sizeof (block) : Size) + align - 1) / align * align;
+    static const std::size_t blocks_per_chunk =
+        block_size > 4096 ? 1 : 4096 / block_size;
+
+    // Blocks shared by all threads
+    struct shared_state {
+      std::mutex m_mutex;
+      block* m_free;
+      shared_state (): m_free (nullptr) { }
+    };
+
+    // The shared state is never destroyed: blocks can be freed by
+    // static destructors that run after it would have been.
+    static shared_state& shared () {
+      static shared_state* s = new shared_state ();
+      return *s;
+    }
+
+    // Free blocks of the current thread. It is trivially destructible
+    // so it can be used at any time during the thread exit.
+    struct local_state {
+      block* m_free;
+      bool m_exited;
+    };
+
+    static local_state& local () {
+      static thread_local local_state s = {nullptr, false};
+      return s;
+    }
+
+    // Give the free blocks of a thread back to the shared list when
+    // the thread terminates.
+    struct local_guard {
+      ~local_guard () {
+        local_state& l = local ();
+        l.m_exited = true;
+        if (l.m_free) {
+          block* last = l.m_free;
+          while (last->m_next) last = last->m_next;
+          shared_state& s = shared ();
+          std::lock_guard<std::mutex> lock (s.m_mutex);
+          last->m_next = s.m_free;
+          s.m_free = l.m_free;
+          l.m_free = nullptr;
+        }
+      }
+    };
+
+    static void refill (local_state& l) {
+      static thread_local local_guard guard;
+      (void) guard;
+      shared_state& s = shared ();
+      std::lock_guard<std::mutex> lock (s.m_mutex);
+      if (s.m_free) {
+        l.m_free = s.m_free;
+        s.m_free = nullptr;
+        return;
+      }
+      char* chunk = static_cast<char*> (std::malloc (block_size * blocks_per_chunk));
+      if (!chunk) throw std::bad_alloc ();
+      for (std::size_t i = blocks_per_chunk; i-- > 0; ) {
+        block* b = reinterpret_cast<block*> (chunk + i * block_size);
+        b->m_next = l.m_free;
+        l.m_free = b;
+      }
+    }
+
+   public:
+
+    static void* allocate () {
+      local_state& l = local ();
+      if (l.m_exited) {
+        // the thread is terminating
+        return ::operator new (block_size);
+      }
+      if (!l.m_free) refill (l);
+      block* b = l.m_free;
+      l.m_free = b->m_next;
+      return b;
+    }
+
+    static void deallocate (void* p) {
+      if (!p) return;
+      block* b = static_cast<block*> (p);
+      local_state& l = local ();
+      if (l.m_exited) {
+        shared_state& s = shared ();
+        std::lock_guard<std::mutex> lock (s.m_mutex);
+        b->m_next = s.m_free;
+        s.m_free = b;
+        return;
+      }
+      b->m_next = l.m_free;
+      l.m_free = b;
+    }
+  };
+
+} // end namespace crab
+
+#endif
@@ -3,9 +3,13 @@
 
 /* Code from SeaHorn */
 
+#include <atomic>
 #include <map>
-#include <sys/time.h>
-#include <sys/resource.h>
+#include <string>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include <crab/config.h>
 #include <crab/common/types.hpp>
@@ -14,6 +18,27 @@ namespace crab
 {
 
 #ifdef HAVE_STATS
+  // Monotonic clock in nanoseconds. It is read through the vDSO so it
+  // does not enter the kernel.
+  inline long long stats_clock_ns ()
+  {
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  }
+
+  // Timestamp used by the timers of CrabStats: the time stamp counter
+  // on x86 (converted to time when the statistics are read) and the
+  // monotonic clock elsewhere.
+  inline long long stats_ticks ()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc ();
+#else
+    return stats_clock_ns ();
+#endif
+  }
+
   class Stopwatch
   {
   private:
@@ -23,11 +48,7 @@ namespace crab
 
     long systemTime () const
     {
-      struct rusage ru;
-      getrusage (RUSAGE_SELF, &ru);
-      long r = ru.ru_utime.tv_sec * 1000000L + ru.ru_utime.tv_usec;
-      return r;
-
+      return stats_clock_ns () / 1000;
     }
 
   public:
@@ -68,6 +89,9 @@ namespace crab
 
     void Print (crab_os &out) const;
 
+    // Print a time given in microseconds
+    static void Print (crab_os &out, long time);
+
     double toSeconds(){
       double time = ((double) getTimeElapsed () / 1000000) ;
       return time;
@@ -136,29 +160,116 @@ namespace crab
     return OS;
   }
 
+  // Handle of an interned counter or timer name
+  struct stats_counter { unsigned m_id; };
+  struct stats_timer { unsigned m_id; };
+
+  namespace stats_impl {
+
+    const unsigned block_size = 256;
+    const unsigned max_blocks = 256;
+
+    struct timer_slot {
+      std::atomic<long long> m_elapsed; // in ticks
+      long long m_started;
+      bool m_running;
+      std::atomic<bool> m_used;
+    };
+
+    // Statistics updated by one thread. Only the owner thread writes
+    // to a shard so updates are plain loads and stores. Shards are
+    // merged when the statistics are read.
+    //
+    // Slots are allocated in blocks so that they never move while
+    // another thread reads them.
+    class shard {
+      std::atomic<std::atomic<unsigned long long>*> m_counters [max_blocks];
+      std::atomic<timer_slot*> m_timers [max_blocks];
+
+      std::atomic<unsigned long long>* new_counters (unsigned b);
+      timer_slot* new_timers (unsigned b);
+
+     public:
+      shard ();
+      ~shard ();
+
+      std::atomic<unsigned long long>& counter (unsigned id) {
+        auto c = m_counters [id / block_size].load (std::memory_order_relaxed);
+        if (!c) c = new_counters (id / block_size);
+        return c [id % block_size];
+      }
+
+      timer_slot& timer (unsigned id) {
+        auto t = m_timers [id / block_size].load (std::memory_order_relaxed);
+        if (!t) t = new_timers (id / block_size);
+        return t [id % block_size];
+      }
+
+      // for readers other than the owner thread
+      unsigned long long read_counter (unsigned id) const;
+      const timer_slot* read_timer (unsigned id) const;
+      void clear ();
+    };
+  } // end namespace stats_impl
+
   class CrabStats
   {
   private:
-    static std::map<std::string,unsigned> counters;
-    static std::map<std::string,Stopwatch> sw;
     static std::map<std::string,Averager> av;
     static std::map<std::string,std::string> ss;
 
+    static thread_local stats_impl::shard* s_local;
+    static stats_impl::shard& new_shard ();
+
+    static stats_impl::shard& local () {
+      return s_local ? *s_local : new_shard ();
+    }
+
   public:
+    //! Return the handle of a name. Use it to avoid building and
+    //! looking up the name on every update.
+    static stats_counter counter (const std::string &n);
+    static stats_timer timer (const std::string &n);
+
     static void reset();
     static unsigned  get (const std::string &n);
+    static unsigned  get (stats_counter c);
     static double avg (const std::string &n, double v);
     static unsigned uset (const std::string &n, unsigned v);
 
     static void sset (const std::string &n, std::string v);
     static std::string& sget (const std::string &n);
     
-    static void count (const std::string &name);
+    static void count (const std::string &name) { count (counter (name)); }
+    static void count (stats_counter c) {
+      auto &v = local ().counter (c.m_id);
+      v.store (v.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
     static void count_max (const std::string &name, unsigned v);
 
-    static void start (const std::string &name);
-    static void stop (const std::string &name);
-    static void resume (const std::string &name);
+    static void start (const std::string &name) { start (timer (name)); }
+    static void stop (const std::string &name) { stop (timer (name)); }
+    static void resume (const std::string &name) { resume (timer (name)); }
+    //! Only the time measured by the calling thread is reset
+    static void start (stats_timer t);
+    static void stop (stats_timer t) {
+      auto &s = local ().timer (t.m_id);
+      if (s.m_running) {
+        s.m_elapsed.store (s.m_elapsed.load (std::memory_order_relaxed) +
+                           stats_ticks () - s.m_started,
+                           std::memory_order_relaxed);
+        s.m_running = false;
+      }
+    }
+    static void resume (stats_timer t) {
+      auto &s = local ().timer (t.m_id);
+      if (!s.m_running) {
+        s.m_started = stats_ticks ();
+        s.m_running = true;
+        if (!s.m_used.load (std::memory_order_relaxed))
+          s.m_used.store (true, std::memory_order_relaxed);
+      }
+    }
 
     /** Outputs all statistics to std output */
     static void Print (crab_os &OS);
@@ -204,36 +315,49 @@ namespace crab
   
   class ScopedCrabStats 
   {
-    std::string m_name;
+    stats_timer m_timer;
   public:
-    ScopedCrabStats (const std::string &name, bool reset = false) : m_name(name) 
+    ScopedCrabStats (const std::string &name, bool reset = false)
     { 
       if (reset) 
         { 
-          m_name += ".last";
-          CrabStats::start (m_name);
+          m_timer = CrabStats::timer (name + ".last");
+          CrabStats::start (m_timer);
         }
       else
-        CrabStats::resume (m_name); 
+        {
+          m_timer = CrabStats::timer (name);
+          CrabStats::resume (m_timer); 
+        }
     }
-    ~ScopedCrabStats () { CrabStats::stop (m_name); }
+    ScopedCrabStats (stats_timer t) : m_timer (t) { CrabStats::resume (m_timer); }
+    ~ScopedCrabStats () { CrabStats::stop (m_timer); }
   };  
 #else
   inline crab_os &operator<< (crab_os &OS, const Stopwatch &sw){ return OS;}
   inline crab_os &operator<< (crab_os &OS, const Averager &av){ return OS;}
+  struct stats_counter { };
+  struct stats_timer { };
   struct CrabStats
   {
+    static stats_counter counter (const std::string &n) { return stats_counter (); }
+    static stats_timer timer (const std::string &n) { return stats_timer (); }
     static unsigned  get (const std::string &n){ return 0;}
+    static unsigned  get (stats_counter c){ return 0;}
     static double avg (const std::string &n, double v){ return 0.0;}
     static unsigned uset (const std::string &n, unsigned v){return 0;}
     static void sset (const std::string &n, std::string v){}
     static std::string& sget (const std::string &n)
     { CRAB_ERROR("Stats::sget not implemented");}
     static void count (const std::string &name){}
+    static void count (stats_counter c){}
     static void count_max (const std::string &name, unsigned v){}
     static void start (const std::string &name){}
     static void stop (const std::string &name){}
     static void resume (const std::string &name){}
+    static void start (stats_timer t){}
+    static void stop (stats_timer t){}
+    static void resume (stats_timer t){}
     static void Print (crab_os &OS){}
     static void PrintBrunch (crab_os &OS){}
   };
@@ -245,10 +369,31 @@ namespace crab
   struct ScopedCrabStats 
   {
     ScopedCrabStats (const std::string &name, bool reset = false) {}
+    ScopedCrabStats (stats_timer t) {}
   };  
 #endif 
 }
 
+/*
+   Count or time a block of code under a name that is interned the
+   first time the call site is executed (once per template
+   instantiation). The name expression must always yield the same
+   value at a given call site, e.g. getDomainName () + ".join".
+*/
+#ifdef HAVE_STATS
+#define CRAB_STATS_COUNT(NAME)                                          \
+  do {                                                                  \
+    static const crab::stats_counter __cnt__ = crab::CrabStats::counter (NAME); \
+    crab::CrabStats::count (__cnt__);                                   \
+  } while (0)
+#define CRAB_STATS_SCOPE(NAME)                                          \
+  static const crab::stats_timer __st_timer__ = crab::CrabStats::timer (NAME); \
+  crab::ScopedCrabStats __st__ (__st_timer__)
+#else
+#define CRAB_STATS_COUNT(NAME) do { } while (0)
+#define CRAB_STATS_SCOPE(NAME) do { } while (0)
+#endif
+
 #define CRAB_MEASURE_FN crab::ScopedCrabStats __stats__(__FUNCTION__)
 #define CRAB_MEASURE_FN_LAST crab::ScopedCrabStats __stats_last__(__FUNCTION__, true)
 
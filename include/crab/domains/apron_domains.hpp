@@ -7,6 +7,7 @@
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
 #include <crab/common/types.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/domains/operators_api.hpp>
 #include <crab/domains/domain_traits.hpp>
 
@@ -175,22 +176,29 @@ namespace crab {
         typedef boost::bimap< VariableName , ap_dim_t > var_map_t;
         typedef typename var_map_t::value_type binding_t;
 
-        static ap_manager_t* m_apman;
+        // One apron manager per analysis context since managers are
+        // not thread-safe.
+        struct apron_man {
+          ap_manager_t* m_apman;
+          apron_man (): m_apman (nullptr) { }
+          ~apron_man () { if (m_apman) ap_manager_free (m_apman); }
+        };
         
         ap_state_ptr m_apstate; 
         var_map_t m_var_map;
 
         static ap_manager_t* get_man () {
-          if (!m_apman) {
+          ap_manager_t* &apman = analysis_context::current ().get<apron_man> ().m_apman;
+          if (!apman) {
             switch (ApronDom) {
-              case APRON_INT: m_apman = box_manager_alloc (); break;
-              case APRON_OCT: m_apman = oct_manager_alloc (); break;
-              case (APRON_OPT_OCT): m_apman = opt_oct_manager_alloc (); break;
-              case APRON_PK: m_apman = pk_manager_alloc (false); break;
+              case APRON_INT: apman = box_manager_alloc (); break;
+              case APRON_OCT: apman = oct_manager_alloc (); break;
+              case (APRON_OPT_OCT): apman = opt_oct_manager_alloc (); break;
+              case APRON_PK: apman = pk_manager_alloc (false); break;
               default: CRAB_ERROR("ERROR: unknown apron domain");
             }
           }
-          return m_apman;
+          return apman;
         }
 
         size_t get_dims (ap_state_ptr s) const {
@@ -680,8 +688,8 @@ namespace crab {
             m_apstate (apPtr (get_man (), ap_abstract0_copy (get_man (), &*(o.m_apstate)))),
             m_var_map (o.m_var_map)
         {  
-          crab::CrabStats::count (getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
         }
 
         apron_domain_ (apron_domain_t&& o): 
@@ -690,8 +698,8 @@ namespace crab {
             m_var_map (std::move (o.m_var_map)) { }
         
         apron_domain_t& operator=(const apron_domain_t& o) {
-          crab::CrabStats::count (getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
           if (this != &o) {
             m_apstate = o.m_apstate;
             m_var_map = o.m_var_map;
@@ -724,8 +732,8 @@ namespace crab {
         }
 
         bool operator<=(apron_domain_t o) { 
-          crab::CrabStats::count (getDomainName() + ".count.leq");
-          crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+          CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+          CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
           if (is_bottom()) 
             return true;
@@ -745,8 +753,8 @@ namespace crab {
         }
 
         void operator|=(apron_domain_t o) {
-          crab::CrabStats::count (getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          CRAB_STATS_COUNT (getDomainName() + ".count.join");
+          CRAB_STATS_SCOPE (getDomainName() + ".join");
 
           if (is_bottom() || o.is_top ())
             *this = o;
@@ -761,8 +769,8 @@ namespace crab {
         }
         
         apron_domain_t operator|(apron_domain_t o) {
-          crab::CrabStats::count (getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          CRAB_STATS_COUNT (getDomainName() + ".count.join");
+          CRAB_STATS_SCOPE (getDomainName() + ".join");
 
           if (is_bottom() || o.is_top ())
             return o;
@@ -778,8 +786,8 @@ namespace crab {
         }        
         
         apron_domain_t operator&(apron_domain_t o) {
-          crab::CrabStats::count (getDomainName() + ".count.meet");
-          crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+          CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+          CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
           if (is_bottom() || o.is_bottom())
             return bottom();
@@ -797,8 +805,8 @@ namespace crab {
         }        
         
         apron_domain_t operator||(apron_domain_t o) {
-          crab::CrabStats::count (getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+          CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
           if (is_bottom())
             return o;
@@ -822,8 +830,8 @@ namespace crab {
 	
         template<typename Thresholds>
         apron_domain_t widening_thresholds (apron_domain_t o, const Thresholds &ts) {
-          crab::CrabStats::count (getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+          CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
           if (is_bottom())
             return o;
@@ -859,8 +867,8 @@ namespace crab {
         }
 
         apron_domain_t operator&&(apron_domain_t o) {
-          crab::CrabStats::count (getDomainName() + ".count.narrowing");
-          crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+          CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+          CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
           if (is_bottom() || o.is_bottom())
             return bottom();
@@ -894,8 +902,8 @@ namespace crab {
 
         template<typename Range>
         void forget (const Range &vars) {
-          crab::CrabStats::count (getDomainName() + ".count.forget");
-          crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+          CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+          CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
           std::vector<ap_dim_t> vector_dims;
           std::set<ap_dim_t> set_dims;
@@ -959,8 +967,8 @@ namespace crab {
         // remove all variables except vars
         template<typename Range>
         void project (const Range& vars) {
-          crab::CrabStats::count (getDomainName() + ".count.project");
-          crab::ScopedCrabStats __st__(getDomainName() + ".project");
+          CRAB_STATS_COUNT (getDomainName() + ".count.project");
+          CRAB_STATS_SCOPE (getDomainName() + ".project");
 
           if (is_bottom ()) return;
           std::set<VariableName> s1,s2,s3;
@@ -971,8 +979,8 @@ namespace crab {
         }
 
         interval_t operator[](VariableName v) {
-          crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-          crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+          CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+          CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
           if (is_bottom ()) 
             return interval_t::bottom ();
@@ -1050,8 +1058,8 @@ namespace crab {
         }
 
         void set(VariableName v, interval_t ival) {
-          crab::CrabStats::count (getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
           // -- forget v
           *this -= v;
@@ -1078,8 +1086,8 @@ namespace crab {
         }
 
         void operator += (linear_constraint_system_t csts) {
-          crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-          crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+          CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+          CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
           if(is_bottom()) return;
 
@@ -1118,8 +1126,8 @@ namespace crab {
         }
        
         void assign (VariableName x, linear_expression_t e) {
-          crab::CrabStats::count (getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
           if(is_bottom()) return;
 
@@ -1137,8 +1145,8 @@ namespace crab {
         }
           
         void apply (operation_t op, VariableName x, VariableName y, Number z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if(is_bottom()) return;
 
@@ -1166,8 +1174,8 @@ namespace crab {
         }
         
         void apply(operation_t op, VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if(is_bottom()) return;
 
@@ -1195,8 +1203,8 @@ namespace crab {
         }
         
         void apply(operation_t op, VariableName x, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if(is_bottom()) return;
 
@@ -1236,8 +1244,8 @@ namespace crab {
         }
         
         void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           // Convert to intervals and perform the operation
           interval_t yi = operator[](y);
@@ -1256,8 +1264,8 @@ namespace crab {
         }
         
         void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           // Convert to intervals and perform the operation
           interval_t yi = operator[](y);
@@ -1276,8 +1284,8 @@ namespace crab {
         }
         
         void apply(div_operation_t op, VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (op == OP_SDIV){
             apply(OP_DIVISION, x, y, z);
@@ -1299,8 +1307,8 @@ namespace crab {
         }
         
         void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (op == OP_SDIV){
             apply(OP_DIVISION, x, y, k);
@@ -1553,10 +1561,6 @@ namespace crab {
       };
        #endif
      
-      // --- global datastructures
-      template<typename N, typename V, apron_domain_id_t D>
-      ap_manager_t* apron_domain_<N,V,D>::m_apman = nullptr;
-
    
    } // namespace domains
 }// namespace crab
@@ -99,13 +99,13 @@ namespace crab {
         array_smashing (const array_smashing_t& other): 
             ikos::writeable(), 
             _inv (other._inv) { 
-          crab::CrabStats::count (getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
         }
         
         array_smashing_t& operator=(const array_smashing_t& other) {
-          crab::CrabStats::count (getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
           if (this != &other)
             _inv = other._inv;
           return *this;
@@ -288,8 +288,8 @@ namespace crab {
         virtual void array_load (VariableName lhs, VariableName a, crab::variable_type a_ty,
                                  linear_expression_t i, z_number /*bytes*/) override {
 
-          crab::CrabStats::count (getDomainName() + ".count.load");
-          crab::ScopedCrabStats __st__(getDomainName() + ".load");
+          CRAB_STATS_COUNT (getDomainName() + ".count.load");
+          CRAB_STATS_SCOPE (getDomainName() + ".load");
           
           // We need to be careful when assigning a summarized variable a
           // into a non-summarized variable lhs. Simply _inv.assign (lhs,
@@ -313,8 +313,8 @@ namespace crab {
                                   z_number /*bytes*/, bool is_singleton) override {
                                   
 
-          crab::CrabStats::count (getDomainName() + ".count.store");
-          crab::ScopedCrabStats __st__(getDomainName() + ".store");
+          CRAB_STATS_COUNT (getDomainName() + ".count.store");
+          CRAB_STATS_SCOPE (getDomainName() + ".store");
           
           if (is_singleton)
             strong_update (a, a_ty, val);
@@ -37,6 +37,7 @@
 #include <crab/common/types.hpp>
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/domains/operators_api.hpp>
 #include <crab/domains/domain_traits.hpp>
 #include <crab/domains/array_sparse_graph/array_segmentation.hpp>
@@ -1299,10 +1300,16 @@ namespace crab {
       // an array index. In addition, for each landmark l we keep
       // track of a prime landmark l' whose meaning is l'=l+1.
 
-      /// === Static data
+      /// === Data shared by all the values of the same analysis context
       typedef boost::unordered_map<landmark_ref_t,landmark_ref_t> lm_map_t;
-      static lm_map_t var_landmarks;
-      static lm_map_t cst_landmarks;
+      struct landmarks_t {
+        lm_map_t m_var;
+        lm_map_t m_cst;
+      };
+      static landmarks_t& get_landmarks ()
+      { return analysis_context::current ().get<landmarks_t> (); }
+      static lm_map_t& var_landmarks () { return get_landmarks ().m_var; }
+      static lm_map_t& cst_landmarks () { return get_landmarks ().m_cst; }
 
       // --- landmark iterators
       struct get_first : public std::unary_function<typename lm_map_t::value_type,
@@ -1325,16 +1332,16 @@ namespace crab {
       typedef boost::iterator_range<lm_prime_iterator> lm_prime_range;
 
       lm_prime_iterator var_lm_prime_begin()
-      { return boost::make_transform_iterator(var_landmarks.begin(), get_second());}
+      { return boost::make_transform_iterator(var_landmarks ().begin(), get_second());}
       lm_prime_iterator var_lm_prime_end()
-      { return boost::make_transform_iterator(var_landmarks.end(), get_second());}
+      { return boost::make_transform_iterator(var_landmarks ().end(), get_second());}
       lm_prime_range var_lm_primes() 
       { return boost::make_iterator_range(var_lm_prime_begin(), var_lm_prime_end());}
 
       lm_prime_iterator cst_lm_prime_begin()
-      { return boost::make_transform_iterator(cst_landmarks.begin(), get_second());}
+      { return boost::make_transform_iterator(cst_landmarks ().begin(), get_second());}
       lm_prime_iterator cst_lm_prime_end()
-      { return boost::make_transform_iterator(cst_landmarks.end(), get_second());}
+      { return boost::make_transform_iterator(cst_landmarks ().end(), get_second());}
       lm_prime_range cst_lm_primes() 
       { return boost::make_iterator_range(cst_lm_prime_begin(), cst_lm_prime_end());}
                                           
@@ -1387,8 +1394,8 @@ namespace crab {
       template<class Range, class VarFactory>
       static void set_landmarks(const Range& lms, VarFactory& vfac) {
         
-        var_landmarks.clear();
-        cst_landmarks.clear();
+        var_landmarks ().clear();
+        cst_landmarks ().clear();
         
         unsigned num_vl = 0;
         unsigned num_cl = 0;
@@ -1399,7 +1406,7 @@ namespace crab {
               auto v = boost::static_pointer_cast<const landmark_var_t>(lm._ref)->get_var();
               varname_t v_prime = vfac.get(v.index());
               landmark_ref_t lm_prime(v_prime, v.str());
-              var_landmarks.insert(std::make_pair(lm, lm_prime));
+              var_landmarks ().insert(std::make_pair(lm, lm_prime));
               num_vl++;
               break;
             }
@@ -1407,7 +1414,7 @@ namespace crab {
               auto n = boost::static_pointer_cast<const landmark_cst_t>(lm._ref)->get_cst();
               varname_t v_prime = vfac.get(); 
               landmark_ref_t lm_prime(v_prime, n.get_str());
-              cst_landmarks.insert(std::make_pair(lm, lm_prime));
+              cst_landmarks ().insert(std::make_pair(lm, lm_prime));
               num_cl++;
               break;
             }
@@ -1419,12 +1426,12 @@ namespace crab {
                  crab::outs() << "Added " << num_vl << " variable landmarks "
                               << "and " << num_cl << " constant landmarks={";
                  bool first=true;
-                 for (auto &l: var_landmarks) {
+                 for (auto &l: var_landmarks ()) {
                    if (!first) crab::outs() << ",";
                    first=false;
                    crab::outs() << l.first;
                  }
-                  for (auto &l: cst_landmarks) {
+                  for (auto &l: cst_landmarks ()) {
                    if (!first) crab::outs() << ",";
                    first=false;
                    crab::outs() << l.first;
@@ -1440,7 +1447,7 @@ namespace crab {
         landmark_ref_t lm_v (v);
         landmark_ref_t lm_v_prime(v.get_var_factory().get(v.index()), v.str());
         // add pair  x -> x'
-        var_landmarks.insert(std::make_pair(lm_v, lm_v_prime));
+        var_landmarks ().insert(std::make_pair(lm_v, lm_v_prime));
         // x' = x + 1
         _scalar += make_prime_relation(lm_v_prime, lm_v);
 
@@ -1462,7 +1469,7 @@ namespace crab {
       void remove_landmark(VariableName v) {
         array_forget (v);
         forget_prime_var (v);
-        var_landmarks.erase (landmark_ref_t (v));
+        var_landmarks ().erase (landmark_ref_t (v));
 
         CRAB_LOG("array-sgraph-domain-landmark", 
                  crab::outs () << "Removed landmark " << v << "\n";);
@@ -1474,15 +1481,15 @@ namespace crab {
       // By active we mean current variables that are kept track by
       // the scalar domain.
       void get_active_landmarks(NumDom &scalar, std::vector<landmark_ref_t> & landmarks) const {
-        landmarks.reserve(cst_landmarks.size());
-        for (auto p: cst_landmarks) { 
+        landmarks.reserve(cst_landmarks ().size());
+        for (auto p: cst_landmarks ()) { 
           landmarks.push_back (p.first);
           landmarks.push_back (p.second);
         }
         auto active_vars = array_sgraph_domain_traits<NumDom>::active_variables(scalar);        
         for (auto v: active_vars) {
-          auto it = var_landmarks.find(landmark_ref_t(v));
-          if (it != var_landmarks.end()){
+          auto it = var_landmarks ().find(landmark_ref_t(v));
+          if (it != var_landmarks ().end()){
             landmarks.push_back(landmark_ref_t(v)); 
             landmarks.push_back(it->second);
           }
@@ -1532,22 +1539,22 @@ namespace crab {
       // return true if v is a landmark in the graph
       bool is_landmark (VariableName v) const {
         landmark_ref_t lm_v (v);       
-        auto it = var_landmarks.find(lm_v);
-        return (it != var_landmarks.end());
+        auto it = var_landmarks ().find(lm_v);
+        return (it != var_landmarks ().end());
       }
 
       // return true if n is a landmark in the graph
       bool is_landmark (z_number n) const {
         landmark_ref_t lm_n (n);       
-        auto it = cst_landmarks.find(lm_n);
-        return (it != cst_landmarks.end());
+        auto it = cst_landmarks ().find(lm_n);
+        return (it != cst_landmarks ().end());
       }
 
       // return the prime landmark of v
       landmark_ref_t get_landmark_prime (VariableName v) const {
         landmark_ref_t lm_v (v);
-        auto it = var_landmarks.find(lm_v);
-        assert (it != var_landmarks.end());
+        auto it = var_landmarks ().find(lm_v);
+        assert (it != var_landmarks ().end());
         return it->second;
       }
 
@@ -1651,7 +1658,7 @@ namespace crab {
         VariableName x_old_prime = x.get_var_factory().get(); 
         landmark_ref_t lm_x_old (x_old);
         landmark_ref_t lm_x_old_prime (x_old_prime, x_old.str());
-        var_landmarks.insert(std::make_pair(lm_x_old, lm_x_old_prime));
+        var_landmarks ().insert(std::make_pair(lm_x_old, lm_x_old_prime));
         // x_old = x
         _scalar.assign(x_old, linear_expression_t(x)); 
         // relation between x_old and x' 
@@ -1697,7 +1704,7 @@ namespace crab {
         _g -= lm_x_old_prime;
         _scalar -= x_old;
         _scalar -= x_old_prime;
-        var_landmarks.erase(lm_x_old);
+        var_landmarks ().erase(lm_x_old);
       }
 
       // remove v' from scalar and array graph
@@ -1785,8 +1792,8 @@ namespace crab {
       // whenever an edge becomes bottom closure is also happening.
       // Return false if bottom is detected during the reduction.
       bool reduce(NumDom &scalar, array_sgraph_t &g) {
-        crab::CrabStats::count (getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        CRAB_STATS_COUNT (getDomainName() + ".count.reduce");
+        CRAB_STATS_SCOPE (getDomainName() + ".reduce");
 
         domain_traits<NumDom>::normalize(scalar);
         g.normalize();
@@ -1847,8 +1854,8 @@ namespace crab {
 
       array_sparse_graph_domain(const array_sgraph_domain_t&o)
           : _scalar(o._scalar), _expressions (o._expressions), _g(o._g) { 
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
       }
 
       array_sparse_graph_domain(array_sgraph_domain_t &&o)
@@ -1858,8 +1865,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t& operator=(const array_sgraph_domain_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
         if(this != &o) {
           _scalar = o._scalar;
           _expressions = o._expressions;
@@ -1884,8 +1891,8 @@ namespace crab {
       }
 
       bool operator<=(array_sgraph_domain_t &o) {
-        crab::CrabStats::count (getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+        CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs () << "Leq " << *this << " and\n"  << o << "=\n";);
@@ -1901,8 +1908,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator|(array_sgraph_domain_t &o){
-        crab::CrabStats::count (getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        CRAB_STATS_COUNT (getDomainName() + ".count.join");
+        CRAB_STATS_SCOPE (getDomainName() + ".join");
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs () << "Join " << *this << " and "  << o << "=\n");
@@ -1916,8 +1923,8 @@ namespace crab {
       template<typename Thresholds>
       array_sgraph_domain_t widening_thresholds (array_sgraph_domain_t& o, 
                                                  const Thresholds & ts) {
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
           CRAB_LOG("array-sgraph-domain",
                    crab::outs () << "Widening (w/ thresholds) " << *this << " and "
@@ -1936,8 +1943,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator||(array_sgraph_domain_t &o){
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs () << "Widening " << *this << " and "  << o << "=\n");        
@@ -1955,8 +1962,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator&(array_sgraph_domain_t &o){
-        crab::CrabStats::count (getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+        CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs () << "Meet " << *this << " and "  << o << "=\n");
@@ -1974,8 +1981,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator&&(array_sgraph_domain_t &o){
-        crab::CrabStats::count (getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+        CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs () << "Narrowing " << *this << " and "  << o << "=\n");
@@ -1993,8 +2000,8 @@ namespace crab {
       }
 
       void operator-=(VariableName v) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+        CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
         if (is_bottom())
           return;
@@ -2015,8 +2022,8 @@ namespace crab {
       // remove all variables except [vIt,...vEt)
       template<typename Iterator>
       void project (Iterator vIt, Iterator vEt) {
-        crab::CrabStats::count (getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        CRAB_STATS_COUNT (getDomainName() + ".count.project");
+        CRAB_STATS_SCOPE (getDomainName() + ".project");
 
         if (is_bottom ()) return;
         if (vIt == vEt) return;
@@ -2038,8 +2045,8 @@ namespace crab {
 
       void operator+=(linear_constraint_system_t csts) 
       {
-        crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+        CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
         if (is_bottom()) return;
         
@@ -2065,8 +2072,8 @@ namespace crab {
       // assignments should be managed by the apply methods instead.
       void assign (VariableName x, linear_expression_t e, bool update_expressions) 
       {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
         if (is_bottom()) return;
 
@@ -2101,8 +2108,8 @@ namespace crab {
 
       void apply (operation_t op, VariableName x, VariableName y, Number z) {
         if (x == y) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
           _expressions.apply (op, x, y, z);
           apply_one_variable<Number> (op, x, z);
           CRAB_LOG("array-sgraph-domain",
@@ -2126,8 +2133,8 @@ namespace crab {
       
       void apply(operation_t op, VariableName x, VariableName y, VariableName z)  {
         if (x==y) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
           _expressions.apply (op, x, y, z);
           apply_one_variable<VariableName> (op, x, z);
           CRAB_LOG("array-sgraph-domain", 
@@ -2150,8 +2157,8 @@ namespace crab {
       }
 
       void apply(operation_t op, VariableName x, Number k)  {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
         _expressions.apply (op, x, k);
         apply_one_variable <Number> (op, x, k);
 
@@ -2174,8 +2181,8 @@ namespace crab {
 
       // bitwise_operators_api      
       void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         _expressions.apply (op, x, y, z);
         // XXX: we give up soundly in the graph domain
@@ -2183,8 +2190,8 @@ namespace crab {
       }
       
       void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         _expressions.apply (op, x, y, k);
         // XXX: we give up soundly in the graph domain
@@ -2193,8 +2200,8 @@ namespace crab {
       
       // division_operators_api
       void apply(div_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         _expressions.apply (op, x, y, z);
         // XXX: we give up soundly in the graph domain
@@ -2202,8 +2209,8 @@ namespace crab {
       }
       
       void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         _expressions.apply (op, x, y, k);
         // XXX: we give up soundly in the graph domain
@@ -2274,8 +2281,8 @@ namespace crab {
                                linear_expression_t i, z_number nbytes) override 
       {
 
-        crab::CrabStats::count (getDomainName() + ".count.load");
-        crab::ScopedCrabStats __st__(getDomainName() + ".load");
+        CRAB_STATS_COUNT (getDomainName() + ".count.load");
+        CRAB_STATS_SCOPE (getDomainName() + ".load");
 
         auto vi = i.get_variable ();
         if (!vi) {
@@ -2332,8 +2339,8 @@ namespace crab {
       virtual void array_store (VariableName a, crab::variable_type a_ty,
                                 linear_expression_t i, VariableName val, 
                                 z_number nbytes, bool /*is_singleton*/) override {
-        crab::CrabStats::count (getDomainName() + ".count.store");
-        crab::ScopedCrabStats __st__(getDomainName() + ".store");
+        CRAB_STATS_COUNT (getDomainName() + ".count.store");
+        CRAB_STATS_SCOPE (getDomainName() + ".store");
 
         auto vi = i.get_variable ();
         if (!vi) {
@@ -2460,17 +2467,6 @@ namespace crab {
       }
     };
   
-    // Static data allocation
-    template<class Dom, class Wt, bool IsDistWt>
-    boost::unordered_map<landmark_ref<typename Dom::varname_t, typename Dom::number_t>, 
-                         landmark_ref<typename Dom::varname_t, typename Dom::number_t> > 
-    array_sparse_graph_domain<Dom,Wt,IsDistWt>::var_landmarks;
-
-    template<class Dom, class Wt, bool IsDistWt>
-    boost::unordered_map<landmark_ref<typename Dom::varname_t, typename Dom::number_t>, 
-                         landmark_ref<typename Dom::varname_t, typename Dom::number_t> > 
-    array_sparse_graph_domain<Dom,Wt,IsDistWt>::cst_landmarks;
-
   } // end namespace domains
  
 } // end namespace crab
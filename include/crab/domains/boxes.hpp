@@ -11,6 +11,7 @@
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
 #include <crab/common/types.hpp>
+#include <crab/common/analysis_context.hpp>
 #include <crab/domains/operators_api.hpp>
 
 #ifndef HAVE_LDD
@@ -196,21 +197,45 @@ namespace crab {
         typedef boost::bimap< VariableName , int > var_map_t;
         typedef typename var_map_t::value_type binding_t;
 
+        // The ldd manager and the variable map are shared by all the
+        // boxes of the same analysis context. The manager is not
+        // thread-safe so concurrent analyses must use different
+        // contexts.
+        struct ldd_state {
+          LddManager* m_ldd_man;
+          var_map_t m_var_map;
+
+          ldd_state (): m_ldd_man (nullptr) { }
+
+          ~ldd_state () {
+            if (m_ldd_man) {
+              DdManager* cudd = Ldd_GetCudd (m_ldd_man);
+              theory_t* theory = Ldd_GetTheory (m_ldd_man);
+              Ldd_Quit (m_ldd_man);
+              tvpi_destroy_theory (theory);
+              Cudd_Quit (cudd);
+            }
+          }
+        };
+
         LddNodePtr m_ldd;
-        static LddManager* m_ldd_man;
-        static var_map_t m_var_map;
+
+        static ldd_state& get_state () {
+          return analysis_context::current ().get<ldd_state> ();
+        }
 
         static LddManager* get_ldd_man () {
-          if (!m_ldd_man) {
+          ldd_state &st = get_state ();
+          if (!st.m_ldd_man) {
             DdManager* cudd = Cudd_Init (0, 0, CUDD_UNIQUE_SLOTS, 127, 0);
             theory_t* theory = ldd::create_box_theory<Number> (LddSize);
             CRAB_LOG ("boxes",
 		      crab::outs() << "Created a ldd of size " << LddSize <<"\n";);
-            m_ldd_man = Ldd_Init (cudd, theory);
+            st.m_ldd_man = Ldd_Init (cudd, theory);
             //Cudd_AutodynEnable (cudd, CUDD_REORDER_GROUP_SIFT);
-	    Ldd_SanityCheck (get_ldd_man ());
+	    Ldd_SanityCheck (st.m_ldd_man);
           }
-          return m_ldd_man;
+          return st.m_ldd_man;
         }
 
 	inline theory_t* get_theory () {
@@ -218,20 +243,21 @@ namespace crab {
 	}
 	
         static int num_of_vars () {
-          return m_var_map.left.size ();
+          return get_state ().m_var_map.left.size ();
         }
 
         int get_var_dim (VariableName v) const {
-          auto it = m_var_map.left.find (v);
-          if (it != m_var_map.left.end ()) {
+          var_map_t &var_map = get_state ().m_var_map;
+          auto it = var_map.left.find (v);
+          if (it != var_map.left.end ()) {
             return it->second;
           } else {
 	    // XXX: reserved dim 0 for SPECIAL variable
-            unsigned int id = m_var_map.size () + 1;
+            unsigned int id = var_map.size () + 1;
             if (id >= LddSize) {
               CRAB_ERROR ("The Ldd size of ", LddSize, " needs to be larger");
             }
-            m_var_map.insert (binding_t (v, id));
+            var_map.insert (binding_t (v, id));
             return id;
           }
         }
@@ -263,7 +289,7 @@ namespace crab {
           std::vector<int> qvars;
 	  // num_of_vars is shared by all ldd's
 	  qvars.reserve (num_of_vars()-1); 
-          for (auto p: m_var_map.left) 
+          for (auto p: get_state ().m_var_map.left) 
             if (!(p.first == v))
 	      qvars.push_back (get_var_dim (p.first));
 	    
@@ -318,8 +344,8 @@ namespace crab {
 	  if (!x) {
 	    // XXX: if we copy the SPECIAL var to v we forget the SPECIAL
 	    //      var after we copy.
-	    crab::CrabStats::count (getDomainName() + ".count.forget");
-	    crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+	    CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+	    CRAB_STATS_SCOPE (getDomainName() + ".forget");
 	    int dim = 0; // SPECIAL variable is dim 0
 	    m_ldd =  lddPtr (get_ldd_man(), 
 			     Ldd_ExistsAbstract (get_ldd_man(), &*m_ldd, dim));
@@ -741,8 +767,9 @@ namespace crab {
         }
 
         VariableName getVarName (int v) const {
-          auto it = m_var_map.right.find (v);
-          if (it != m_var_map.right.end ())
+          var_map_t &var_map = get_state ().m_var_map;
+          auto it = var_map.right.find (v);
+          if (it != var_map.right.end ())
              return it->second;
           else {
              CRAB_ERROR ("Index ", v, " cannot be mapped back to a variable name");
@@ -756,18 +783,6 @@ namespace crab {
 	  : ikos::writeable(),
 	  m_ldd (lddPtr (get_ldd_man(), Ldd_GetTrue (get_ldd_man()))) {}
         
-        ~boxes_domain_ () { 
-          // DdManager *cudd = nullptr;
-          // theory_t *theory = nullptr;
-          // if (m_ldd_man)  {
-	  //   cudd = Ldd_GetCudd (m_ldd_man);
-	  //   theory = Ldd_GetTheory (m_ldd_man);
-	  //   Ldd_Quit (m_ldd_man);
-	  // }
-          // if (theory) tvpi_destroy_theory(theory);
-          // if (cudd) Cudd_Quit(cudd);
-        }
-                
         static boxes_domain_t top() { 
 	  return boxes_domain_t (lddPtr (get_ldd_man(),
 					 Ldd_GetTrue (get_ldd_man())));
@@ -780,13 +795,13 @@ namespace crab {
         
         boxes_domain_ (const boxes_domain_t& other): 
 	  ikos::writeable(), m_ldd (other.m_ldd) { 
-          crab::CrabStats::count (getDomainName () + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName () + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
         }
         
         boxes_domain_t& operator=(const boxes_domain_t& other) {
-          crab::CrabStats::count (getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+          CRAB_STATS_SCOPE (getDomainName() + ".copy");
           if (this != &other) 
             m_ldd = other.m_ldd;
           return *this;
@@ -801,8 +816,8 @@ namespace crab {
         }
         
         bool operator<=(boxes_domain_t other) {
-          crab::CrabStats::count (getDomainName() + ".count.leq");
-          crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+          CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+          CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
           bool res = Ldd_TermLeq (get_ldd_man(), &(*m_ldd), &(*other.m_ldd));
 
@@ -817,15 +832,15 @@ namespace crab {
         }
         
         boxes_domain_t operator|(boxes_domain_t other) {
-          crab::CrabStats::count (getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          CRAB_STATS_COUNT (getDomainName() + ".count.join");
+          CRAB_STATS_SCOPE (getDomainName() + ".join");
 
           return boxes_domain_t (join (m_ldd, other.m_ldd));
         }
         
         boxes_domain_t operator&(boxes_domain_t other) {
-          crab::CrabStats::count (getDomainName() + ".count.meet");
-          crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+          CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+          CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
           return boxes_domain_t (lddPtr (get_ldd_man(), 
                                          Ldd_And (get_ldd_man(),
@@ -833,8 +848,8 @@ namespace crab {
         }
 
         boxes_domain_t operator||(boxes_domain_t other) {
-          crab::CrabStats::count (getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+          CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
           // It is not necessarily true that the new value is bigger
           // than the old value so we apply 
@@ -867,8 +882,8 @@ namespace crab {
         }
         
         boxes_domain_t operator&& (boxes_domain_t other) {
-          crab::CrabStats::count (getDomainName() + ".count.narrowing");
-          crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+          CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+          CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
           boxes_domain_t res (*this & other);
           //CRAB_WARN (" boxes narrowing operator replaced with meet");
@@ -879,8 +894,8 @@ namespace crab {
         }
         
         void operator-=(VariableName var) {
-          crab::CrabStats::count (getDomainName() + ".count.forget");
-          crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+          CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+          CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
           if (is_bottom ()) return;
 
@@ -907,13 +922,13 @@ namespace crab {
         // dual of forget: remove all variables except [begin,...end)
         template<typename Iterator>
         void project (Iterator begin, Iterator end) {
-          crab::CrabStats::count (getDomainName() + ".count.project");
-          crab::ScopedCrabStats __st__(getDomainName() + ".project");
+          CRAB_STATS_COUNT (getDomainName() + ".count.project");
+          CRAB_STATS_SCOPE (getDomainName() + ".project");
 
           if (is_bottom ()) return;
 
           std::set<VariableName> s1,s2,s3;
-          for (auto p: m_var_map.left) s1.insert (p.first);
+          for (auto p: get_state ().m_var_map.left) s1.insert (p.first);
           s2.insert (begin, end);
           boost::set_difference (s1,s2,std::inserter (s3, s3.end ()));
           forget (s3.begin (), s3.end ());
@@ -921,8 +936,8 @@ namespace crab {
 
         void operator+=(linear_constraint_t cst)
         {
-          crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-          crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+          CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+          CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
           if (is_bottom () || cst.is_tautology ())  
             return;
@@ -965,8 +980,8 @@ namespace crab {
         }
 
         void set (VariableName v, interval_t ival) {
-          crab::CrabStats::count (getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign");
           
           if (is_bottom ()) return ;
 
@@ -988,8 +1003,8 @@ namespace crab {
 
         interval_t operator[](VariableName v) { 
 
-          crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-          crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+          CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+          CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
           if (is_bottom ()) 
             return interval_t::bottom ();
@@ -1012,8 +1027,8 @@ namespace crab {
                 
 	// x := e
         void assign (VariableName x, linear_expression_t e) {
-          crab::CrabStats::count (getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign");
 	  
           if (is_bottom ()) 
             return;
@@ -1042,8 +1057,8 @@ namespace crab {
 
 	// x := y op k
         void apply (operation_t op, VariableName x, VariableName y, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ()) 
             return;
@@ -1076,8 +1091,8 @@ namespace crab {
 
 	// x := x op k
         void apply(operation_t op, VariableName x, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ())
             return;
@@ -1108,8 +1123,8 @@ namespace crab {
 
 	// x := y op z
         void apply(operation_t op, VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 	  
           if (is_bottom ()) 
             return;
@@ -1199,8 +1214,8 @@ namespace crab {
   
         void apply(bitwise_operation_t op,
 		   VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ()) 
             return;
@@ -1222,8 +1237,8 @@ namespace crab {
         
         void apply(bitwise_operation_t op,
 		   VariableName x, VariableName y, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ()) 
             return;
@@ -1246,8 +1261,8 @@ namespace crab {
         // division_operators_api
         void apply(div_operation_t op,
 		   VariableName x, VariableName y, VariableName z) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ()) 
             return;
@@ -1271,8 +1286,8 @@ namespace crab {
         }
         
         void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-          crab::CrabStats::count (getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
           if (is_bottom ()) 
             return;
@@ -1301,8 +1316,8 @@ namespace crab {
 	
 	void assign_bool_cst (VariableName lhs, linear_constraint_t cst) override
 	{
-          crab::CrabStats::count (getDomainName() + ".count.assign_bool_cst");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign_bool_cst");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign_bool_cst");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign_bool_cst");
 	  
 	  if (is_bottom ()) return;
 	  
@@ -1348,8 +1363,8 @@ namespace crab {
 	}    
 	
 	void assign_bool_var (VariableName x, VariableName y) override {
-          crab::CrabStats::count (getDomainName() + ".count.assign_bool_var");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign_bool_var");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assign_bool_var");
+          CRAB_STATS_SCOPE (getDomainName() + ".assign_bool_var");
 	  
 	  copy_term (x, y);
 	  
@@ -1359,8 +1374,8 @@ namespace crab {
 	
 	void apply_binary_bool(bool_operation_t op, VariableName x,
 			       VariableName y, VariableName z) override {
-          crab::CrabStats::count (getDomainName() + ".count.apply_bin_bool");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply_bin_bool");
+          CRAB_STATS_COUNT (getDomainName() + ".count.apply_bin_bool");
+          CRAB_STATS_SCOPE (getDomainName() + ".apply_bin_bool");
 	  
 	  // XXX: if *lhs is null then it represents the SPECIAL
 	  // variable $0.
@@ -1390,8 +1405,8 @@ namespace crab {
 	}
 	
 	void assume_bool (VariableName x, bool is_negated) override {
-          crab::CrabStats::count (getDomainName() + ".count.assume_bool");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assume_bool");
+          CRAB_STATS_COUNT (getDomainName() + ".count.assume_bool");
+          CRAB_STATS_SCOPE (getDomainName() + ".assume_bool");
 	  
 	  m_ldd = lddPtr (get_ldd_man(),
 			  Ldd_And (get_ldd_man(), &*m_ldd,
@@ -1451,12 +1466,6 @@ namespace crab {
 	{ return "Boxes"; }        
       }; 
 
-     template<typename N, typename V, size_t S>
-     LddManager* boxes_domain_<N,V,S>::m_ldd_man = nullptr;
-
-     template<typename N, typename V, size_t S>
-     typename boxes_domain_<N,V,S>::var_map_t boxes_domain_<N,V,S>::m_var_map;
-
      template<typename Number, typename VariableName, size_t LddSize>
      class domain_traits <boxes_domain_<Number,VariableName, LddSize> > {
       public:
@@ -562,8 +562,8 @@ namespace crab {
       }
 
       void reduce_variable(const VariableName& v) {
-        crab::CrabStats::count (getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        CRAB_STATS_COUNT (getDomainName() + ".count.reduce");
+        CRAB_STATS_SCOPE (getDomainName() + ".reduce");
 
         if (!is_bottom()) {
           
@@ -1143,8 +1143,8 @@ namespace crab {
           _product(product) {}
       
       void reduce_variable(const varname_t& v) {
-        crab::CrabStats::count (getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        CRAB_STATS_COUNT (getDomainName() + ".count.reduce");
+        CRAB_STATS_SCOPE (getDomainName() + ".reduce");
 
         if (is_bottom())
           return;
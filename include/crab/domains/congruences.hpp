@@ -843,13 +843,13 @@ public:
 
   congruence_domain(const congruence_domain_t& e)
       : _env(e._env) {
-    crab::CrabStats::count (getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+    CRAB_STATS_SCOPE (getDomainName() + ".copy");
   }
 
   congruence_domain_t& operator=(const congruence_domain_t& o) {
-    crab::CrabStats::count (getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+    CRAB_STATS_SCOPE (getDomainName() + ".copy");
     if (this != &o)
       this->_env = o._env;
     return *this;
@@ -864,32 +864,32 @@ public:
   bool is_top() { return this->_env.is_top(); }
 
   bool operator<=(congruence_domain_t e) { 
-    crab::CrabStats::count (getDomainName() + ".count.leq");
-    crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+    CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+    CRAB_STATS_SCOPE (getDomainName() + ".leq");
     return this->_env <= e._env; 
   }
 
   void operator|=(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    CRAB_STATS_COUNT (getDomainName() + ".count.join");
+    CRAB_STATS_SCOPE (getDomainName() + ".join");
     this->_env = this->_env | e._env;
   }
 
   congruence_domain_t operator|(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    CRAB_STATS_COUNT (getDomainName() + ".count.join");
+    CRAB_STATS_SCOPE (getDomainName() + ".join");
     return this->_env | e._env;
   }
 
   congruence_domain_t operator&(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.meet");
-    crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+    CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+    CRAB_STATS_SCOPE (getDomainName() + ".meet");
     return this->_env & e._env;
   }
 
   congruence_domain_t operator||(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.widening");
-    crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+    CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+    CRAB_STATS_SCOPE (getDomainName() + ".widening");
     return this->_env || e._env;
   }
 
@@ -900,26 +900,26 @@ public:
   }
 
   congruence_domain_t operator&&(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.narrowing");
-    crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+    CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+    CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
     return this->_env && e._env;
   }
 
   void set(VariableName v, congruence_t i) { 
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+    CRAB_STATS_SCOPE (getDomainName() + ".assign");
     this->_env.set(v, i); 
   }
 
   void set(VariableName v, Number n) {
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+    CRAB_STATS_SCOPE (getDomainName() + ".assign");
     this->_env.set(v, congruence_t(n)); 
   }
 
   void operator-=(VariableName v) { 
-    crab::CrabStats::count (getDomainName() + ".count.forget");
-    crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+    CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+    CRAB_STATS_SCOPE (getDomainName() + ".forget");
     this->_env -= v; 
   }
 
@@ -946,8 +946,8 @@ public:
   }
 
   void add(linear_constraint_system_t csts) {
-    crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-    crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+    CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+    CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
     const std::size_t threshold = 10;
     if (!this->is_bottom()) {
       solver_t solver(csts, threshold);
@@ -966,8 +966,8 @@ public:
   }
 
   void assign(VariableName x, linear_expression_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+    CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
     congruence_t r = e.constant();
     for (typename linear_expression_t::iterator it = e.begin(); it != e.end();
@@ -978,8 +978,8 @@ public:
   }
 
   void apply(operation_t op, VariableName x, VariableName y, VariableName z) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi = this->_env[z];
@@ -1008,8 +1008,8 @@ public:
   }
 
   void apply(operation_t op, VariableName x, VariableName y, Number k) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi(k);
@@ -1040,8 +1040,8 @@ public:
   // bitwise_operators_api
   
   void apply(conv_operation_t op, VariableName x, VariableName y, unsigned width) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t xi = congruence_t::bottom();
@@ -1065,8 +1065,8 @@ public:
   }
 
   void apply(conv_operation_t op, VariableName x, Number k, unsigned width) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi(k);
     congruence_t xi = congruence_t::bottom();
@@ -1090,8 +1090,8 @@ public:
   }
 
   void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi = this->_env[z];
@@ -1128,8 +1128,8 @@ public:
   }
 
   void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi(k);
@@ -1168,8 +1168,8 @@ public:
   // division_operators_api
 
   void apply(div_operation_t op, VariableName x, VariableName y, VariableName z) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi = this->_env[z];
@@ -1198,8 +1198,8 @@ public:
   }
 
   void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+    CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
     congruence_t yi = this->_env[y];
     congruence_t zi(k);
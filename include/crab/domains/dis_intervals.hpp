@@ -1112,13 +1112,13 @@ namespace crab {
 
      dis_interval_domain (const dis_interval_domain_t& o): 
        _env(o._env) { 
-       crab::CrabStats::count (getDomainName() + ".count.copy");
-       crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+       CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+       CRAB_STATS_SCOPE (getDomainName() + ".copy");
      }
      
      dis_interval_domain_t& operator=(const dis_interval_domain_t& o) {
-       crab::CrabStats::count (getDomainName() + ".count.copy");
-       crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+       CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+       CRAB_STATS_SCOPE (getDomainName() + ".copy");
        if (this != &o)
          this->_env = o._env;
        return *this;
@@ -1141,8 +1141,8 @@ namespace crab {
      }
 
      bool operator<=(dis_interval_domain_t e) {
-       crab::CrabStats::count (getDomainName() + ".count.leq");
-       crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+       CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+       CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
        //crab::outs() << "*** Leq " << *this << " and " << e << "\n";
        bool res = this->_env <= e._env;
@@ -1155,8 +1155,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator|(dis_interval_domain_t e) {
-       crab::CrabStats::count (getDomainName() + ".count.join");
-       crab::ScopedCrabStats __st__(getDomainName() + ".join");
+       CRAB_STATS_COUNT (getDomainName() + ".count.join");
+       CRAB_STATS_SCOPE (getDomainName() + ".join");
 
        //crab::outs() << "*** Join " << *this << " and " << e << "\n";
        dis_interval_domain_t res (this->_env | e._env);
@@ -1165,8 +1165,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator&(dis_interval_domain_t e) {
-       crab::CrabStats::count (getDomainName() + ".count.meet");
-       crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+       CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+       CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
        //crab::outs() << "*** Meet " << *this << " and " << e << "\n";
        dis_interval_domain_t res (this->_env & e._env);
@@ -1175,8 +1175,8 @@ namespace crab {
      }
 
      dis_interval_domain_t operator||(dis_interval_domain_t e) {
-       crab::CrabStats::count (getDomainName() + ".count.widening");
-       crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+       CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+       CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
        //crab::outs() << "*** Widening " << *this << " and " << e << "\n";
        dis_interval_domain_t res (this->_env || e._env);
@@ -1186,8 +1186,8 @@ namespace crab {
      
      template<typename Thresholds>
      dis_interval_domain_t widening_thresholds (dis_interval_domain_t e, const Thresholds &ts) {
-       crab::CrabStats::count (getDomainName() + ".count.widening");
-       crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+       CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+       CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
        //crab::outs() << "*** Widening w/ thresholds " << *this << " and " << e << "\n";
        dis_interval_domain_t res = this->_env.widening_thresholds (e._env, ts);
@@ -1196,8 +1196,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator&&(dis_interval_domain_t e) {
-       crab::CrabStats::count (getDomainName() + ".count.narrowing");
-       crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+       CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+       CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
        //crab::outs() << "*** Narrowing " << *this << " and " << e << "\n";
        dis_interval_domain_t res (this->_env && e._env);
@@ -1206,30 +1206,30 @@ namespace crab {
      }
      
      void operator-=(VariableName v) {
-       crab::CrabStats::count (getDomainName() + ".count.forget");
-       crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+       CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+       CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
        this->_env -= v;
      }
 
      interval_t operator[](VariableName v)  {
-       crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-       crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+       CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+       CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
        dis_interval_t x = this->_env [v];
        return x.approx ();
      }
      
      void set(VariableName v, interval_t intv) {
-       crab::CrabStats::count (getDomainName() + ".count.assign");
-       crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+       CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+       CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
        this->_env.set (v, dis_interval_t (intv));
      }
      
      void operator+=(linear_constraint_system_t csts) {
-       crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-       crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+       CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+       CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
        if (!this->is_bottom()) {
          //crab::outs() << "*** add constraints " << csts << " in " << *this << "\n";
@@ -1241,8 +1241,8 @@ namespace crab {
      }
 
      void assign (VariableName x, linear_expression_t e)  {
-       crab::CrabStats::count (getDomainName() + ".count.assign");
-       crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+       CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+       CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
        //crab::outs() << "*** " <<  x << ":=" << e << " in " << *this << "\n";
        if (boost::optional<variable_t> v = e.get_variable ()) {
@@ -1258,8 +1258,8 @@ namespace crab {
      }
      
      void apply (operation_t op, VariableName x, VariableName y, Number z) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        //crab::outs() << "*** " << x << ":=" << y << op << z << " in " << *this << "\n";
        dis_interval_t yi = this->_env[y];
@@ -1276,8 +1276,8 @@ namespace crab {
      }
 
      void apply(operation_t op, VariableName x, VariableName y, VariableName z) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        //crab::outs() << "*** " << x << ":=" << y << op << z << " in " << *this << "\n";
        dis_interval_t yi = this->_env[y];
@@ -1295,8 +1295,8 @@ namespace crab {
      
      
      void apply(conv_operation_t op, VariableName x, VariableName y, unsigned width)  {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t xi = dis_interval_t::top ();
@@ -1309,8 +1309,8 @@ namespace crab {
      }
      
      void apply(conv_operation_t op, VariableName x, Number k, unsigned width) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi (k);
        dis_interval_t xi = dis_interval_t::top ();
@@ -1323,8 +1323,8 @@ namespace crab {
      }
      
      void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi = this->_env[z];
@@ -1341,8 +1341,8 @@ namespace crab {
      }
         
      void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi (k);
@@ -1359,8 +1359,8 @@ namespace crab {
      }
      
      void apply(div_operation_t op, VariableName x, VariableName y, VariableName z) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi = this->_env[z];
@@ -1376,8 +1376,8 @@ namespace crab {
      }
      
      void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-       crab::CrabStats::count (getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+       CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi (k);
@@ -1394,16 +1394,16 @@ namespace crab {
      }
 
      void expand (VariableName x, VariableName new_x) {
-       crab::CrabStats::count (getDomainName() + ".count.expand");
-       crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+       CRAB_STATS_COUNT (getDomainName() + ".count.expand");
+       CRAB_STATS_SCOPE (getDomainName() + ".expand");
 
        this->_env.set (new_x, this->_env [x]);
      }
 
      template<typename Range>
      void project (Range vs) {
-       crab::CrabStats::count (getDomainName() + ".count.project");
-       crab::ScopedCrabStats __st__(getDomainName() + ".project");
+       CRAB_STATS_COUNT (getDomainName() + ".count.project");
+       CRAB_STATS_SCOPE (getDomainName() + ".project");
 
        separate_domain_t env;
        for (auto v : vs) {
@@ -1413,8 +1413,8 @@ namespace crab {
      }
 
      void normalize () {
-       crab::CrabStats::count (getDomainName() + ".count.normalize");
-       crab::ScopedCrabStats __st__(getDomainName() + ".normalize");
+       CRAB_STATS_COUNT (getDomainName() + ".count.normalize");
+       CRAB_STATS_SCOPE (getDomainName() + ".normalize");
        if (is_bottom () || is_top ()) return;
        separate_domain_t env;
        for (auto p : boost::make_iterator_range (_env.begin (), _env.end ())) {
@@ -0,0 +1,606 @@
+#ifndef IKOS_FLAT_MAPS_HPP
+#define IKOS_FLAT_MAPS_HPP
+
+/*
+   Alternatives to patricia trees for small maps.
+
+   flat_map keeps the bindings sorted by key index in a contiguous
+   array. It offers the same interface as patricia_tree (including
+   the iteration order) so both can be used interchangeably by
+   separate_domain. Copies share the array until one of them is
+   modified.
+
+   adaptive_map is a flat_map while it has at most MaxFlat bindings
+   and a patricia_tree otherwise.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <crab/common/types.hpp>
+#include <crab/domains/patricia_trees.hpp>
+
+namespace ikos {
+
+namespace flat_maps_impl {
+
+// Dispatch the application of binary and key binary operations
+template < typename Key, typename Value >
+inline boost::optional< Value > apply(binary_op< Value >& op,
+                                      const Key&,
+                                      const Value& x,
+                                      const Value& y) {
+  return op.apply(x, y);
+}
+
+template < typename Key, typename Value >
+inline boost::optional< Value > apply(key_binary_op< Key, Value >& op,
+                                      const Key& k,
+                                      const Value& x,
+                                      const Value& y) {
+  return op.apply(k, x, y);
+}
+
+} // namespace flat_maps_impl
+
+template < typename Key, typename Value >
+class flat_map {
+public:
+  typedef flat_map< Key, Value > flat_map_t;
+  typedef unary_op< Value > unary_op_t;
+  typedef binary_op< Value > binary_op_t;
+  typedef key_binary_op< Key, Value > key_binary_op_t;
+  typedef partial_order< Value > partial_order_t;
+
+  struct binding_t {
+    const Key& first;
+    const Value& second;
+    binding_t(const Key& first_, const Value& second_)
+        : first(first_), second(second_) {}
+  };
+
+private:
+  typedef std::pair< Key, Value > entry_t;
+
+  // The key indexes are also stored apart so that searching and
+  // merging only scan contiguous integers.
+  struct data {
+    std::vector< index_t > _idx;
+    std::vector< entry_t > _entries;
+  };
+  typedef boost::shared_ptr< data > data_ptr;
+
+  // null if the map is empty
+  data_ptr _data;
+
+public:
+  class iterator : public boost::iterator_facade< iterator,
+                                                  binding_t,
+                                                  boost::random_access_traversal_tag,
+                                                  binding_t > {
+    friend class boost::iterator_core_access;
+
+  private:
+    const entry_t* _cur;
+
+  public:
+    iterator() : _cur(nullptr) {}
+
+    explicit iterator(const entry_t* cur) : _cur(cur) {}
+
+  private:
+    void increment() { ++this->_cur; }
+
+    void decrement() { --this->_cur; }
+
+    void advance(std::ptrdiff_t n) { this->_cur += n; }
+
+    std::ptrdiff_t distance_to(const iterator& other) const {
+      return other._cur - this->_cur;
+    }
+
+    bool equal(const iterator& other) const { return this->_cur == other._cur; }
+
+    binding_t dereference() const {
+      return binding_t(this->_cur->first, this->_cur->second);
+    }
+
+  }; // class iterator
+
+private:
+  std::size_t find(index_t id) const {
+    const std::vector< index_t >& idx = this->_data->_idx;
+    return std::lower_bound(idx.begin(), idx.end(), id) - idx.begin();
+  }
+
+  // Make sure that the data is not shared before modifying it
+  data& mut() {
+    if (!this->_data) {
+      this->_data = boost::make_shared< data >();
+    } else if (this->_data.use_count() > 1) {
+      this->_data = boost::make_shared< data >(*this->_data);
+    }
+    return *this->_data;
+  }
+
+  static void push(data& d, const Key& k, const Value& v) {
+    d._idx.push_back(k.index());
+    d._entries.push_back(entry_t(k, v));
+  }
+
+  // Apply op to two bindings of the same key. Op is either a
+  // binary_op or a key_binary_op.
+  template < typename Op >
+  static boost::optional< Value > apply(Op& op, const entry_t& x, const entry_t& y) {
+    return flat_maps_impl::apply(op, x.first, x.second, y.second);
+  }
+
+  // Some values do not declare operator== as const
+  static bool equal(const Value& x, const Value& y) {
+    return const_cast< Value& >(x) == y;
+  }
+
+  template < typename Op >
+  void merge(const flat_map_t& t, Op& op) {
+    if (this->_data == t._data) {
+      // apply(x, x) = x
+      return;
+    }
+    const bool absorbing = op.default_is_absorbing();
+    if (t.empty()) {
+      if (absorbing) {
+        this->clear();
+      }
+      return;
+    }
+    if (this->empty()) {
+      if (!absorbing) {
+        this->_data = t._data;
+      }
+      return;
+    }
+
+    const data& s_d = *this->_data;
+    const data& t_d = *t._data;
+    const std::size_t s_n = s_d._idx.size(), t_n = t_d._idx.size();
+    // The result is only built once it differs from this map. Until
+    // then res is null and the result is the bindings of this seen
+    // so far.
+    data_ptr res;
+    // whether the result is equal to t
+    bool same_t = true;
+
+    auto diverge = [&](std::size_t i) {
+      if (!res) {
+        res = boost::make_shared< data >();
+        res->_idx.reserve(absorbing ? std::min(s_n, t_n) : s_n + t_n);
+        res->_entries.reserve(res->_idx.capacity());
+        res->_idx.assign(s_d._idx.begin(), s_d._idx.begin() + i);
+        res->_entries.assign(s_d._entries.begin(), s_d._entries.begin() + i);
+      }
+    };
+    // both maps have a binding for the key
+    auto both = [&](std::size_t i, std::size_t j) {
+      const entry_t& x = s_d._entries[i];
+      const entry_t& y = t_d._entries[j];
+      if (equal(x.second, y.second)) {
+        // apply(x, x) = x
+        if (res) {
+          push(*res, x.first, x.second);
+        }
+        return;
+      }
+      boost::optional< Value > v = apply(op, x, y);
+      if (!v) {
+        diverge(i);
+        same_t = false;
+      } else if (equal(*v, x.second)) {
+        same_t = false;
+        if (res) {
+          push(*res, x.first, x.second);
+        }
+      } else {
+        diverge(i);
+        same_t = same_t && equal(*v, y.second);
+        push(*res, x.first, *v);
+      }
+    };
+
+    if (s_n == t_n &&
+        std::memcmp(&s_d._idx[0], &t_d._idx[0], s_n * sizeof(index_t)) == 0) {
+      // fast path: both maps have the same keys
+      for (std::size_t i = 0; i < s_n; ++i) {
+        both(i, i);
+      }
+    } else {
+      std::size_t i = 0, j = 0;
+      while (i < s_n || j < t_n) {
+        if (j == t_n || (i < s_n && s_d._idx[i] < t_d._idx[j])) {
+          same_t = false;
+          if (absorbing) {
+            diverge(i);
+          } else if (res) {
+            push(*res, s_d._entries[i].first, s_d._entries[i].second);
+          }
+          ++i;
+        } else if (i == s_n || t_d._idx[j] < s_d._idx[i]) {
+          if (absorbing) {
+            same_t = false;
+          } else {
+            diverge(i);
+            push(*res, t_d._entries[j].first, t_d._entries[j].second);
+          }
+          ++j;
+        } else {
+          both(i, j);
+          ++i;
+          ++j;
+        }
+      }
+    }
+
+    // keep sharing the data with the operands whenever possible
+    if (!res) {
+      return;
+    } else if (same_t) {
+      this->_data = t._data;
+    } else if (res->_idx.empty()) {
+      this->_data.reset();
+    } else {
+      this->_data = res;
+    }
+  }
+
+public:
+  flat_map() {}
+
+  flat_map(const flat_map_t& t) : _data(t._data) {}
+
+  flat_map_t& operator=(const flat_map_t& t) {
+    this->_data = t._data;
+    return *this;
+  }
+
+  std::size_t size() const {
+    return this->_data ? this->_data->_idx.size() : 0;
+  }
+
+  iterator begin() const {
+    return this->_data ? iterator(&this->_data->_entries[0]) : iterator();
+  }
+
+  iterator end() const {
+    return this->_data ? iterator(&this->_data->_entries[0] + this->size())
+                       : iterator();
+  }
+
+  boost::optional< Value > lookup(const Key& key) const {
+    if (this->_data) {
+      std::size_t i = this->find(key.index());
+      if (i < this->size() && this->_data->_idx[i] == key.index()) {
+        return boost::optional< Value >(this->_data->_entries[i].second);
+      }
+    }
+    return boost::optional< Value >();
+  }
+
+  void merge_with(const flat_map_t& t, binary_op_t& op) { this->merge(t, op); }
+
+  void merge_with(const flat_map_t& t, key_binary_op_t& op) { this->merge(t, op); }
+
+  void insert(const Key& key, const Value& value) {
+    std::size_t i = this->_data ? this->find(key.index()) : 0;
+    data& d = this->mut();
+    if (i < d._idx.size() && d._idx[i] == key.index()) {
+      d._entries[i].second = value;
+    } else {
+      d._idx.insert(d._idx.begin() + i, key.index());
+      d._entries.insert(d._entries.begin() + i, entry_t(key, value));
+    }
+  }
+
+  void transform(unary_op_t& op) {
+    if (!this->_data) {
+      return;
+    }
+    data_ptr res = boost::make_shared< data >();
+    bool same = true;
+    for (const entry_t& e : this->_data->_entries) {
+      boost::optional< Value > v = op.apply(e.second);
+      if (v) {
+        same = same && equal(*v, e.second);
+        push(*res, e.first, *v);
+      } else {
+        same = false;
+      }
+    }
+    if (!same) {
+      this->_data = res->_idx.empty() ? data_ptr() : res;
+    }
+  }
+
+  void remove(const Key& key) {
+    if (!this->_data) {
+      return;
+    }
+    std::size_t i = this->find(key.index());
+    if (i < this->size() && this->_data->_idx[i] == key.index()) {
+      if (this->size() == 1) {
+        this->_data.reset();
+      } else {
+        data& d = this->mut();
+        d._idx.erase(d._idx.begin() + i);
+        d._entries.erase(d._entries.begin() + i);
+      }
+    }
+  }
+
+  void clear() { this->_data.reset(); }
+
+  bool empty() const { return !this->_data; }
+
+  bool leq(const flat_map_t& t, partial_order_t& po) const {
+    if (this->_data == t._data) {
+      return true;
+    }
+    const bool default_is_top = po.default_is_top();
+    const std::size_t s_n = this->size(), t_n = t.size();
+    std::size_t i = 0, j = 0;
+    while (i < s_n || j < t_n) {
+      if (j == t_n || (i < s_n && this->_data->_idx[i] < t._data->_idx[j])) {
+        // the binding of t is the default value
+        if (!default_is_top) {
+          return false;
+        }
+        ++i;
+      } else if (i == s_n || t._data->_idx[j] < this->_data->_idx[i]) {
+        // the binding of this is the default value
+        if (default_is_top) {
+          return false;
+        }
+        ++j;
+      } else {
+        if (!po.leq(this->_data->_entries[i].second, t._data->_entries[j].second)) {
+          return false;
+        }
+        ++i;
+        ++j;
+      }
+    }
+    return true;
+  }
+
+}; // class flat_map
+
+template < typename Key, typename Value, std::size_t MaxFlat = 64 >
+class adaptive_map {
+public:
+  typedef adaptive_map< Key, Value, MaxFlat > adaptive_map_t;
+  typedef flat_map< Key, Value > flat_map_t;
+  typedef patricia_tree< Key, Value > patricia_tree_t;
+  typedef unary_op< Value > unary_op_t;
+  typedef binary_op< Value > binary_op_t;
+  typedef key_binary_op< Key, Value > key_binary_op_t;
+  typedef partial_order< Value > partial_order_t;
+  typedef typename flat_map_t::binding_t binding_t;
+
+private:
+  // A map switches to a patricia tree when it has more than MaxFlat
+  // bindings and back to a flat map when it has at most MaxFlat/2.
+  // The gap avoids converting back and forth a map whose size
+  // oscillates around MaxFlat.
+  flat_map_t _flat;
+  patricia_tree_t _tree;
+  bool _is_tree;
+
+public:
+  class iterator : public boost::iterator_facade< iterator,
+                                                  binding_t,
+                                                  boost::forward_traversal_tag,
+                                                  binding_t > {
+    friend class boost::iterator_core_access;
+    friend class adaptive_map< Key, Value, MaxFlat >;
+
+  private:
+    typename flat_map_t::iterator _flat_it;
+    // only if the map is a patricia tree
+    boost::optional< typename patricia_tree_t::iterator > _tree_it;
+
+  public:
+    iterator() {}
+
+  private:
+    explicit iterator(typename flat_map_t::iterator it) : _flat_it(it) {}
+
+    explicit iterator(typename patricia_tree_t::iterator it) : _tree_it(it) {}
+
+    void increment() {
+      if (this->_tree_it) {
+        ++(*this->_tree_it);
+      } else {
+        ++this->_flat_it;
+      }
+    }
+
+    bool equal(const iterator& other) const {
+      if (this->_tree_it && other._tree_it) {
+        return *this->_tree_it == *other._tree_it;
+      }
+      return !this->_tree_it && !other._tree_it &&
+             this->_flat_it == other._flat_it;
+    }
+
+    binding_t dereference() const {
+      if (this->_tree_it) {
+        auto b = **this->_tree_it;
+        return binding_t(b.first, b.second);
+      }
+      return *this->_flat_it;
+    }
+
+  }; // class iterator
+
+private:
+  static patricia_tree_t to_tree(const flat_map_t& m) {
+    patricia_tree_t t;
+    for (auto it = m.begin(), et = m.end(); it != et; ++it) {
+      t.insert(it->first, it->second);
+    }
+    return t;
+  }
+
+  static flat_map_t to_flat(const patricia_tree_t& t) {
+    flat_map_t m;
+    // bindings are visited in increasing order of the key indexes so
+    // they are appended at the end of the flat map
+    for (auto it = t.begin(), et = t.end(); it != et; ++it) {
+      m.insert(it->first, it->second);
+    }
+    return m;
+  }
+
+  void set_flat(const flat_map_t& m) {
+    this->_flat = m;
+    this->_tree.clear();
+    this->_is_tree = false;
+  }
+
+  void set_tree(const patricia_tree_t& t) {
+    this->_tree = t;
+    this->_flat.clear();
+    this->_is_tree = true;
+  }
+
+  // Choose the representation after the size has changed
+  void normalize() {
+    if (this->_is_tree) {
+      if (this->_tree.size() <= MaxFlat / 2) {
+        this->set_flat(to_flat(this->_tree));
+      }
+    } else if (this->_flat.size() > MaxFlat) {
+      this->set_tree(to_tree(this->_flat));
+    }
+  }
+
+  template < typename Op >
+  void merge(const adaptive_map_t& t, Op& op) {
+    if (!this->_is_tree && !t._is_tree) {
+      this->_flat.merge_with(t._flat, op);
+    } else if (this->_is_tree && t._is_tree) {
+      this->_tree.merge_with(t._tree, op);
+    } else if (this->_is_tree) {
+      // t is a flat map: merge as flat maps if this is small enough
+      if (this->_tree.size() <= MaxFlat) {
+        flat_map_t m = to_flat(this->_tree);
+        m.merge_with(t._flat, op);
+        this->set_flat(m);
+      } else {
+        this->_tree.merge_with(to_tree(t._flat), op);
+      }
+    } else {
+      if (t._tree.size() <= MaxFlat) {
+        this->_flat.merge_with(to_flat(t._tree), op);
+      } else {
+        patricia_tree_t s = to_tree(this->_flat);
+        s.merge_with(t._tree, op);
+        this->set_tree(s);
+      }
+    }
+    this->normalize();
+  }
+
+public:
+  adaptive_map() : _is_tree(false) {}
+
+  adaptive_map(const adaptive_map_t& t)
+      : _flat(t._flat), _tree(t._tree), _is_tree(t._is_tree) {}
+
+  adaptive_map_t& operator=(const adaptive_map_t& t) {
+    this->_flat = t._flat;
+    this->_tree = t._tree;
+    this->_is_tree = t._is_tree;
+    return *this;
+  }
+
+  //! Return true if the bindings are stored in a patricia tree
+  bool is_tree() const { return this->_is_tree; }
+
+  std::size_t size() const {
+    return this->_is_tree ? this->_tree.size() : this->_flat.size();
+  }
+
+  iterator begin() const {
+    return this->_is_tree ? iterator(this->_tree.begin())
+                          : iterator(this->_flat.begin());
+  }
+
+  iterator end() const {
+    return this->_is_tree ? iterator(this->_tree.end())
+                          : iterator(this->_flat.end());
+  }
+
+  boost::optional< Value > lookup(const Key& key) const {
+    return this->_is_tree ? this->_tree.lookup(key) : this->_flat.lookup(key);
+  }
+
+  void merge_with(const adaptive_map_t& t, binary_op_t& op) { this->merge(t, op); }
+
+  void merge_with(const adaptive_map_t& t, key_binary_op_t& op) { this->merge(t, op); }
+
+  void insert(const Key& key, const Value& value) {
+    if (this->_is_tree) {
+      this->_tree.insert(key, value);
+    } else {
+      this->_flat.insert(key, value);
+      this->normalize();
+    }
+  }
+
+  void transform(unary_op_t& op) {
+    if (this->_is_tree) {
+      this->_tree.transform(op);
+      this->normalize();
+    } else {
+      this->_flat.transform(op);
+    }
+  }
+
+  void remove(const Key& key) {
+    if (this->_is_tree) {
+      this->_tree.remove(key);
+      this->normalize();
+    } else {
+      this->_flat.remove(key);
+    }
+  }
+
+  void clear() {
+    this->set_flat(flat_map_t());
+  }
+
+  bool empty() const {
+    return this->_is_tree ? this->_tree.empty() : this->_flat.empty();
+  }
+
+  bool leq(const adaptive_map_t& t, partial_order_t& po) const {
+    if (!this->_is_tree && !t._is_tree) {
+      return this->_flat.leq(t._flat, po);
+    } else if (this->_is_tree && t._is_tree) {
+      return this->_tree.leq(t._tree, po);
+    } else if (this->_is_tree) {
+      return this->_tree.leq(to_tree(t._flat), po);
+    } else {
+      return to_tree(this->_flat).leq(t._tree, po);
+    }
+  }
+
+}; // class adaptive_map
+
+} // namespace ikos
+
+#endif // IKOS_FLAT_MAPS_HPP
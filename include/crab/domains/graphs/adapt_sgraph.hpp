@@ -131,7 +131,7 @@ namespace crab {
 	// for the "empty" iterator, otherwise we can trigger
 	// undefined behavior.
 	static key_iter_t empty_iterator () { 
-	  static std::unique_ptr<key_iter_t> it = nullptr;
+	  static thread_local std::unique_ptr<key_iter_t> it = nullptr;
 	  if (!it)
 	    it = std::unique_ptr<key_iter_t>(new key_iter_t ());
 	  return *it;
@@ -319,6 +319,7 @@ namespace crab {
     typedef Weight Wt;
 
     AdaptGraph(void)
+      : edge_count(0)
     { }
 
     AdaptGraph(AdaptGraph<Wt>&& o)
@@ -430,7 +431,7 @@ namespace crab {
       // for the "empty" iterator, otherwise we can trigger
       // undefined behavior.
       static edge_iter empty_iterator () { 
-	static std::unique_ptr<edge_iter> it = nullptr;
+	static thread_local std::unique_ptr<edge_iter> it = nullptr;
 	if (!it)
 	  it = std::unique_ptr<edge_iter>(new edge_iter ());
 	return *it;
@@ -0,0 +1,750 @@
+#ifndef CRAB_DENSE_GRAPH_HPP
+#define CRAB_DENSE_GRAPH_HPP
+#include <crab/common/types.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__LP64__) && (defined(__AVX2__) || defined(__SSE4_2__))
+#include <immintrin.h>
+#define CRAB_DENSE_SIMD
+#endif
+
+/* A dense weighted graph for small graphs where most of the edges
+ * are present.
+ *
+ * The weights are stored in a row-major matrix whose rows are
+ * aligned to cache lines, and a missing edge is represented by the
+ * largest weight. The join, meet, widening and the relaxation step
+ * of the incremental closure are computed row by row so that they
+ * can be vectorized.
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace crab {
+
+  // Operations over rows of weights, where infty() stands for a
+  // missing edge.
+  template<class Wt>
+  class DenseRowScalarOps {
+  public:
+    static Wt infty() { return std::numeric_limits<Wt>::max(); }
+
+    // r := x + y. Return false if the sum overflows.
+    static bool add(Wt x, Wt y, Wt& r) {
+      if(y > 0 ? x > std::numeric_limits<Wt>::max() - y
+               : x < std::numeric_limits<Wt>::min() - y)
+        return false;
+      r = x + y;
+      return true;
+    }
+
+    // out := the edges present in both a and b, with the weakest weight
+    static void join(Wt* out, const Wt* a, const Wt* b, size_t n) {
+      for(size_t i = 0; i < n; i++)
+        out[i] = std::max(a[i], b[i]);
+    }
+
+    // out := the edges present in a or b, with the strongest weight
+    static void meet(Wt* out, const Wt* a, const Wt* b, size_t n) {
+      for(size_t i = 0; i < n; i++)
+        out[i] = std::min(a[i], b[i]);
+    }
+
+    // out := the edges of a that are not weakened in b.
+    // Return true if some edge of a is dropped.
+    static bool widen(Wt* out, const Wt* a, const Wt* b, size_t n) {
+      bool dropped = false;
+      for(size_t i = 0; i < n; i++) {
+        bool stable = b[i] <= a[i];
+        dropped |= (!stable && a[i] != infty());
+        out[i] = stable ? a[i] : infty();
+      }
+      return dropped;
+    }
+
+    // row := min(row, w + src), where w is the weight of an edge.
+    // The sums that overflow are ignored.
+    static void relax(Wt* row, Wt w, const Wt* src, size_t n) {
+      for(size_t i = 0; i < n; i++) {
+        Wt s;
+        if(src[i] != infty() && add(w, src[i], s) && s < row[i])
+          row[i] = s;
+      }
+    }
+
+    // min of a[i] + b[i] over the edges present in both a and b.
+    // The sums that overflow are ignored.
+    static Wt min_plus(const Wt* a, const Wt* b, size_t n) {
+      Wt r = infty();
+      for(size_t i = 0; i < n; i++) {
+        Wt s;
+        if(a[i] != infty() && b[i] != infty() && add(a[i], b[i], s) && s < r)
+          r = s;
+      }
+      return r;
+    }
+
+    // number of edges in a
+    static size_t count(const Wt* a, size_t n) {
+      size_t c = 0;
+      for(size_t i = 0; i < n; i++)
+        c += (a[i] != infty());
+      return c;
+    }
+  };
+
+  template<class Wt>
+  class DenseRowOps: public DenseRowScalarOps<Wt> { };
+
+#ifdef CRAB_DENSE_SIMD
+  // 64-bit weights with AVX2 (4 lanes) or SSE4.2 (2 lanes).
+  // The weights that do not fill a whole vector are done by the
+  // scalar loops.
+  template<>
+  class DenseRowOps<long>: public DenseRowScalarOps<long> {
+    typedef DenseRowScalarOps<long> scalar_t;
+#ifdef __AVX2__
+    typedef __m256i vec_t;
+    enum { lanes = 4 };
+    static vec_t load(const long* p) { return _mm256_loadu_si256((const vec_t*) p); }
+    static void store(long* p, vec_t v) { _mm256_storeu_si256((vec_t*) p, v); }
+    static vec_t set1(long x) { return _mm256_set1_epi64x(x); }
+    static vec_t gt(vec_t x, vec_t y) { return _mm256_cmpgt_epi64(x, y); }
+    static vec_t eq(vec_t x, vec_t y) { return _mm256_cmpeq_epi64(x, y); }
+    static vec_t add(vec_t x, vec_t y) { return _mm256_add_epi64(x, y); }
+    static vec_t vand(vec_t x, vec_t y) { return _mm256_and_si256(x, y); }
+    static vec_t vandnot(vec_t x, vec_t y) { return _mm256_andnot_si256(x, y); }
+    static vec_t vor(vec_t x, vec_t y) { return _mm256_or_si256(x, y); }
+    static vec_t vxor(vec_t x, vec_t y) { return _mm256_xor_si256(x, y); }
+    // m ? y : x
+    static vec_t blend(vec_t x, vec_t y, vec_t m) { return _mm256_blendv_epi8(x, y, m); }
+    static bool any(vec_t m) { return !_mm256_testz_si256(m, m); }
+#else
+    typedef __m128i vec_t;
+    enum { lanes = 2 };
+    static vec_t load(const long* p) { return _mm_loadu_si128((const vec_t*) p); }
+    static void store(long* p, vec_t v) { _mm_storeu_si128((vec_t*) p, v); }
+    static vec_t set1(long x) { return _mm_set1_epi64x(x); }
+    static vec_t gt(vec_t x, vec_t y) { return _mm_cmpgt_epi64(x, y); }
+    static vec_t eq(vec_t x, vec_t y) { return _mm_cmpeq_epi64(x, y); }
+    static vec_t add(vec_t x, vec_t y) { return _mm_add_epi64(x, y); }
+    static vec_t vand(vec_t x, vec_t y) { return _mm_and_si128(x, y); }
+    static vec_t vandnot(vec_t x, vec_t y) { return _mm_andnot_si128(x, y); }
+    static vec_t vor(vec_t x, vec_t y) { return _mm_or_si128(x, y); }
+    static vec_t vxor(vec_t x, vec_t y) { return _mm_xor_si128(x, y); }
+    static vec_t blend(vec_t x, vec_t y, vec_t m) { return _mm_blendv_epi8(x, y, m); }
+    static bool any(vec_t m) { return !_mm_testz_si128(m, m); }
+#endif
+
+  public:
+    static void join(long* out, const long* a, const long* b, size_t n) {
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        vec_t x = load(a + i), y = load(b + i);
+        store(out + i, blend(y, x, gt(x, y)));
+      }
+      scalar_t::join(out + i, a + i, b + i, n - i);
+    }
+
+    static void meet(long* out, const long* a, const long* b, size_t n) {
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        vec_t x = load(a + i), y = load(b + i);
+        store(out + i, blend(x, y, gt(x, y)));
+      }
+      scalar_t::meet(out + i, a + i, b + i, n - i);
+    }
+
+    static bool widen(long* out, const long* a, const long* b, size_t n) {
+      const vec_t inf = set1(infty());
+      vec_t dropped = set1(0);
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        vec_t x = load(a + i), y = load(b + i);
+        vec_t unstable = gt(y, x);
+        dropped = vor(dropped, vandnot(eq(x, inf), unstable));
+        store(out + i, blend(x, inf, unstable));
+      }
+      bool res = scalar_t::widen(out + i, a + i, b + i, n - i);
+      return any(dropped) || res;
+    }
+
+    static void relax(long* row, long w, const long* src, size_t n) {
+      // w + src[i] does not overflow iff lo <= src[i] <= hi, and the
+      // upper bound also excludes the missing edges.
+      long lo = w < 0 ? std::numeric_limits<long>::min() - w : std::numeric_limits<long>::min();
+      long hi = w > 0 ? std::numeric_limits<long>::max() - w : infty() - 1;
+      const vec_t vlo = set1(lo), vhi = set1(hi), vw = set1(w);
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        vec_t s = load(src + i), r = load(row + i);
+        vec_t invalid = vor(gt(vlo, s), gt(s, vhi));
+        vec_t c = add(s, vw);
+        store(row + i, blend(r, c, vandnot(invalid, gt(r, c))));
+      }
+      scalar_t::relax(row + i, w, src + i, n - i);
+    }
+
+    static long min_plus(const long* a, const long* b, size_t n) {
+      const vec_t inf = set1(infty()), zero = set1(0);
+      vec_t acc = inf;
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        vec_t x = load(a + i), y = load(b + i);
+        vec_t s = add(x, y);
+        // signed overflow iff the sign of s differs from both x and y
+        vec_t invalid = vor(vor(eq(x, inf), eq(y, inf)),
+                            gt(zero, vand(vxor(x, s), vxor(y, s))));
+        s = blend(s, inf, invalid);
+        acc = blend(acc, s, gt(acc, s));
+      }
+      long lanes_acc[lanes];
+      store(lanes_acc, acc);
+      long r = scalar_t::min_plus(a + i, b + i, n - i);
+      for(unsigned k = 0; k < lanes; k++)
+        r = std::min(r, lanes_acc[k]);
+      return r;
+    }
+
+    static size_t count(const long* a, size_t n) {
+      const vec_t inf = set1(infty());
+      size_t c = 0;
+      size_t i = 0;
+      for(; i + lanes <= n; i += lanes) {
+        long m[lanes];
+        store(m, eq(load(a + i), inf));
+        for(unsigned k = 0; k < lanes; k++)
+          c += (m[k] == 0);
+      }
+      return c + scalar_t::count(a + i, n - i);
+    }
+  };
+#endif
+
+  template<class Weight>
+  class DenseGraph : public ikos::writeable {
+  public:
+    typedef Weight Wt;
+    typedef DenseGraph<Wt> graph_t;
+    typedef unsigned int vert_id;
+    typedef DenseRowOps<Wt> row_ops_t;
+
+  private:
+    // Rows are padded to a multiple of the cache line size.
+    enum { line_sz = 64 };
+    enum { row_align = line_sz / sizeof(Wt) > 0 ? line_sz / sizeof(Wt) : 1 };
+
+    static Wt infty() { return row_ops_t::infty(); }
+
+    static size_t round_up(size_t n) {
+      return ((n + row_align - 1) / row_align) * row_align;
+    }
+
+    // Allocate a cap x cap matrix without edges
+    void alloc(size_t _cap) {
+      cap = round_up(_cap);
+      if(cap == 0) {
+        mtx = nullptr;
+        return;
+      }
+      void* p = nullptr;
+      if(posix_memalign(&p, line_sz, sizeof(Wt)*cap*cap) != 0)
+        CRAB_ERROR("DenseGraph: cannot allocate ", cap, "x", cap, " matrix");
+      mtx = (Wt*) p;
+      std::fill(mtx, mtx + cap*cap, infty());
+    }
+
+    void grow_cap(size_t new_sz) {
+      if(new_sz <= cap)
+        return;
+      size_t old_cap = cap;
+      Wt* old_mtx = mtx;
+      alloc(std::max(new_sz, 2*old_cap));
+      for(size_t v = 0; v < sz; v++)
+        memcpy(mtx + v*cap, old_mtx + v*old_cap, sizeof(Wt)*sz);
+      free(old_mtx);
+    }
+
+    Wt* row(vert_id v) { return mtx + v*cap; }
+    const Wt* row(vert_id v) const { return mtx + v*cap; }
+
+    void recount(void) {
+      edge_count = 0;
+      for(vert_id v = 0; v < sz; v++)
+        edge_count += row_ops_t::count(row(v), sz);
+    }
+
+  public:
+    DenseGraph(void)
+      : sz(0), cap(0), mtx(nullptr), edge_count(0)
+    { }
+
+    DenseGraph(const DenseGraph<Wt>& o)
+      : sz(o.sz), edge_count(o.edge_count), is_free(o.is_free), free_id(o.free_id)
+    {
+      alloc(o.sz);
+      for(vert_id v = 0; v < sz; v++)
+        memcpy(row(v), o.row(v), sizeof(Wt)*sz);
+    }
+
+    DenseGraph(DenseGraph<Wt>&& o)
+      : sz(o.sz), cap(o.cap), mtx(o.mtx), edge_count(o.edge_count),
+        is_free(std::move(o.is_free)), free_id(std::move(o.free_id))
+    {
+      o.sz = 0;
+      o.cap = 0;
+      o.mtx = nullptr;
+      o.edge_count = 0;
+    }
+
+    ~DenseGraph(void) { free(mtx); }
+
+    DenseGraph<Wt>& operator=(const DenseGraph<Wt>& o)
+    {
+      if(this == &o)
+        return *this;
+      if(cap < o.sz) {
+        free(mtx);
+        alloc(o.sz);
+      } else {
+        clear_edges();
+      }
+      sz = o.sz;
+      for(vert_id v = 0; v < sz; v++)
+        memcpy(row(v), o.row(v), sizeof(Wt)*sz);
+      edge_count = o.edge_count;
+      is_free = o.is_free;
+      free_id = o.free_id;
+      return *this;
+    }
+
+    DenseGraph<Wt>& operator=(DenseGraph<Wt>&& o)
+    {
+      if(this == &o)
+        return *this;
+      free(mtx);
+      sz = o.sz;
+      cap = o.cap;
+      mtx = o.mtx;
+      edge_count = o.edge_count;
+      is_free = std::move(o.is_free);
+      free_id = std::move(o.free_id);
+      o.sz = 0;
+      o.cap = 0;
+      o.mtx = nullptr;
+      o.edge_count = 0;
+      return *this;
+    }
+
+    template<class G>
+    static DenseGraph<Wt> copy(const G& o)
+    {
+      DenseGraph<Wt> g;
+      g.growTo(o.size());
+
+      for(vert_id s : o.verts())
+      {
+        for(auto e : const_cast<G&>(o).e_succs(s))
+        {
+          g.add_edge(s, e.val, e.vert);
+        }
+      }
+      return g;
+    }
+
+    // The graph seen through the (possibly incomplete) permutation
+    // perm: vertex v of the result is vertex perm[v] of g.
+    static DenseGraph<Wt> permute(const std::vector<vert_id>& perm, const DenseGraph<Wt>& g)
+    {
+      DenseGraph<Wt> res;
+      size_t n = perm.size();
+      res.growTo(n);
+      bool is_id = (n <= g.sz);
+      for(vert_id v = 0; is_id && v < n; v++)
+        is_id = (perm[v] == v);
+
+      for(vert_id v = 0; v < n; v++)
+      {
+        if(perm[v] >= g.sz)
+          continue;
+        const Wt* src = g.row(perm[v]);
+        Wt* dst = res.row(v);
+        if(is_id) {
+          memcpy(dst, src, sizeof(Wt)*n);
+        } else {
+          for(vert_id d = 0; d < n; d++)
+            dst[d] = perm[d] < g.sz ? src[perm[d]] : infty();
+        }
+      }
+      res.recount();
+      return res;
+    }
+
+    // Edges present in both graphs, with the weakest weight
+    static DenseGraph<Wt> join(const DenseGraph<Wt>& l, const DenseGraph<Wt>& r)
+    {
+      assert(l.size() == r.size());
+      DenseGraph<Wt> g;
+      g.growTo(l.sz);
+      for(vert_id v = 0; v < l.sz; v++)
+        row_ops_t::join(g.row(v), l.row(v), r.row(v), l.sz);
+      g.recount();
+      return g;
+    }
+
+    // Edges present in either graph, with the strongest weight
+    static DenseGraph<Wt> meet(const DenseGraph<Wt>& l, const DenseGraph<Wt>& r)
+    {
+      assert(l.size() == r.size());
+      DenseGraph<Wt> g;
+      g.growTo(l.sz);
+      for(vert_id v = 0; v < l.sz; v++)
+        row_ops_t::meet(g.row(v), l.row(v), r.row(v), l.sz);
+      g.recount();
+      return g;
+    }
+
+    // Edges of l which are not weakened in r. The sources of the
+    // dropped edges are added to unstable.
+    static DenseGraph<Wt> widen(const DenseGraph<Wt>& l, const DenseGraph<Wt>& r,
+                                std::vector<vert_id>& unstable)
+    {
+      assert(l.size() == r.size());
+      DenseGraph<Wt> g;
+      g.growTo(l.sz);
+      for(vert_id v = 0; v < l.sz; v++)
+      {
+        if(row_ops_t::widen(g.row(v), l.row(v), r.row(v), l.sz))
+          unstable.push_back(v);
+      }
+      g.recount();
+      return g;
+    }
+
+    // Shortest paths from and to v using at most one other edge,
+    // assuming the graph without v is closed. Vertex ex is ignored.
+    template<class Delta>
+    void close_after_assign(vert_id v, vert_id ex, Delta& delta)
+    {
+      std::vector<Wt> dist(row(v), row(v) + sz);
+      for(vert_id k = 0; k < sz; k++)
+      {
+        Wt w = row(v)[k];
+        if(w != infty() && k != ex && k != v)
+          row_ops_t::relax(dist.data(), w, row(k), sz);
+      }
+      for(vert_id d = 0; d < sz; d++)
+      {
+        if(dist[d] != infty() && d != v && d != ex)
+          delta.push_back(std::make_pair(std::make_pair(v, d), dist[d]));
+      }
+
+      // The edges into v, with a zero weight for v itself so the
+      // direct edges are also considered.
+      for(vert_id k = 0; k < sz; k++)
+        dist[k] = (k == ex) ? infty() : row(k)[v];
+      dist[v] = Wt(0);
+      for(vert_id s = 0; s < sz; s++)
+      {
+        if(s == v || s == ex || is_free[s])
+          continue;
+        Wt w = row_ops_t::min_plus(row(s), dist.data(), sz);
+        if(w != infty())
+          delta.push_back(std::make_pair(std::make_pair(s, v), w));
+      }
+    }
+
+    class vert_iterator {
+    public:
+      vert_iterator(vert_id _v, const std::vector<bool>& _is_free)
+        : v(_v), is_free(_is_free)
+      { }
+      vert_id operator*(void) const { return v; }
+      bool operator!=(const vert_iterator& o) {
+        while(v < o.v && is_free[v])
+          ++v;
+        return v < o.v;
+      }
+      vert_iterator& operator++(void) { ++v; return *this; }
+
+      vert_id v;
+      const std::vector<bool>& is_free;
+    };
+    class vert_range {
+    public:
+      vert_range(const std::vector<bool>& _is_free)
+        : is_free(_is_free)
+      { }
+
+      vert_iterator begin(void) const { return vert_iterator(0, is_free); }
+      vert_iterator end(void) const { return vert_iterator(is_free.size(), is_free); }
+
+      size_t size(void) const { return is_free.size(); }
+      const std::vector<bool>& is_free;
+    };
+    vert_range verts(void) const { return vert_range(is_free); }
+
+    class edge_ref_t {
+    public:
+      edge_ref_t(vert_id _vert, Wt& _val)
+        : vert(_vert), val(_val)
+      { }
+      vert_id vert;
+      Wt& val;
+    };
+
+    // Iterates over the present entries of a row (step = 1) or of a
+    // column (step = cap) of the matrix.
+    class adj_iterator {
+    public:
+      adj_iterator(Wt* _base, size_t _step, vert_id _v)
+        : base(_base), step(_step), v(_v)
+      { }
+      adj_iterator(void)
+        : base(nullptr), step(0), v(0)
+      { }
+
+      static adj_iterator empty_iterator () { return adj_iterator(); }
+
+      vert_id operator*(void) const { return v; }
+      adj_iterator& operator++(void) { ++v; return *this; }
+      bool operator!=(const adj_iterator& o) {
+        while(v < o.v && base[v*step] == infty())
+          ++v;
+        return v < o.v;
+      }
+
+      Wt* base;
+      size_t step;
+      vert_id v;
+    };
+
+    class edge_iter : public adj_iterator {
+    public:
+      typedef edge_ref_t edge_ref;
+      edge_iter(Wt* _base, size_t _step, vert_id _v)
+        : adj_iterator(_base, _step, _v)
+      { }
+      edge_iter(void) { }
+
+      static edge_iter empty_iterator () { return edge_iter(); }
+
+      edge_ref operator*(void) const {
+        return edge_ref(this->v, this->base[this->v*this->step]);
+      }
+      edge_iter& operator++(void) { ++this->v; return *this; }
+    };
+
+    template<class It>
+    class adj_range {
+    public:
+      typedef It iterator;
+      adj_range(Wt* _base, size_t _step, vert_id _sz)
+        : base(_base), step(_step), sz(_sz)
+      { }
+
+      It begin(void) const { return It(base, step, 0); }
+      It end(void) const { return It(base, step, sz); }
+      size_t size(void) const {
+        size_t c = 0;
+        for(vert_id v = 0; v < sz; v++)
+          c += (base[v*step] != infty());
+        return c;
+      }
+
+      Wt* base;
+      size_t step;
+      vert_id sz;
+    };
+
+    typedef adj_range<adj_iterator> adj_range_t;
+    typedef adj_range<edge_iter> edge_range_t;
+
+    typedef edge_iter fwd_edge_iter;
+    typedef edge_iter rev_edge_iter;
+
+    typedef adj_range_t pred_range;
+    typedef adj_range_t succ_range;
+
+    adj_range_t succs(vert_id v) { return adj_range_t(row(v), 1, sz); }
+    adj_range_t preds(vert_id v) { return adj_range_t(mtx + v, cap, sz); }
+
+    typedef edge_range_t fwd_edge_range;
+    typedef edge_range_t rev_edge_range;
+
+    edge_range_t e_succs(vert_id v) { return edge_range_t(row(v), 1, sz); }
+    edge_range_t e_preds(vert_id v) { return edge_range_t(mtx + v, cap, sz); }
+
+    typedef edge_range_t e_pred_range;
+    typedef edge_range_t e_succ_range;
+
+    // Management
+    bool is_empty(void) const { return edge_count == 0; }
+    size_t num_edges(void) const { return edge_count; }
+    size_t size(void) const { return sz; }
+    vert_id new_vertex(void) {
+      vert_id v;
+      if(free_id.size() > 0)
+      {
+        v = free_id.back();
+        assert(v < sz);
+        free_id.pop_back();
+        is_free[v] = false;
+      } else {
+        grow_cap(sz + 1);
+        v = sz++;
+        is_free.push_back(false);
+      }
+      return v;
+    }
+
+    void growTo(vert_id v) {
+      while(size() < v)
+        new_vertex();
+    }
+
+    void forget(vert_id v)
+    {
+      if(is_free[v])
+        return;
+
+      Wt* r = row(v);
+      for(vert_id d = 0; d < sz; d++)
+      {
+        if(r[d] != infty())
+        {
+          r[d] = infty();
+          edge_count--;
+        }
+        Wt& w = row(d)[v];
+        if(w != infty())
+        {
+          w = infty();
+          edge_count--;
+        }
+      }
+      is_free[v] = true;
+      free_id.push_back(v);
+    }
+
+    void clear_edges(void) {
+      if(mtx)
+        std::fill(mtx, mtx + cap*cap, infty());
+      edge_count = 0;
+    }
+
+    void clear(void)
+    {
+      clear_edges();
+      sz = 0;
+      is_free.clear();
+      free_id.clear();
+    }
+
+    bool elem(vert_id s, vert_id d)
+    {
+      return row(s)[d] != infty();
+    }
+
+    Wt& edge_val(vert_id s, vert_id d)
+    {
+      return row(s)[d];
+    }
+
+    class mut_val_ref_t {
+     public:
+
+      mut_val_ref_t(): w(nullptr) { }
+      operator Wt () const { assert (w); return *w; }
+      void operator=(Wt* _w) { w = _w; }
+      void operator=(Wt _w) { assert (w); *w = _w; }
+
+     private:
+      Wt* w;
+    };
+
+    bool lookup(vert_id s, vert_id d, mut_val_ref_t* w)
+    {
+      Wt& x = row(s)[d];
+      if(x == infty())
+        return false;
+      (*w) = &x;
+      return true;
+    }
+
+    // Assumption: (s, d) is not in the graph
+    void add_edge(vert_id s, Wt w, vert_id d)
+    {
+      assert(row(s)[d] == infty());
+      row(s)[d] = w;
+      edge_count++;
+    }
+
+    template<class Op>
+    void update_edge(vert_id s, Wt w, vert_id d, Op& op)
+    {
+      Wt& x = row(s)[d];
+      if(x != infty())
+      {
+        x = op.apply(x, w);
+      } else {
+        if(!op.default_is_absorbing())
+          add_edge(s, w, d);
+      }
+    }
+
+    void set_edge(vert_id s, Wt w, vert_id d)
+    {
+      Wt& x = row(s)[d];
+      if(x == infty())
+        edge_count++;
+      x = w;
+    }
+
+    void write(crab_os& o) {
+      o << "[|";
+      bool first = true;
+      for(vert_id v : verts())
+      {
+        auto it = e_succs(v).begin();
+        auto end = e_succs(v).end();
+
+        if(it != end)
+        {
+          if(first)
+            first = false;
+          else
+            o << ", ";
+
+          o << "[v" << v << " -> ";
+          o << "(" << (*it).val << ":" << (*it).vert << ")";
+          for(++it; it != end; ++it)
+          {
+            o << ", (" << (*it).val << ":" << (*it).vert << ")";
+          }
+          o << "]";
+        }
+      }
+      o << "|]";
+    }
+
+  private:
+    // number of vertices and rows/columns allocated
+    size_t sz;
+    size_t cap;
+    Wt* mtx;
+
+    int edge_count;
+
+    std::vector<bool> is_free;
+    std::vector<vert_id> free_id;
+  };
+}
+#pragma GCC diagnostic pop
+#endif
@@ -1,6 +1,8 @@
 #ifndef CRAB_GRAPH_OPS_HPP
 #define CRAB_GRAPH_OPS_HPP
 #include <crab/domains/graphs/util/Heap.h>
+#include <crab/domains/graphs/dense_graph.hpp>
+#include <crab/domains/graphs/hybrid_graph.hpp>
 #include <boost/optional.hpp>
 //============================
 // A set of utility algorithms for manipulating graphs.
@@ -538,13 +540,15 @@ namespace crab {
     // Scratch space needed by the graph algorithms.
     // Should really switch to some kind of arena allocator, rather
     // than having all these static structures.
+    // They are thread-local so that graphs can be manipulated by
+    // analyses running on different threads.
     // ===========================================
-    static char* edge_marks;
+    static thread_local char* edge_marks;
 
     // Used for Bellman-Ford queueing
-    static vert_id* dual_queue;
-    static int* vert_marks;
-    static unsigned int scratch_sz;
+    static thread_local vert_id* dual_queue;
+    static thread_local int* vert_marks;
+    static thread_local unsigned int scratch_sz;
 
     // For locality, should combine dists & dist_ts.
     // Wt must have an empty constructor, but does _not_
@@ -552,11 +556,11 @@ namespace crab {
     // dist_ts tells us which distances are current,
     // and ts_idx prevents wraparound problems, in the unlikely
     // circumstance that we have more than 2^sizeof(uint) iterations.
-    static std::vector<Wt> dists;
-    static std::vector<Wt> dists_alt;
-    static std::vector<unsigned int> dist_ts;
-    static unsigned int ts; 
-    static unsigned int ts_idx;
+    static thread_local std::vector<Wt> dists;
+    static thread_local std::vector<Wt> dists_alt;
+    static thread_local std::vector<unsigned int> dist_ts;
+    static thread_local unsigned int ts; 
+    static thread_local unsigned int ts_idx;
 
     static void grow_scratch(unsigned int sz) {
       if(sz <= scratch_sz)
@@ -673,6 +677,109 @@ r_not_dom:
       return g;
     }
 
+    // Dense graphs are combined row by row by DenseGraph. The
+    // permuted views are first gathered into dense graphs.
+    typedef DenseGraph<Wt> dense_t;
+    typedef GraphPerm<dense_t> dense_perm_t;
+
+    static dense_t& to_dense(dense_t& g, dense_t& tmp) { return g; }
+    static dense_t& to_dense(dense_perm_t& g, dense_t& tmp)
+    {
+      tmp = dense_t::permute(g.perm, g.g);
+      return tmp;
+    }
+
+    static dense_t join(dense_t& l, dense_t& r)
+    {
+      return dense_t::join(l, r);
+    }
+
+    static dense_t meet(dense_perm_t& l, dense_t& r, bool& is_closed)
+    {
+      dense_t tl;
+      is_closed = false;
+      return dense_t::meet(to_dense(l, tl), r);
+    }
+
+    static dense_t meet(dense_perm_t& l, dense_perm_t& r, bool& is_closed)
+    {
+      dense_t tl, tr;
+      is_closed = false;
+      return dense_t::meet(to_dense(l, tl), to_dense(r, tr));
+    }
+
+    static dense_t widen(dense_perm_t& l, dense_perm_t& r, std::vector<vert_id>& unstable)
+    {
+      dense_t tl, tr;
+      return dense_t::widen(to_dense(l, tl), to_dense(r, tr), unstable);
+    }
+
+    // Hybrid graphs use the dense kernels if one of the operands is
+    // dense, converting the other one, and the generic operations
+    // otherwise.
+    typedef HybridGraph<Wt> hybrid_t;
+    typedef GraphPerm<hybrid_t> hybrid_perm_t;
+
+    static bool is_dense(hybrid_t& g) { return g.is_dense(); }
+    static bool is_dense(hybrid_perm_t& g) { return g.g.is_dense(); }
+
+    static dense_t& to_dense(hybrid_t& g, dense_t& tmp)
+    {
+      if(g.is_dense())
+        return g.dense();
+      tmp = dense_t::copy(g);
+      return tmp;
+    }
+    static dense_t& to_dense(hybrid_perm_t& g, dense_t& tmp)
+    {
+      if(g.g.is_dense())
+        tmp = dense_t::permute(g.perm, g.g.dense());
+      else
+        tmp = dense_t::copy(g);
+      return tmp;
+    }
+
+    static hybrid_t join(hybrid_t& l, hybrid_t& r)
+    {
+      if(!is_dense(l) && !is_dense(r))
+        return join<hybrid_t, hybrid_t>(l, r);
+      dense_t tl, tr;
+      return hybrid_t(dense_t::join(to_dense(l, tl), to_dense(r, tr)));
+    }
+
+    static hybrid_t meet(hybrid_perm_t& l, hybrid_t& r, bool& is_closed)
+    {
+      if(!is_dense(l) && !is_dense(r))
+        return meet<hybrid_perm_t, hybrid_t>(l, r, is_closed);
+      dense_t tl, tr;
+      is_closed = false;
+      return hybrid_t(dense_t::meet(to_dense(l, tl), to_dense(r, tr)));
+    }
+
+    static hybrid_t meet(hybrid_perm_t& l, hybrid_perm_t& r, bool& is_closed)
+    {
+      if(!is_dense(l) && !is_dense(r))
+        return meet<hybrid_perm_t, hybrid_perm_t>(l, r, is_closed);
+      dense_t tl, tr;
+      is_closed = false;
+      return hybrid_t(dense_t::meet(to_dense(l, tl), to_dense(r, tr)));
+    }
+
+    static hybrid_t widen(hybrid_perm_t& l, hybrid_perm_t& r, std::vector<vert_id>& unstable)
+    {
+      if(!is_dense(l) && !is_dense(r))
+        return widen<hybrid_perm_t, hybrid_perm_t>(l, r, unstable);
+      dense_t tl, tr;
+      return hybrid_t(dense_t::widen(to_dense(l, tl), to_dense(r, tr), unstable));
+    }
+
+    // Change the representation of g according to its density.
+    // Return 1 if g became dense, -1 if it became sparse and 0
+    // otherwise.
+    template<class G>
+    static int rebalance(G& g) { return 0; }
+    static int rebalance(hybrid_t& g) { return g.rebalance(); }
+
     // Compute the strongly connected components
     // Duped pretty much verbatim from Wikipedia
     // Abuses 'dual_queue' to store indices.
@@ -1356,32 +1463,62 @@ r_not_dom:
       for(auto p : aux)
         delta.push_back( std::make_pair( std::make_pair(p.first, v), p.second ) );
     }
+
+    template<class P>
+    static void close_after_assign(dense_t& g, P& p, vert_id v, edge_vector& delta)
+    {
+      g.close_after_assign(v, (vert_id) -1, delta);
+    }
+
+    template<class P>
+    static void close_after_assign(SubGraph<dense_t>& g, P& p, vert_id v, edge_vector& delta)
+    {
+      g.g.close_after_assign(v, g.v_ex, delta);
+    }
+
+    template<class P>
+    static void close_after_assign(hybrid_t& g, P& p, vert_id v, edge_vector& delta)
+    {
+      if(g.is_dense())
+        g.dense().close_after_assign(v, (vert_id) -1, delta);
+      else
+        close_after_assign<hybrid_t, P>(g, p, v, delta);
+    }
+
+    template<class P>
+    static void close_after_assign(SubGraph<hybrid_t>& g, P& p, vert_id v, edge_vector& delta)
+    {
+      if(g.g.is_dense())
+        g.g.dense().close_after_assign(v, g.v_ex, delta);
+      else
+        close_after_assign<SubGraph<hybrid_t>, P>(g, p, v, delta);
+    }
   };
 
   // Static data allocation
   template<class Wt>
-  char* GraphOps<Wt>::edge_marks = NULL;
+  thread_local char* GraphOps<Wt>::edge_marks = NULL;
 
   // Used for Bellman-Ford queueing
   template<class Wt>
-  typename GraphOps<Wt>::vert_id* GraphOps<Wt>::dual_queue = NULL;
+  thread_local typename GraphOps<Wt>::vert_id* GraphOps<Wt>::dual_queue = NULL;
 
   template<class Wt>
-  int* GraphOps<Wt>::vert_marks = NULL;
+  thread_local int* GraphOps<Wt>::vert_marks = NULL;
 
   template<class Wt>
-  unsigned int GraphOps<Wt>::scratch_sz = 0;
+  thread_local unsigned int GraphOps<Wt>::scratch_sz = 0;
 
   template<class G>
-  std::vector<typename G::Wt> GraphOps<G>::dists;
+  thread_local std::vector<typename G::Wt> GraphOps<G>::dists;
   template<class G>
-  std::vector<typename G::Wt> GraphOps<G>::dists_alt;
+  thread_local std::vector<typename G::Wt> GraphOps<G>::dists_alt;
   template<class G>
-  std::vector<unsigned int> GraphOps<G>::dist_ts;
+  thread_local std::vector<unsigned int> GraphOps<G>::dist_ts;
   template<class G>
-  unsigned int GraphOps<G>::ts = 0;
+  thread_local unsigned int GraphOps<G>::ts = 0;
   template<class G>
-  unsigned int GraphOps<G>::ts_idx = 0;
+  thread_local unsigned int GraphOps<G>::ts_idx = 0;
 
 } // namespace crab
 #pragma GCC diagnostic pop
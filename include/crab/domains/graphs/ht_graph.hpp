@@ -322,7 +322,7 @@ class HtGraph : public ikos::writeable {
       // for the "empty" iterator, otherwise we can trigger
       // undefined behavior.
       static iter_t empty_iterator () { 
-	static std::unique_ptr<iter_t> it = nullptr;
+	static thread_local std::unique_ptr<iter_t> it = nullptr;
 	if (!it)
 	  it = std::unique_ptr<iter_t>(new iter_t ());
 	return *it;
@@ -409,7 +409,7 @@ class HtGraph : public ikos::writeable {
       // for the "empty" iterator, otherwise we can trigger
       // undefined behavior.
       static fwd_edge_iterator empty_iterator () { 
-	static std::unique_ptr<fwd_edge_iterator> it = nullptr;
+	static thread_local std::unique_ptr<fwd_edge_iterator> it = nullptr;
 	if (!it)
 	  it = std::unique_ptr<fwd_edge_iterator>(new fwd_edge_iterator ());
 	return *it;
@@ -0,0 +1,302 @@
+#ifndef CRAB_HYBRID_GRAPH_HPP
+#define CRAB_HYBRID_GRAPH_HPP
+#include <crab/domains/graphs/adapt_sgraph.hpp>
+#include <crab/domains/graphs/dense_graph.hpp>
+#include <boost/optional.hpp>
+
+/* A weighted graph which is represented either as an adaptive
+ * sparse graph or as a dense matrix, depending on its density.
+ *
+ * The representation is only changed by rebalance(), which the
+ * clients call at points where the graph has been rebuilt (e.g.,
+ * after a join or a widening). A sparse graph becomes dense when at
+ * least half of the possible edges are present, and a dense graph
+ * becomes sparse again when less than a quarter are present, so
+ * graphs whose density oscillates around a single threshold do not
+ * switch back and forth. Large graphs are always sparse.
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace crab {
+
+  template<class Weight>
+  class HybridGraph : public ikos::writeable {
+  public:
+    typedef Weight Wt;
+    typedef HybridGraph<Wt> graph_t;
+    typedef unsigned int vert_id;
+
+    typedef AdaptGraph<Wt> sparse_t;
+    typedef DenseGraph<Wt> dense_t;
+
+    // Thresholds for rebalance(), in percents of the possible edges
+    enum { to_dense_density = 50, to_sparse_density = 25 };
+    // Graphs with more vertices are always sparse
+    enum { max_dense_size = 128 };
+
+    HybridGraph(void)
+      : _is_dense(false)
+    { }
+
+    HybridGraph(sparse_t&& g)
+      : _is_dense(false), _sparse(std::move(g))
+    { }
+
+    HybridGraph(dense_t&& g)
+      : _is_dense(true), _dense(std::move(g))
+    { }
+
+    template<class G>
+    static HybridGraph<Wt> copy(const G& o)
+    {
+      return HybridGraph<Wt>(sparse_t::copy(o));
+    }
+
+    bool is_dense(void) const { return _is_dense; }
+    sparse_t& sparse(void) { assert(!_is_dense); return _sparse; }
+    dense_t& dense(void) { assert(_is_dense); return _dense; }
+
+    size_t num_edges(void) const {
+      return _is_dense ? _dense.num_edges() : _sparse.edge_count;
+    }
+
+    // Change the representation of the graph according to its
+    // density. Return 1 if the graph became dense, -1 if it became
+    // sparse and 0 otherwise.
+    int rebalance(void)
+    {
+      size_t n = 0;
+      for(vert_id v : verts())
+        n++;
+      if(n < 2)
+        return 0;
+      size_t max_edges = n*(n-1);
+
+      if(!_is_dense)
+      {
+        if(n > max_dense_size || 100*num_edges() < to_dense_density*max_edges)
+          return 0;
+        _dense = convert<dense_t>(_sparse);
+        _sparse = sparse_t();
+        _is_dense = true;
+        return 1;
+      } else {
+        if(n <= max_dense_size && 100*num_edges() >= to_sparse_density*max_edges)
+          return 0;
+        _sparse = convert<sparse_t>(_dense);
+        _dense = dense_t();
+        _is_dense = false;
+        return -1;
+      }
+    }
+
+    // The vertices are the same in both representations
+    typedef typename sparse_t::vert_iterator vert_iterator;
+    typedef typename sparse_t::vert_range vert_range;
+    vert_range verts(void) const {
+      return vert_range(_is_dense ? _dense.verts().is_free : _sparse.is_free);
+    }
+
+    class edge_ref_t {
+    public:
+      edge_ref_t(vert_id _vert, Wt& _val)
+        : vert(_vert), val(_val)
+      { }
+      vert_id vert;
+      Wt& val;
+    };
+
+    // Iterators over the adjacencies of one of the representations
+    template<class SIt, class DIt>
+    class adj_iterator {
+    public:
+      adj_iterator(void)
+        : is_dense(false), s(SIt::empty_iterator())
+      { }
+      adj_iterator(const SIt& _s)
+        : is_dense(false), s(_s)
+      { }
+      adj_iterator(const DIt& _d)
+        : is_dense(true), d(_d)
+      { }
+
+      static adj_iterator empty_iterator () { return adj_iterator(); }
+
+      vert_id operator*(void) const { return is_dense ? *d : *s; }
+      adj_iterator& operator++(void) {
+        if(is_dense) ++d; else ++s;
+        return *this;
+      }
+      bool operator!=(const adj_iterator& o) {
+        return is_dense ? d != o.d : s != o.s;
+      }
+
+    protected:
+      bool is_dense;
+      SIt s;
+      DIt d;
+    };
+
+    template<class SIt, class DIt>
+    class edge_iter : public adj_iterator<SIt, DIt> {
+      typedef adj_iterator<SIt, DIt> adj_iterator_t;
+    public:
+      typedef edge_ref_t edge_ref;
+
+      edge_iter(void) { }
+      edge_iter(const SIt& _s) : adj_iterator_t(_s) { }
+      edge_iter(const DIt& _d) : adj_iterator_t(_d) { }
+
+      static edge_iter empty_iterator () { return edge_iter(); }
+
+      edge_ref operator*(void) const {
+        if(this->is_dense) {
+          auto e = *(this->d);
+          return edge_ref(e.vert, e.val);
+        } else {
+          auto e = *(this->s);
+          return edge_ref(e.vert, e.val);
+        }
+      }
+      edge_iter& operator++(void) {
+        adj_iterator_t::operator++();
+        return *this;
+      }
+    };
+
+    template<class SR, class DR, class It>
+    class adj_range {
+    public:
+      typedef It iterator;
+      adj_range(const SR& _s) : s(_s) { }
+      adj_range(const DR& _d) : d(_d) { }
+
+      It begin(void) const { return d ? It((*d).begin()) : It((*s).begin()); }
+      It end(void) const { return d ? It((*d).end()) : It((*s).end()); }
+      size_t size(void) const { return d ? (*d).size() : (*s).size(); }
+
+      boost::optional<SR> s;
+      boost::optional<DR> d;
+    };
+
+    typedef adj_range<typename sparse_t::adj_range_t, typename dense_t::adj_range_t,
+                      adj_iterator<typename sparse_t::adj_range_t::iterator,
+                                   typename dense_t::adj_range_t::iterator> > adj_range_t;
+    typedef adj_range<typename sparse_t::edge_range_t, typename dense_t::edge_range_t,
+                      edge_iter<typename sparse_t::edge_range_t::iterator,
+                                typename dense_t::edge_range_t::iterator> > edge_range_t;
+
+    typedef adj_range_t pred_range;
+    typedef adj_range_t succ_range;
+
+    adj_range_t succs(vert_id v) {
+      return _is_dense ? adj_range_t(_dense.succs(v)) : adj_range_t(_sparse.succs(v));
+    }
+    adj_range_t preds(vert_id v) {
+      return _is_dense ? adj_range_t(_dense.preds(v)) : adj_range_t(_sparse.preds(v));
+    }
+
+    typedef typename edge_range_t::iterator fwd_edge_iter;
+    typedef typename edge_range_t::iterator rev_edge_iter;
+
+    typedef edge_range_t fwd_edge_range;
+    typedef edge_range_t rev_edge_range;
+
+    edge_range_t e_succs(vert_id v) {
+      return _is_dense ? edge_range_t(_dense.e_succs(v)) : edge_range_t(_sparse.e_succs(v));
+    }
+    edge_range_t e_preds(vert_id v) {
+      return _is_dense ? edge_range_t(_dense.e_preds(v)) : edge_range_t(_sparse.e_preds(v));
+    }
+
+    typedef edge_range_t e_pred_range;
+    typedef edge_range_t e_succ_range;
+
+    // Management
+    bool is_empty(void) const { return num_edges() == 0; }
+    size_t size(void) const { return _is_dense ? _dense.size() : _sparse.size(); }
+    vert_id new_vertex(void) {
+      return _is_dense ? _dense.new_vertex() : _sparse.new_vertex();
+    }
+
+    void growTo(vert_id v) {
+      if(_is_dense) _dense.growTo(v); else _sparse.growTo(v);
+    }
+
+    void forget(vert_id v) {
+      if(_is_dense) _dense.forget(v); else _sparse.forget(v);
+    }
+
+    void clear_edges(void) {
+      if(_is_dense) _dense.clear_edges(); else _sparse.clear_edges();
+    }
+
+    void clear(void) {
+      _dense.clear();
+      _sparse.clear();
+      _is_dense = false;
+    }
+
+    bool elem(vert_id s, vert_id d) {
+      return _is_dense ? _dense.elem(s, d) : _sparse.elem(s, d);
+    }
+
+    Wt& edge_val(vert_id s, vert_id d) {
+      return _is_dense ? _dense.edge_val(s, d) : _sparse.edge_val(s, d);
+    }
+
+    typedef typename sparse_t::mut_val_ref_t mut_val_ref_t;
+
+    bool lookup(vert_id s, vert_id d, mut_val_ref_t* w)
+    {
+      if(!_is_dense)
+        return _sparse.lookup(s, d, w);
+      if(!_dense.elem(s, d))
+        return false;
+      (*w) = &(_dense.edge_val(s, d));
+      return true;
+    }
+
+    void add_edge(vert_id s, Wt w, vert_id d) {
+      if(_is_dense) _dense.add_edge(s, w, d); else _sparse.add_edge(s, w, d);
+    }
+
+    template<class Op>
+    void update_edge(vert_id s, Wt w, vert_id d, Op& op) {
+      if(_is_dense) _dense.update_edge(s, w, d, op); else _sparse.update_edge(s, w, d, op);
+    }
+
+    void set_edge(vert_id s, Wt w, vert_id d) {
+      if(_is_dense) _dense.set_edge(s, w, d); else _sparse.set_edge(s, w, d);
+    }
+
+    void write(crab_os& o) {
+      if(_is_dense) _dense.write(o); else _sparse.write(o);
+    }
+
+  private:
+    // Copy g into another representation, keeping its free vertices
+    template<class To, class From>
+    static To convert(From& g)
+    {
+      To res(To::copy(g));
+      std::vector<bool> is_free(g.size(), true);
+      for(vert_id v : g.verts())
+        is_free[v] = false;
+      for(vert_id v = 0; v < g.size(); v++)
+      {
+        if(is_free[v])
+          res.forget(v);
+      }
+      return res;
+    }
+
+    bool _is_dense;
+    sparse_t _sparse;
+    dense_t _dense;
+  };
+}
+#pragma GCC diagnostic pop
+#endif
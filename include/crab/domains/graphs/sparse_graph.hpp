@@ -427,7 +427,7 @@ class SparseWtGraph : public ikos::writeable {
       // for the "empty" iterator, otherwise we can trigger
       // undefined behavior.
       static adj_iterator empty_iterator () { 
-	static std::unique_ptr<adj_iterator> it = nullptr;
+	static thread_local std::unique_ptr<adj_iterator> it = nullptr;
 	if (!it)
 	  it = std::unique_ptr<adj_iterator>(new adj_iterator ());
 	return *it;
@@ -453,7 +453,7 @@ class SparseWtGraph : public ikos::writeable {
       // for the "empty" iterator, otherwise we can trigger
       // undefined behavior.
       static fwd_edge_iterator empty_iterator () { 
-	static std::unique_ptr<fwd_edge_iterator> it = nullptr;
+	static thread_local std::unique_ptr<fwd_edge_iterator> it = nullptr;
 	if (!it)
 	  it = std::unique_ptr<fwd_edge_iterator>(new fwd_edge_iterator ());
 	return *it;
@@ -1223,13 +1223,13 @@ namespace ikos {
 
     interval_domain(const interval_domain_t& e): 
       _env(e._env) { 
-      crab::CrabStats::count (getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+      CRAB_STATS_SCOPE (getDomainName() + ".copy");
     }
 
     interval_domain_t& operator=(const interval_domain_t& o) {
-      crab::CrabStats::count (getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+      CRAB_STATS_SCOPE (getDomainName() + ".copy");
       if (this != &o)
         this->_env = o._env;
       return *this;
@@ -1252,63 +1252,63 @@ namespace ikos {
     }
 
     bool operator<=(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.leq");
-      crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+      CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+      CRAB_STATS_SCOPE (getDomainName() + ".leq");
       return (this->_env <= e._env);
     }
 
     void operator|=(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      CRAB_STATS_COUNT (getDomainName() + ".count.join");
+      CRAB_STATS_SCOPE (getDomainName() + ".join");
       this->_env = this->_env | e._env;
     }
 
     interval_domain_t operator|(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      CRAB_STATS_COUNT (getDomainName() + ".count.join");
+      CRAB_STATS_SCOPE (getDomainName() + ".join");
       return (this->_env | e._env);
     }
 
     interval_domain_t operator&(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.meet");
-      crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+      CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+      CRAB_STATS_SCOPE (getDomainName() + ".meet");
       return (this->_env & e._env);
     }
 
     interval_domain_t operator||(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+      CRAB_STATS_SCOPE (getDomainName() + ".widening");
       return (this->_env || e._env);
     }
 
     template<typename Thresholds>
     interval_domain_t widening_thresholds (interval_domain_t e, const Thresholds &ts) {
-      crab::CrabStats::count (getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+      CRAB_STATS_SCOPE (getDomainName() + ".widening");
       return this->_env.widening_thresholds (e._env, ts);
     }
 
     interval_domain_t operator&&(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.narrowing");
-      crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+      CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+      CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
       return (this->_env && e._env);
     }
 
     void set(VariableName v, interval_t i) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+      CRAB_STATS_SCOPE (getDomainName() + ".assign");
       this->_env.set(v, i);
     }
 
     void set(VariableName v, Number n) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+      CRAB_STATS_SCOPE (getDomainName() + ".assign");
       this->_env.set(v, interval_t(n));
     }
 
     void operator-=(VariableName v) {
-      crab::CrabStats::count (getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+      CRAB_STATS_SCOPE (getDomainName() + ".forget");
       this->_env -= v;
     }
     
@@ -1327,8 +1327,8 @@ namespace ikos {
     }
     
     void operator+=(linear_constraint_system_t csts) {
-      crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-      crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+      CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+      CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
       this->add(csts);
     }
 
@@ -1347,8 +1347,8 @@ namespace ikos {
     }
     
     void assign(VariableName x, linear_expression_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+      CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
       if (boost::optional<variable_t> v = e.get_variable ()) {
         this->_env.set(x, this->_env [(*v).name ()]);
@@ -1364,8 +1364,8 @@ namespace ikos {
     }
 
     void apply(operation_t op, VariableName x, VariableName y, VariableName z) {
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi = this->_env[z];
@@ -1393,8 +1393,8 @@ namespace ikos {
     }
 
     void apply(operation_t op, VariableName x, VariableName y, Number k) {
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi(k);
@@ -1424,8 +1424,8 @@ namespace ikos {
     // bitwise_operators_api
     
     void apply(conv_operation_t op, VariableName x, VariableName y, unsigned width){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t xi = interval_t::bottom();
@@ -1446,8 +1446,8 @@ namespace ikos {
     }
 
     void apply(conv_operation_t op, VariableName x, Number k, unsigned width){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi(k);
       interval_t xi = interval_t::bottom();
@@ -1468,8 +1468,8 @@ namespace ikos {
     }
 
     void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi = this->_env[z];
@@ -1507,8 +1507,8 @@ namespace ikos {
     }
     
     void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi(k);
@@ -1547,8 +1547,8 @@ namespace ikos {
     // division_operators_api
     
     void apply(div_operation_t op, VariableName x, VariableName y, VariableName z){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi = this->_env[z];
@@ -1579,8 +1579,8 @@ namespace ikos {
     }
 
     void apply(div_operation_t op, VariableName x, VariableName y, Number k){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+      CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
       interval_t yi = this->_env[y];
       interval_t zi(k);
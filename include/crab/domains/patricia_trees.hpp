@@ -44,12 +44,17 @@
 #define IKOS_PATRICIA_TREES_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
-#include <boost/shared_ptr.hpp>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
 #include <crab/common/types.hpp>
+#include <crab/common/pool.hpp>
 
 namespace ikos {
 
@@ -135,11 +140,28 @@ inline bool match_prefix(index_t k, index_t p, index_t m) {
 
 class failed {};
 
+// Hash-consing of trees (disabled by default): structurally equal
+// trees built while it is enabled are the same object so that
+// operations on them take constant time.
+inline std::atomic< bool >& hash_consing_flag() {
+  static std::atomic< bool > flag(false);
+  return flag;
+}
+
+template < typename Key, typename Value >
+class node;
+
+template < typename Key, typename Value >
+class leaf;
+
 template < typename Key, typename Value >
 class tree {
+  friend class node< Key, Value >;
+  friend class leaf< Key, Value >;
+
 public:
   typedef tree< Key, Value > tree_t;
-  typedef boost::shared_ptr< tree_t > tree_ptr;
+  typedef boost::intrusive_ptr< tree_t > tree_ptr;
   typedef tree_ptr ptr;
   typedef unary_op< Value > unary_op_t;
   typedef binary_op< Value > binary_op_t;
@@ -166,6 +188,91 @@ public:
   static tree_ptr remove(tree_ptr, const Key&);
   static void compare(tree_ptr, tree_ptr, partial_order_t&, bool);
 
+private:
+  // Trees are reference counted. The counters are atomic since trees
+  // can be shared by analyses running on different threads.
+  mutable std::atomic< std::size_t > _ref_count;
+  // whether the tree is in the hash-consing table
+  bool _hashed;
+
+  // Table of the hash-consed trees. It is never destroyed since trees
+  // can be released by static destructors.
+  struct hash_table {
+    std::mutex mutex;
+    std::unordered_multimap< std::size_t, tree_t* > trees;
+  };
+
+  static hash_table& table() {
+    static hash_table* t = new hash_table();
+    return *t;
+  }
+
+  static std::size_t hash_node(index_t prefix,
+                               index_t branching_bit,
+                               const tree_t* left_branch,
+                               const tree_t* right_branch) {
+    std::size_t h = std::hash< index_t >()(prefix);
+    h = h * 31 + std::hash< index_t >()(branching_bit);
+    h = h * 31 + std::hash< const tree_t* >()(left_branch);
+    return h * 31 + std::hash< const tree_t* >()(right_branch);
+  }
+
+  static std::size_t hash_leaf(index_t key) {
+    return std::hash< index_t >()(key) * 31 + 1;
+  }
+
+  std::size_t hash() const {
+    if (is_leaf()) {
+      return hash_leaf(prefix());
+    } else {
+      return hash_node(prefix(),
+                       branching_bit(),
+                       left_branch().get(),
+                       right_branch().get());
+    }
+  }
+
+  // Acquire a reference to a tree of the table unless it is being
+  // destroyed
+  bool try_add_ref() const {
+    std::size_t n = this->_ref_count.load(std::memory_order_relaxed);
+    while (n > 0) {
+      if (this->_ref_count.compare_exchange_weak(n, n + 1,
+                                                 std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void unhash() const {
+    hash_table& ht = table();
+    std::lock_guard< std::mutex > lock(ht.mutex);
+    auto range = ht.trees.equal_range(hash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == this) {
+        ht.trees.erase(it);
+        break;
+      }
+    }
+  }
+
+  friend void intrusive_ptr_add_ref(const tree_t* t) {
+    t->_ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  friend void intrusive_ptr_release(const tree_t* t) {
+    if (t->_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (t->_hashed) {
+        t->unhash();
+      }
+      delete t;
+    }
+  }
+
+protected:
+  tree() : _ref_count(0), _hashed(false) {}
+
 public:
   virtual std::size_t size() const = 0;
   virtual bool is_leaf() const = 0;
@@ -297,6 +404,14 @@ private:
   node_t& operator=(const node_t&);
 
 public:
+  static void* operator new(std::size_t) {
+    return crab::fixed_size_pool< sizeof(node_t) >::allocate();
+  }
+
+  static void operator delete(void* p) {
+    crab::fixed_size_pool< sizeof(node_t) >::deallocate(p);
+  }
+
   node(index_t prefix_,
        index_t branching_bit_,
        tree_ptr left_branch_,
@@ -365,8 +480,19 @@ private:
   leaf_t& operator=(const leaf_t&);
 
 public:
+  static void* operator new(std::size_t) {
+    return crab::fixed_size_pool< sizeof(leaf_t) >::allocate();
+  }
+
+  static void operator delete(void* p) {
+    crab::fixed_size_pool< sizeof(leaf_t) >::deallocate(p);
+  }
+
   leaf(const Key& key_, const Value& value_) : _key(key_), _value(value_) {}
 
+  // Some values do not declare operator== as const
+  bool has_value(const Value& value_) { return this->_value == value_; }
+
   std::size_t size() const { return 1; }
 
   index_t prefix() const { return this->_key.index(); }
@@ -405,10 +531,35 @@ typename tree< Key, Value >::ptr tree< Key, Value >::make_node(
   tree_ptr n;
   if (left_branch) {
     if (right_branch) {
+      if (!hash_consing_flag().load(std::memory_order_relaxed)) {
+        return tree_ptr(new node< Key, Value >(prefix,
+                                               branching_bit,
+                                               left_branch,
+                                               right_branch));
+      }
+      std::size_t h = hash_node(prefix,
+                                branching_bit,
+                                left_branch.get(),
+                                right_branch.get());
+      hash_table& ht = table();
+      std::lock_guard< std::mutex > lock(ht.mutex);
+      auto range = ht.trees.equal_range(h);
+      for (auto it = range.first; it != range.second; ++it) {
+        tree_t* t = it->second;
+        if (t->is_node() && t->prefix() == prefix &&
+            t->branching_bit() == branching_bit &&
+            t->left_branch() == left_branch &&
+            t->right_branch() == right_branch && t->try_add_ref()) {
+          n = tree_ptr(t, false);
+          return n;
+        }
+      }
       n = tree_ptr(new node< Key, Value >(prefix,
                                           branching_bit,
                                           left_branch,
                                           right_branch));
+      n->_hashed = true;
+      ht.trees.insert(std::make_pair(h, n.get()));
     } else {
       n = left_branch;
     }
@@ -426,7 +577,25 @@ template < typename Key, typename Value >
 typename tree< Key, Value >::ptr tree< Key, Value >::make_leaf(
     const Key& key, const Value& value) {
   typedef typename tree< Key, Value >::ptr tree_ptr;
-  return tree_ptr(new leaf< Key, Value >(key, value));
+  if (!hash_consing_flag().load(std::memory_order_relaxed)) {
+    return tree_ptr(new leaf< Key, Value >(key, value));
+  }
+  std::size_t h = hash_leaf(key.index());
+  hash_table& ht = table();
+  std::lock_guard< std::mutex > lock(ht.mutex);
+  auto range = ht.trees.equal_range(h);
+  for (auto it = range.first; it != range.second; ++it) {
+    tree_t* t = it->second;
+    if (t->is_leaf() && t->prefix() == key.index() &&
+        static_cast< leaf< Key, Value >* >(t)->has_value(value) &&
+        t->try_add_ref()) {
+      return tree_ptr(t, false);
+    }
+  }
+  tree_ptr l(new leaf< Key, Value >(key, value));
+  l->_hashed = true;
+  ht.trees.insert(std::make_pair(h, l.get()));
+  return l;
 }
 
 template < typename Key, typename Value >
@@ -1036,10 +1205,13 @@ void tree< Key, Value >::compare(typename tree< Key, Value >::ptr s,
               throw failed();
             }
           }
-          if (compare_left_to_right && po.default_is_top() && !t->is_leaf()) {
+          // t has bindings other than key if it is a node or a leaf
+          // with a different key
+          bool t_has_more = !t->is_leaf() || !value_;
+          if (compare_left_to_right && po.default_is_top() && t_has_more) {
             throw failed();
           }
-          if (!compare_left_to_right && !po.default_is_top() && !t->is_leaf()) {
+          if (!compare_left_to_right && !po.default_is_top() && t_has_more) {
             throw failed();
           }
         } else if (t->is_leaf()) {
@@ -1106,6 +1278,12 @@ void tree< Key, Value >::compare(typename tree< Key, Value >::ptr s,
 
 } // namespace patricia_trees_impl
 
+// Enable or disable the hash-consing of patricia trees. Trees built
+// before hash-consing is enabled are not shared.
+inline void patricia_tree_hash_consing(bool enable) {
+  patricia_trees_impl::hash_consing_flag().store(enable);
+}
+
 template < typename Key, typename Value >
 class patricia_tree {
 private:
@@ -1392,7 +1570,7 @@ public:
   }
 
   bool operator==(const patricia_tree_set_t& s) const {
-    return (this->operator<=(s) && s.operator<=(*this));
+    return (this->size() == s.size() && this->operator<=(s));
   }
 
   void write(crab::crab_os& o) {
@@ -43,20 +43,25 @@
 
 #include <crab/common/types.hpp>
 #include <crab/domains/patricia_trees.hpp>
+#include <crab/domains/flat_maps.hpp>
 
 namespace ikos {
   
-  template < typename Key, typename Value >
+  // Map is the representation of the environment: either a
+  // patricia_tree, a flat_map or an adaptive_map. By default small
+  // environments are flat maps and large ones patricia trees.
+  template < typename Key, typename Value,
+             typename Map = adaptive_map< Key, Value > >
   class separate_domain: public writeable {
     
   private:
-    typedef patricia_tree< Key, Value > patricia_tree_t;
+    typedef Map patricia_tree_t;
     typedef typename patricia_tree_t::unary_op_t unary_op_t;
     typedef typename patricia_tree_t::binary_op_t binary_op_t;
     typedef typename patricia_tree_t::partial_order_t partial_order_t;
 
   public:
-    typedef separate_domain< Key, Value > separate_domain_t;
+    typedef separate_domain< Key, Value, Map > separate_domain_t;
     typedef typename patricia_tree_t::iterator iterator;
     typedef Key key_type;
     typedef Value value_type;
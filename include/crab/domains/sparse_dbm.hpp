@@ -197,8 +197,8 @@ namespace crab {
           _is_bottom(false)
       {
 
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
 
         if(o._is_bottom)
           set_to_bottom();
@@ -234,8 +234,8 @@ namespace crab {
 
       SparseDBM_& operator=(const SparseDBM_& o)
       {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
 
         if(this != &o)
         {
@@ -325,8 +325,8 @@ namespace crab {
       }
     
       bool operator<=(DBM_t& o)  {
-        crab::CrabStats::count (getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+        CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
         // cover all trivial cases to avoid allocating a dbm matrix
         if (is_bottom()) 
@@ -475,8 +475,8 @@ namespace crab {
       }
 
       DBM_t operator|(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        CRAB_STATS_COUNT (getDomainName() + ".count.join");
+        CRAB_STATS_SCOPE (getDomainName() + ".join");
 
         if (is_bottom() || o.is_top ())
           return o;
@@ -566,8 +566,8 @@ namespace crab {
       }
 
       DBM_t operator||(DBM_t& o) {	
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
         if (is_bottom())
           return o;
@@ -628,8 +628,8 @@ namespace crab {
       }
 
       DBM_t operator&(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+        CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
         if (is_bottom() || o.is_bottom())
           return bottom();
@@ -725,8 +725,8 @@ namespace crab {
       }
     
       DBM_t operator&&(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+        CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
         if (is_bottom() || o.is_bottom())
           return bottom();
@@ -788,8 +788,8 @@ namespace crab {
       }
 
       void operator-=(VariableName v) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+        CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
         if (is_bottom ())
           return;
@@ -807,17 +807,27 @@ namespace crab {
         }
       }
 
+      // Forget all the variables at once: the graph is normalized only
+      // once and then their vertices are removed. Removing vertices
+      // from a closed graph leaves it closed.
       template<typename Iterator>
       void forget (Iterator vIt, Iterator vEt) {
         if (is_bottom ())
           return;
-        // CRAB_WARN("forget not implemented.");
+        bool normalized = false;
         for (auto v: boost::make_iterator_range (vIt,vEt)) {
           auto it = vert_map.find (v);
           if (it != vert_map.end ()) {
-            operator-=(v);
+            if (!normalized) {
+              normalize();
+              normalized = true;
+            }
+            g.forget(it->second);
+            rev_map[it->second] = boost::none;
+            vert_map.erase(it);
           }
         }
+        CRAB_LOG("zones-sparse", if (normalized) crab::outs() << "After forget: " << g <<"\n";);
       }
 
       // Evaluate the potential value of a variable.
@@ -1051,8 +1061,8 @@ namespace crab {
 
       // Assumption: state is currently feasible.
       void assign(VariableName x, linear_expression_t e) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
         if(is_bottom())
           return;
@@ -1190,8 +1200,8 @@ namespace crab {
       }
 
       void apply(ikos::operation_t op, VariableName x, VariableName y, VariableName z){	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if(is_bottom())
           return;
@@ -1234,8 +1244,8 @@ namespace crab {
 
     
       void apply(ikos::operation_t op, VariableName x, VariableName y, Number k) {	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if(is_bottom())
           return;
@@ -1375,8 +1385,8 @@ namespace crab {
       }
 
       void operator+=(linear_constraint_t cst) {
-        crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+        CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
         if(is_bottom())
           return;
@@ -1470,8 +1480,8 @@ namespace crab {
       }
 
       interval_t operator[](VariableName x) { 
-        crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-        crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+        CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+        CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
 	// if (is_top()) return interval_t::top();
         if (is_bottom()) return interval_t::bottom();
@@ -1485,8 +1495,8 @@ namespace crab {
       }
 
       void set(VariableName x, interval_t intv) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
         if(is_bottom())
           return;
@@ -1526,8 +1536,8 @@ namespace crab {
       }
 
       void apply(ikos::bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1568,8 +1578,8 @@ namespace crab {
       }
     
       void apply(ikos::bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1611,8 +1621,8 @@ namespace crab {
       // division_operators_api
     
       void apply(ikos::div_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if (op == ikos::OP_SDIV){
           apply(ikos::OP_DIVISION, x, y, z);
@@ -1645,8 +1655,8 @@ namespace crab {
       }
 
       void apply(ikos::div_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if (op == ikos::OP_SDIV){
           apply(ikos::OP_DIVISION, x, y, k);
@@ -1806,8 +1816,8 @@ namespace crab {
 
       //! copy of x into a new fresh variable y
       void expand (VariableName x, VariableName y) {
-        crab::CrabStats::count (getDomainName() + ".count.expand");
-        crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+        CRAB_STATS_COUNT (getDomainName() + ".count.expand");
+        CRAB_STATS_SCOPE (getDomainName() + ".expand");
 
         if(is_bottom()) 
           return;
@@ -1838,8 +1848,8 @@ namespace crab {
       // dual of forget: remove all variables except [vIt,...vEt)
       template<typename Iterator>
       void project (Iterator vIt, Iterator vEt) {
-        crab::CrabStats::count (getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        CRAB_STATS_COUNT (getDomainName() + ".count.project");
+        CRAB_STATS_SCOPE (getDomainName() + ".project");
 
         if (is_bottom ())
           return;
@@ -1865,8 +1875,8 @@ namespace crab {
 
       template <typename NumDomain>
       void push (const VariableName& x, NumDomain&inv){
-	crab::CrabStats::count (getDomainName() + ".count.push");
-        crab::ScopedCrabStats __st__(getDomainName() + ".push");
+	CRAB_STATS_COUNT (getDomainName() + ".count.push");
+        CRAB_STATS_SCOPE (getDomainName() + ".push");
 
         normalize ();
         if (is_bottom () || inv.is_bottom ()) return;
@@ -19,6 +19,8 @@
 #include <crab/domains/graphs/sparse_graph.hpp>
 #include <crab/domains/graphs/ht_graph.hpp>
 #include <crab/domains/graphs/pt_graph.hpp>
+#include <crab/domains/graphs/dense_graph.hpp>
+#include <crab/domains/graphs/hybrid_graph.hpp>
 #include <crab/domains/graphs/graph_ops.hpp>
 #include <crab/domains/linear_constraints.hpp>
 #include <crab/domains/intervals.hpp>
@@ -26,6 +28,7 @@
 #include <crab/domains/operators_api.hpp>
 #include <crab/domains/domain_traits.hpp>
 
+#include <algorithm>
 #include <type_traits>
 #include <unordered_set>
 
@@ -56,8 +59,8 @@ namespace crab {
          }
        };
 
-       // All of these representations are implementations of a
-       // sparse weighted graph. They differ on the datastructures
+       // All of these representations but dense are implementations
+       // of a sparse weighted graph. They differ on the datastructures
        // used to store successors and predecessors
        enum GraphRep { 
          // sparse-map and sparse-sets
@@ -67,7 +70,12 @@ namespace crab {
          // patricia tree-maps and patricia tree-sets
          pt = 3,           
          // hash table and hash sets
-         ht = 4
+         ht = 4,
+         // adjacency matrix
+         dense = 5,
+         // adaptive sparse-map or adjacency matrix, depending on
+         // the density of the graph
+         hybrid = 6
        };          
 
        template<typename Number, GraphRep Graph = GraphRep::adapt_ss>
@@ -76,6 +84,8 @@ namespace crab {
          enum { chrome_dijkstra = 1 };
          enum { widen_restabilize = 1 };
          enum { special_assign = 1 };
+         // Defer the closure after an assignment until it is needed
+         enum { lazy_closure = 1 };
 
          //typedef Number Wt;
          typedef long Wt;
@@ -89,7 +99,15 @@ namespace crab {
              typename std::conditional< 
                (Graph == pt), 
                PtGraph<Wt>, 
-               HtGraph<Wt> 
+               typename std::conditional< 
+                 (Graph == ht), 
+                 HtGraph<Wt>, 
+                 typename std::conditional< 
+                   (Graph == dense), 
+                   DenseGraph<Wt>, 
+                   HybridGraph<Wt> 
+                   >::type 
+                 >::type 
                >::type 
              >::type 
            >::type graph_t;
@@ -101,6 +119,7 @@ namespace crab {
          enum { chrome_dijkstra = 0 };
          enum { widen_restabilize = 0 };
          enum { special_assign = 0 };
+         enum { lazy_closure = 0 };
 
          typedef long Wt;
 
@@ -113,7 +132,15 @@ namespace crab {
              typename std::conditional< 
                (Graph == pt), 
                PtGraph<Wt>, 
-               HtGraph<Wt> 
+               typename std::conditional< 
+                 (Graph == ht), 
+                 HtGraph<Wt>, 
+                 typename std::conditional< 
+                   (Graph == dense), 
+                   DenseGraph<Wt>, 
+                   HybridGraph<Wt> 
+                   >::type 
+                 >::type 
                >::type 
              >::type 
            >::type graph_t;
@@ -180,6 +207,12 @@ namespace crab {
 
       vert_set_t unstable;
 
+      // Vertices created by assignments whose closure has not been
+      // computed yet, in order of creation. Each one only has its
+      // bounds and the edges of its assignment. It is never
+      // non-empty together with unstable.
+      std::vector<vert_id> pending;
+
       bool _is_bottom;
 
    public:
@@ -198,10 +231,11 @@ namespace crab {
           g(o.g),
           potential(o.potential),
           unstable(o.unstable),
+          pending(o.pending),
           _is_bottom(false)
       {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
 
         if(o._is_bottom)
           set_to_bottom();
@@ -214,6 +248,7 @@ namespace crab {
         : vert_map(std::move(o.vert_map)), rev_map(std::move(o.rev_map)),
           g(std::move(o.g)), potential(std::move(o.potential)),
           unstable(std::move(o.unstable)),
+          pending(std::move(o.pending)),
           _is_bottom(o._is_bottom)
       { }
 
@@ -237,8 +272,8 @@ namespace crab {
 
       SplitDBM_& operator=(const SplitDBM_& o)
       {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+        CRAB_STATS_SCOPE (getDomainName() + ".copy");
 
         if(this != &o)
         {
@@ -251,6 +286,7 @@ namespace crab {
             g = o.g;
             potential = o.potential;
             unstable = o.unstable;
+            pending = o.pending;
             assert(g.size() > 0);
           }
         }
@@ -268,6 +304,7 @@ namespace crab {
           g = std::move(o.g);
           potential = std::move(o.potential);
           unstable = std::move(o.unstable);
+          pending = std::move(o.pending);
         }
         return *this;
       }
@@ -281,6 +318,7 @@ namespace crab {
         g.clear();
         potential.clear();
         unstable.clear();
+        pending.clear();
         _is_bottom = true;
       }
 
@@ -333,7 +371,8 @@ namespace crab {
           /// XXX: but it would be trivial to handle equalities
           return false;
         }
-                  
+
+        close_pending();
         auto diffcst = diffcst_of_leq(cst);
         if (!diffcst)
           return false;
@@ -394,10 +433,22 @@ namespace crab {
           return false;
         return g.is_empty();
       }
+
+      // return true if some variable in [vIt, vEt) is constrained
+      template<typename Iterator>
+      bool has_some_variable(Iterator vIt, Iterator vEt) const {
+        if (is_bottom ())
+          return false;
+        for (auto v: boost::make_iterator_range (vIt,vEt)) {
+          if (vert_map.find (v) != vert_map.end ())
+            return true;
+        }
+        return false;
+      }
     
       bool operator<=(DBM_t& o)  {
-        crab::CrabStats::count (getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+        CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
         // cover all trivial cases to avoid allocating a dbm matrix
         if (is_bottom()) 
@@ -554,8 +605,8 @@ namespace crab {
       }
 
       DBM_t operator|(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        CRAB_STATS_COUNT (getDomainName() + ".count.join");
+        CRAB_STATS_SCOPE (getDomainName() + ".join");
 
         if (is_bottom() || o.is_top ())
           return o;
@@ -746,6 +797,7 @@ namespace crab {
             }
           }
           
+          rebalance(join_g);
           // DBM_t res(join_range, out_vmap, out_revmap, join_g, join_pot);
           DBM_t res(std::move(out_vmap), std::move(out_revmap), std::move(join_g), 
                     std::move(pot_rx), vert_set_t());
@@ -758,8 +810,8 @@ namespace crab {
       }
 
       DBM_t operator||(DBM_t& o) {	
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName() + ".widening");
 
         if (is_bottom())
           return o;
@@ -769,6 +821,7 @@ namespace crab {
           CRAB_LOG ("zones-split",
                     crab::outs() << "Before widening:\n"<<"DBM 1\n"<<*this<<"\n"<<"DBM 2\n"
 		    <<o <<"\n");
+          close_pending();
           o.normalize();
           
           // Figure out the common renaming
@@ -810,6 +863,7 @@ namespace crab {
           graph_t widen_g(GrOps::widen(gx, gy, destabilized));
           for(vert_id v : destabilized)
             widen_unstable.insert(v);
+          rebalance(widen_g);
 
           DBM_t res(std::move(out_vmap), std::move(out_revmap), std::move(widen_g), 
                     std::move(widen_pot), std::move(widen_unstable));
@@ -827,8 +881,8 @@ namespace crab {
       }
 
       DBM_t operator&(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+        CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
         if (is_bottom() || o.is_bottom())
           return bottom();
@@ -945,8 +999,8 @@ namespace crab {
       }
     
       DBM_t operator&&(DBM_t& o) {
-        crab::CrabStats::count (getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+        CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
         if (is_bottom() || o.is_bottom())
           return bottom();
@@ -980,7 +1034,83 @@ namespace crab {
         const vert_set_t& vs;
       };
 
+      // Switch the representation of a graph built by a join or a
+      // widening according to its density.
+      static void rebalance(graph_t& g) {
+        int res = GrOps::rebalance(g);
+        if(res > 0)
+          CRAB_STATS_COUNT (getDomainName() + ".count.to_dense");
+        else if(res < 0)
+          CRAB_STATS_COUNT (getDomainName() + ".count.to_sparse");
+      }
+
+      // Close the vertices of the assignments whose closure was
+      // deferred. They are closed in order of creation, each one
+      // seeing the edges computed for the previous ones but not the
+      // vertices created after it, so the result is the same as
+      // closing them after each assignment.
+      void close_pending() {
+        if(pending.empty())
+          return;
+
+        CRAB_STATS_COUNT (getDomainName() + ".count.close_pending");
+        CRAB_STATS_SCOPE (getDomainName() + ".close_pending");
+
+        std::vector<bool> later(g.size(), false);
+        for(vert_id v : pending)
+          later[v] = true;
+
+        SubGraph<graph_t> g_excl(g, 0);
+        edge_vector delta;
+        for(vert_id v : pending)
+        {
+          later[v] = false;
+          GrOps::close_after_assign(g_excl, potential, v, delta);
+          for(auto& e : delta)
+          {
+            if(!later[e.first.first] && !later[e.first.second])
+              g.set_edge(e.first.first, e.second, e.first.second);
+          }
+          delta.clear();
+        }
+        pending.clear();
+      }
+
+      bool is_pending(vert_id v) const {
+        return std::find(pending.begin(), pending.end(), v) != pending.end();
+      }
+
+      // Whether some variable of e is mapped to a pending vertex
+      bool reads_pending(const linear_expression_t& e) {
+        for(auto p : e)
+        {
+          auto it = vert_map.find(p.second);
+          if(it != vert_map.end() && is_pending(it->second))
+            return true;
+        }
+        return false;
+      }
+
+      // Called before removing the vertex v. The pending vertices are
+      // closed only if the closure of one of them needs v. Otherwise,
+      // v is simply dropped from them: its closure would only add
+      // edges incident to v.
+      void forget_pending(vert_id v) {
+        for(vert_id p : pending)
+        {
+          if(p != v && (g.elem(p, v) || g.elem(v, p)))
+          {
+            close_pending();
+            return;
+          }
+        }
+        auto it = std::find(pending.begin(), pending.end(), v);
+        if(it != pending.end())
+          pending.erase(it);
+      }
+
       void normalize() {
+        close_pending();
         // dbm_canonical(_dbm);
         // Always maintained in normal form, except for widening
 #ifdef SDBM_NO_NORMALIZE
@@ -1008,11 +1138,13 @@ namespace crab {
       void operator-=(VariableName v) {
         if (is_bottom ())
           return;
-        normalize();
+        if (!unstable.empty ())
+          normalize();
 
 //        ranges.remove(v);
         auto it = vert_map.find (v);
         if (it != vert_map.end ()) {
+          forget_pending(it->second);
           CRAB_LOG("zones-split", crab::outs() << "Before forget "<< it->second<< ": "
 		                               << g <<"\n");
           g.forget(it->second);
@@ -1022,17 +1154,29 @@ namespace crab {
         }
       }
 
+      // Forget all the variables at once: the graph is normalized only
+      // once and then their vertices are removed. Removing vertices
+      // from a closed graph leaves it closed.
       template<typename Iterator>
       void forget (Iterator vIt, Iterator vEt) {
         if (is_bottom ())
           return;
-        // CRAB_WARN("forget not implemented.");
+        bool normalized = false;
         for (auto v: boost::make_iterator_range (vIt,vEt)) {
           auto it = vert_map.find (v);
           if (it != vert_map.end ()) {
-            operator-=(v);
+            if (!normalized) {
+              if (!unstable.empty ())
+                normalize();
+              normalized = true;
+            }
+            forget_pending(it->second);
+            g.forget(it->second);
+            rev_map[it->second] = boost::none;
+            vert_map.erase(it);
           }
         }
+        CRAB_LOG("zones-split", if (normalized) crab::outs() << "After forget: " << g <<"\n";);
       }
 
       // Evaluate the potential value of a variable.
@@ -1276,14 +1420,18 @@ namespace crab {
 
       // Assumption: state is currently feasible.
       void assign(VariableName x, linear_expression_t e) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
         if(is_bottom())
           return;
         CRAB_LOG("zones-split", crab::outs() << "Before assign: "<< *this <<"\n");
         CRAB_LOG("zones-split", crab::outs() << x<< ":="<< e <<"\n");
-        normalize();
+        // The closure of the previous assignments can be deferred
+        // further unless this one reads their variables.
+        if(!(Params::lazy_closure && Params::special_assign) ||
+           !unstable.empty() || reads_pending(e))
+          normalize();
 
         assert(check_potential(g, potential));
 
@@ -1328,9 +1476,14 @@ namespace crab {
               // apply_delta should be safe here, as x has no edges in G.
               GrOps::apply_delta(g, delta);
               delta.clear();
-              SubGraph<graph_t> g_excl(g, 0);
-              GrOps::close_after_assign(g_excl, potential, v, delta);
-              GrOps::apply_delta(g, delta);
+              if(Params::lazy_closure)
+              {
+                pending.push_back(v);
+              } else {
+                SubGraph<graph_t> g_excl(g, 0);
+                GrOps::close_after_assign(g_excl, potential, v, delta);
+                GrOps::apply_delta(g, delta);
+              }
 
               Wt_min min_op;
               if(x_int.lb().is_finite())
@@ -1406,8 +1559,8 @@ namespace crab {
       }
 
       void apply(operation_t op, VariableName x, VariableName y, VariableName z){	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if(is_bottom())
           return;
@@ -1470,8 +1623,8 @@ namespace crab {
 
     
       void apply(operation_t op, VariableName x, VariableName y, Number k) {	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if(is_bottom())
           return;
@@ -1670,8 +1823,8 @@ namespace crab {
       }
 
       void operator+=(linear_constraint_t cst) {
-        crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+        CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
         if(is_bottom())
           return;
@@ -1764,8 +1917,8 @@ namespace crab {
       }
 
       interval_t operator[](VariableName x) { 
-        crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-        crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+        CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+        CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
         // if (is_top())    return interval_t::top();
         if (is_bottom()) return interval_t::bottom();
@@ -1779,8 +1932,8 @@ namespace crab {
       }
 
       void set(VariableName x, interval_t intv) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
         if(is_bottom())
           return;
@@ -1819,8 +1972,8 @@ namespace crab {
       }
 
       void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1861,8 +2014,8 @@ namespace crab {
       }
     
       void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1904,8 +2057,8 @@ namespace crab {
       // division_operators_api
     
       void apply(div_operation_t op, VariableName x, VariableName y, VariableName z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if (op == OP_SDIV){
           apply(OP_DIVISION, x, y, z);
@@ -1938,8 +2091,8 @@ namespace crab {
       }
 
       void apply(div_operation_t op, VariableName x, VariableName y, Number k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
         if (op == OP_SDIV){
           apply(OP_DIVISION, x, y, k);
@@ -2000,7 +2153,9 @@ namespace crab {
         for(auto edge : g_excl.e_preds(ii))
         {
           vert_id se = edge.vert;
-          Wt wt_sij = edge.val + c;
+          // edge.val is no longer valid once an edge is added
+          Wt w_si = edge.val;
+          Wt wt_sij = w_si + c;
 
           assert(g_excl.succs(se).begin() != g_excl.succs(se).end());
           if(se != jj)
@@ -2015,7 +2170,7 @@ namespace crab {
             } else {
               g_excl.add_edge(se, wt_sij, jj);
             }
-            src_dec.push_back(std::make_pair(se, edge.val));  
+            src_dec.push_back(std::make_pair(se, w_si));
 #ifdef CLOSE_BOUNDS_INLINE
             if(g.lookup(0, se, &w))
               g.update_edge(0, w + wt_sij, jj, min_op);
@@ -2054,7 +2209,8 @@ namespace crab {
         for(auto edge : g_excl.e_succs(jj))
         {
           vert_id de = edge.vert;
-          Wt wt_ijd = edge.val + c;
+          Wt w_jd = edge.val;
+          Wt wt_ijd = w_jd + c;
           if(de != ii)
           {
             if(g_excl.lookup(ii, de, &w))
@@ -2065,7 +2221,7 @@ namespace crab {
             } else {
               g_excl.add_edge(ii, wt_ijd, de);
             }
-            dest_dec.push_back(std::make_pair(de, edge.val));
+            dest_dec.push_back(std::make_pair(de, w_jd));
 #ifdef CLOSE_BOUNDS_INLINE
             if(g.lookup(0,  ii, &w))
               g.update_edge(0, w + wt_ijd, de, min_op);
@@ -2127,8 +2283,8 @@ namespace crab {
 
       //! copy of x into a new fresh variable y
       void expand (VariableName x, VariableName y) {
-        crab::CrabStats::count (getDomainName() + ".count.expand");
-        crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+        CRAB_STATS_COUNT (getDomainName() + ".count.expand");
+        CRAB_STATS_SCOPE (getDomainName() + ".expand");
 
         if(is_bottom()) 
           return;
@@ -2141,6 +2297,7 @@ namespace crab {
           CRAB_ERROR("split_dbm expand operation failed because y already exists");
         }
         
+        close_pending();
         vert_id ii = get_vert(x);
         vert_id jj = get_vert(y);
 
@@ -2157,8 +2314,8 @@ namespace crab {
       // dual of forget: remove all variables except [vIt,...vEt)
       template<typename Iterator>
       void project (Iterator vIt, Iterator vEt) {
-        crab::CrabStats::count (getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        CRAB_STATS_COUNT (getDomainName() + ".count.project");
+        CRAB_STATS_SCOPE (getDomainName() + ".project");
 
         if (is_bottom ())
           return;
@@ -2195,8 +2352,8 @@ namespace crab {
 
       template <typename NumDomain>
       void push (const VariableName& x, NumDomain&inv){
-        crab::CrabStats::count (getDomainName() + ".count.push");
-        crab::ScopedCrabStats __st__(getDomainName() + ".push");
+        CRAB_STATS_COUNT (getDomainName() + ".count.push");
+        CRAB_STATS_SCOPE (getDomainName() + ".push");
 
         normalize ();
         if (is_bottom () || inv.is_bottom ()) return;
@@ -2401,6 +2558,14 @@ namespace crab {
     }; // class SplitDBM_
 
     // Quick wrapper which uses shared references with copy-on-write.
+    //
+    // Copies only share the underlying SplitDBM_ and the graph,
+    // maps and potential are duplicated by lock() the first time a
+    // shared value is modified. Operations which do not change the
+    // value (e.g., forgetting unconstrained variables) or which
+    // produce a fresh value (e.g., join) never duplicate it. The
+    // number of shared copies (.count.cow.share) and duplications
+    // (.count.cow.detach) are reported in CrabStats.
     template<class Number, class VariableName, class Params=SDBM_impl::DefaultParams <Number> >
     class SplitDBM : public writeable,
                public numerical_domain<Number, VariableName>,
@@ -2444,8 +2609,20 @@ namespace crab {
       void lock(void)
       {
         // Allocate a fresh copy.
-        if(!norm_ref.unique())
+        if(!norm_ref.unique()) {
+          CRAB_STATS_COUNT (getDomainName() + ".count.cow.detach");
           norm_ref = std::make_shared<dbm_impl_t>(*norm_ref);
+        }
+        base_ref.reset();
+      }
+
+      // Replace the value without duplicating the old one.
+      void reset(dbm_impl_t&& t)
+      {
+        if(norm_ref.unique())
+          *norm_ref = std::move(t);
+        else
+          norm_ref = std::make_shared<dbm_impl_t>(std::move(t));
         base_ref.reset();
       }
 
@@ -2460,12 +2637,28 @@ namespace crab {
 
       SplitDBM(const DBM_t& o)
         : base_ref(o.base_ref), norm_ref(o.norm_ref)
+      { 
+        CRAB_STATS_COUNT (getDomainName() + ".count.cow.share");
+      }
+
+      SplitDBM(DBM_t&& o)
+        : base_ref(std::move(o.base_ref)), norm_ref(std::move(o.norm_ref))
       { }
 
       SplitDBM& operator=(const DBM_t& o) {
-        base_ref = o.base_ref;
-        norm_ref = o.norm_ref;
+        if(this != &o) {
+          CRAB_STATS_COUNT (getDomainName() + ".count.cow.share");
+          base_ref = o.base_ref;
+          norm_ref = o.norm_ref;
+        }
+        return *this;
+      }
 
+      SplitDBM& operator=(DBM_t&& o) {
+        if(this != &o) {
+          base_ref = std::move(o.base_ref);
+          norm_ref = std::move(o.norm_ref);
+        }
         return *this;
       }
 
@@ -2479,26 +2672,65 @@ namespace crab {
 
       bool is_bottom() { return norm().is_bottom(); }
       bool is_top() { return norm().is_top(); }
-      bool operator<=(DBM_t& o) { return norm() <= o.norm(); }
-      void operator|=(DBM_t o) { lock(); norm() |= o.norm(); }
-      DBM_t operator|(DBM_t o) { return create(norm() | o.norm()); }
-      DBM_t operator||(DBM_t o) { return create_base(base() || o.norm()); }
-      DBM_t operator&(DBM_t o) { return create(norm() & o.norm()); }
+      // Values sharing the same SplitDBM_ are equal so the lattice
+      // operations on them are trivial.
+      bool operator<=(DBM_t& o) { 
+        if(norm_ref == o.norm_ref)
+          return true;
+        return norm() <= o.norm(); 
+      }
+      void operator|=(DBM_t o) {
+        if(o.is_bottom() || is_top() || norm_ref == o.norm_ref)
+          return;
+        if(is_bottom() || o.is_top())
+          *this = DBM_t(o.norm_ref);
+        else
+          reset(norm() | o.norm());
+      }
+      DBM_t operator|(DBM_t o) {
+        if(is_bottom() || o.is_top())
+          return DBM_t(o.norm_ref);
+        else if(is_top() || o.is_bottom() || norm_ref == o.norm_ref)
+          return DBM_t(norm_ref);
+        return create(norm() | o.norm()); 
+      }
+      DBM_t operator||(DBM_t o) { 
+        if(!base_ref && norm_ref == o.norm_ref)
+          return DBM_t(norm_ref);
+        return create_base(base() || o.norm()); 
+      }
+      DBM_t operator&(DBM_t o) { 
+        if(is_bottom() || o.is_top() || norm_ref == o.norm_ref)
+          return DBM_t(norm_ref);
+        else if(is_top() || o.is_bottom())
+          return DBM_t(o.norm_ref);
+        return create(norm() & o.norm()); 
+      }
       DBM_t operator&&(DBM_t o) { return create(norm() && o.norm()); }
 
       template<typename Thresholds>
       DBM_t widening_thresholds (DBM_t o, const Thresholds &ts) {
+        if(!base_ref && norm_ref == o.norm_ref)
+          return DBM_t(norm_ref);
         return create_base(base().template widening_thresholds<Thresholds>(o.norm(), ts));
       }
 
       void normalize() { norm(); }
       void operator+=(linear_constraint_system_t csts) { lock(); norm() += csts; } 
-      void operator-=(VariableName v) { lock(); norm() -= v; }
+      void operator-=(VariableName v) { 
+        if(!norm().has_some_variable(&v, &v + 1))
+          return;
+        lock(); norm() -= v; 
+      }
       interval_t operator[](VariableName x) { return norm()[x]; }
       void set(VariableName x, interval_t intv) { lock(); norm().set(x, intv); }
 
       template<typename Iterator>
-      void forget (Iterator vIt, Iterator vEt) { lock(); norm().forget(vIt, vEt); }
+      void forget (Iterator vIt, Iterator vEt) { 
+        if(!norm().has_some_variable(vIt, vEt))
+          return;
+        lock(); norm().forget(vIt, vEt); 
+      }
       void assign(VariableName x, linear_expression_t e) { lock(); norm().assign(x, e); }
       void apply(operation_t op, VariableName x, VariableName y, Number k) {
         lock(); norm().apply(op, x, y, k);
@@ -515,14 +515,14 @@ namespace crab {
            _var_map(o._var_map), _term_map(o._term_map),
            changed_terms(o.changed_terms)
        { 
-         crab::CrabStats::count (getDomainName() + ".count.copy");
-         crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+         CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+         CRAB_STATS_SCOPE (getDomainName() + ".copy");
          check_terms(); 
        } 
        
        term_domain_t& operator=(const term_domain_t &o) {
-         crab::CrabStats::count (getDomainName() + ".count.copy");
-         crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+         CRAB_STATS_COUNT (getDomainName() + ".count.copy");
+         CRAB_STATS_SCOPE (getDomainName() + ".copy");
          
          o.check_terms();
          if (this != &o) {
@@ -553,8 +553,8 @@ namespace crab {
        
        // Lattice operations
        bool operator<=(term_domain_t o)  {	
-         crab::CrabStats::count (getDomainName() + ".count.leq");
-         crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+         CRAB_STATS_COUNT (getDomainName() + ".count.leq");
+         CRAB_STATS_SCOPE (getDomainName() + ".leq");
 
          // Require normalization of the first argument
          this->normalize();
@@ -604,8 +604,8 @@ namespace crab {
        // Optimized version of | that avoids some unnecessary copies
        void operator|=(term_domain_t o) {
 
-         crab::CrabStats::count (getDomainName() + ".count.join");
-         crab::ScopedCrabStats __st__(getDomainName() + ".join");
+         CRAB_STATS_COUNT (getDomainName() + ".count.join");
+         CRAB_STATS_SCOPE (getDomainName() + ".join");
          
          // Requires normalization of both operands
          normalize();
@@ -678,8 +678,8 @@ namespace crab {
        }
 
        term_domain_t operator|(term_domain_t o) {
-         crab::CrabStats::count (getDomainName() + ".count.join");
-         crab::ScopedCrabStats __st__(getDomainName() + ".join");
+         CRAB_STATS_COUNT (getDomainName() + ".count.join");
+         CRAB_STATS_SCOPE (getDomainName() + ".join");
 
          // Requires normalization of both operands
          normalize();
@@ -762,16 +762,16 @@ namespace crab {
        }
 
        term_domain_t operator||(term_domain_t other) {
-         crab::CrabStats::count (getDomainName() + ".count.widening");
-         crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+         CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+         CRAB_STATS_SCOPE (getDomainName() + ".widening");
          WidenOp op;
          return this->widening (other, op);
        }
        
        template<typename Thresholds>
        term_domain_t widening_thresholds (term_domain_t other, const Thresholds& ts) {
-         crab::CrabStats::count (getDomainName() + ".count.widening");
-         crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+         CRAB_STATS_COUNT (getDomainName() + ".count.widening");
+         CRAB_STATS_SCOPE (getDomainName() + ".widening");
          WidenWithThresholdsOp<Thresholds> op (ts);
          return this->widening (other, op);
        }
@@ -964,8 +964,8 @@ namespace crab {
 
        // Meet
        term_domain_t operator&(term_domain_t o) {
-         crab::CrabStats::count (getDomainName() + ".count.meet");
-         crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+         CRAB_STATS_COUNT (getDomainName() + ".count.meet");
+         CRAB_STATS_SCOPE (getDomainName() + ".meet");
 
          // Does not require normalization of any of the two operands
          if (is_bottom() || o.is_bottom()) {
@@ -1069,8 +1069,8 @@ namespace crab {
     
        // Narrowing
        term_domain_t operator&&(term_domain_t o) {	
-         crab::CrabStats::count (getDomainName() + ".count.narrowing");
-         crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+         CRAB_STATS_COUNT (getDomainName() + ".count.narrowing");
+         CRAB_STATS_SCOPE (getDomainName() + ".narrowing");
 
          CRAB_WARN ("Term narrowing operator replaced with meet");
          return *this & o; 
@@ -1078,8 +1078,8 @@ namespace crab {
 
        // Remove a variable from the scope
        void operator-=(VariableName v) {
-         crab::CrabStats::count (getDomainName() + ".count.forget");
-         crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+         CRAB_STATS_COUNT (getDomainName() + ".count.forget");
+         CRAB_STATS_SCOPE (getDomainName() + ".forget");
 
          auto it(_var_map.find(v));
          if(it != _var_map.end())
@@ -1103,8 +1103,8 @@ namespace crab {
        // Remove all variables except vs
        template<typename Range>
        void project (Range vs) {
-         crab::CrabStats::count (getDomainName() + ".count.project");
-         crab::ScopedCrabStats __st__(getDomainName() + ".project");
+         CRAB_STATS_COUNT (getDomainName() + ".count.project");
+         CRAB_STATS_SCOPE (getDomainName() + ".project");
 
          if (is_bottom ()) return;
          
@@ -1116,8 +1116,8 @@ namespace crab {
        }
 
        void assign(VariableName x_name, linear_expression_t e) {
-         crab::CrabStats::count (getDomainName() + ".count.assign");
-         crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+         CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+         CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
          if (this->is_bottom()) {
            return;
@@ -1137,8 +1137,8 @@ namespace crab {
 
        //! copy of x into a new fresh variable y
        void expand (VariableName x_name, VariableName y_name) {
-         crab::CrabStats::count (getDomainName() + ".count.expand");
-         crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+         CRAB_STATS_COUNT (getDomainName() + ".count.expand");
+         CRAB_STATS_SCOPE (getDomainName() + ".expand");
 
          if (is_bottom ()) {
            return;
@@ -1156,8 +1156,8 @@ namespace crab {
 
        template<typename NumDomain>
        void push (const VariableName& x, NumDomain& inv) {
-         crab::CrabStats::count (getDomainName() + ".count.push");
-         crab::ScopedCrabStats __st__(getDomainName() + ".push");
+         CRAB_STATS_COUNT (getDomainName() + ".count.push");
+         CRAB_STATS_SCOPE (getDomainName() + ".push");
 
          if (!is_normalized ()) normalize ();
 
@@ -1189,8 +1189,8 @@ namespace crab {
 
        // x = y op z
        void apply(operation_t op, VariableName x, VariableName y, VariableName z){	
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
@@ -1207,8 +1207,8 @@ namespace crab {
     
        // x = y op k
        void apply(operation_t op, VariableName x, VariableName y, Number k){	
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
@@ -1247,8 +1247,8 @@ namespace crab {
       public:
 
        void operator+=(linear_constraint_t cst) {  
-         crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-         crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+         CRAB_STATS_COUNT (getDomainName() + ".count.add_constraints");
+         CRAB_STATS_SCOPE (getDomainName() + ".add_constraints");
 
          typedef std::pair<variable_t,variable_t> pair_var_t;
 
@@ -1333,14 +1333,14 @@ namespace crab {
        // Propagate information from tightened terms to
        // parents/children.
        void normalize() { 
-         crab::CrabStats::count (getDomainName() + ".count.normalize");
-         crab::ScopedCrabStats __st__(getDomainName() + ".normalize");
+         CRAB_STATS_COUNT (getDomainName() + ".count.normalize");
+         CRAB_STATS_SCOPE (getDomainName() + ".normalize");
          TermNormalizer<Info, typename Info::domain_t>::normalize(*this); 
        }
 
        interval_t operator[](VariableName x) { 
-         crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-         crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+         CRAB_STATS_COUNT (getDomainName() + ".count.to_intervals");
+         CRAB_STATS_SCOPE (getDomainName() + ".to_intervals");
 
          // Needed for accuracy
          normalize();
@@ -1358,8 +1358,8 @@ namespace crab {
        } 
 
        void set (VariableName x, interval_t intv){
-         crab::CrabStats::count (getDomainName() + ".count.assign");
-         crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+         CRAB_STATS_COUNT (getDomainName() + ".count.assign");
+         CRAB_STATS_SCOPE (getDomainName() + ".assign");
 
          variable_t vx (x);
          rebind_var (vx, term_of_itv (intv.lb (), intv.ub ()));
@@ -1433,8 +1433,8 @@ namespace crab {
        }
 
        void apply(bitwise_operation_t op, VariableName x, VariableName y, VariableName z){
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
@@ -1450,8 +1450,8 @@ namespace crab {
        }
     
        void apply(bitwise_operation_t op, VariableName x, VariableName y, Number k){
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
@@ -1471,8 +1471,8 @@ namespace crab {
        // division_operators_api
     
        void apply(div_operation_t op, VariableName x, VariableName y, VariableName z){
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
@@ -1488,8 +1488,8 @@ namespace crab {
        }
 
        void apply(div_operation_t op, VariableName x, VariableName y, Number k){
-         crab::CrabStats::count (getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         CRAB_STATS_COUNT (getDomainName() + ".count.apply");
+         CRAB_STATS_SCOPE (getDomainName() + ".apply");
 
          if (this->is_bottom()) {
            return;   
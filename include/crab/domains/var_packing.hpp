@@ -0,0 +1,769 @@
+#ifndef VAR_PACKING_HPP
+#define VAR_PACKING_HPP
+
+/*
+   Variable packing for relational domains.
+
+   Relational domains keep all the variables in a single abstract
+   value although most relations only involve a few of them. The
+   packing domain splits the variables into packs before the analysis
+   starts and keeps one abstract value of a relational domain per
+   pack. Variables that are not in any pack are kept in intervals.
+
+   The packs are computed from the CFG by do_initialization: two
+   variables are in the same pack if they occur together in an
+   arithmetic operation, an assignment or an assumption (transitively).
+   A variable that never occurs together with another one is not
+   packed. Thus, the transfer functions of the statements of the CFG
+   only involve one pack or only unpacked variables. Operations that
+   involve several packs (e.g., on variables that are not in the CFG)
+   are done on intervals and lose the relations between the packs.
+
+   Like the landmarks of the array graph domain, the packing is shared
+   by all the values of the analysis context. Each value remembers the
+   packing it was built with and values built with a previous packing
+   are repacked when they are used.
+*/
+
+#include <crab/common/types.hpp>
+#include <crab/common/debug.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/common/analysis_context.hpp>
+#include <crab/domains/linear_constraints.hpp>
+#include <crab/domains/intervals.hpp>
+#include <crab/domains/operators_api.hpp>
+#include <crab/domains/domain_traits.hpp>
+
+#include <vector>
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace crab {
+
+  namespace domains {
+
+    // Partition of the variables of a CFG into packs
+    template<typename VariableName>
+    class var_packing {
+
+      typedef boost::unordered_map<VariableName, unsigned> index_map_t;
+
+      index_map_t m_pack;
+      std::vector<unsigned> m_pack_size;
+
+      // -- union-find used to compute the packs
+      struct union_find {
+        index_map_t m_index;
+        std::vector<VariableName> m_vars;
+        std::vector<unsigned> m_parent;
+
+        unsigned index (const VariableName &v) {
+          auto it = m_index.find (v);
+          if (it != m_index.end ()) return it->second;
+          unsigned i = m_vars.size ();
+          m_index.insert (std::make_pair (v, i));
+          m_vars.push_back (v);
+          m_parent.push_back (i);
+          return i;
+        }
+
+        unsigned find (unsigned i) {
+          while (m_parent [i] != i) {
+            m_parent [i] = m_parent [m_parent [i]];
+            i = m_parent [i];
+          }
+          return i;
+        }
+
+        void merge (unsigned i, unsigned j) {
+          i = find (i); j = find (j);
+          if (i != j) m_parent [j] = i;
+        }
+      };
+
+     public:
+
+      var_packing () { }
+
+      //! Group the variables that occur together in arithmetic
+      //! operations, assignments and assumptions of the CFG.
+      template<class CFG>
+      static boost::shared_ptr<const var_packing> make (CFG cfg) {
+        union_find uf;
+        for (auto &bb: boost::make_iterator_range (cfg.begin (), cfg.end ())) {
+          for (auto &s: boost::make_iterator_range (bb.begin (), bb.end ())) {
+            if (!s.is_bin_op () && !s.is_assign () && !s.is_assume ())
+              continue;
+            auto const &live = s.get_live ();
+            boost::optional<unsigned> first;
+            auto add = [&uf, &first] (const VariableName &v) {
+              unsigned i = uf.index (v);
+              if (first) uf.merge (*first, i); else first = i;
+            };
+            for (auto const &v: boost::make_iterator_range (live.defs_begin (),
+                                                            live.defs_end ()))
+              add (v);
+            for (auto const &v: boost::make_iterator_range (live.uses_begin (),
+                                                            live.uses_end ()))
+              add (v);
+          }
+        }
+
+        std::vector<unsigned> size (uf.m_vars.size (), 0);
+        for (unsigned i=0; i < uf.m_vars.size (); i++)
+          size [uf.find (i)]++;
+
+        boost::shared_ptr<var_packing> res = boost::make_shared<var_packing> ();
+        // number the packs in order of their first variable
+        std::vector<int> pack_of_root (uf.m_vars.size (), -1);
+        for (unsigned i=0; i < uf.m_vars.size (); i++) {
+          unsigned r = uf.find (i);
+          if (size [r] < 2) continue; // not packed
+          if (pack_of_root [r] < 0) {
+            pack_of_root [r] = res->m_pack_size.size ();
+            res->m_pack_size.push_back (0);
+          }
+          res->m_pack.insert (std::make_pair (uf.m_vars [i], pack_of_root [r]));
+          res->m_pack_size [pack_of_root [r]]++;
+        }
+
+        CRAB_LOG ("packing", crab::outs () << *res << "\n";);
+        return res;
+      }
+
+      unsigned num_packs () const { return m_pack_size.size (); }
+
+      //! Return the pack of v or none if v is not packed
+      boost::optional<unsigned> pack_of (const VariableName &v) const {
+        auto it = m_pack.find (v);
+        if (it == m_pack.end ()) return boost::none;
+        return it->second;
+      }
+
+      void write (crab_os &o) const {
+        std::vector<std::vector<VariableName> > packs (num_packs ());
+        for (auto const &kv: m_pack)
+          packs [kv.second].push_back (kv.first);
+        o << "packs={";
+        for (unsigned p=0; p < packs.size (); p++) {
+          if (p > 0) o << ",";
+          o << "{";
+          for (unsigned i=0; i < packs [p].size (); i++) {
+            if (i > 0) o << ",";
+            o << packs [p][i];
+          }
+          o << "}";
+        }
+        o << "}";
+      }
+
+      friend crab_os& operator<<(crab_os &o, const var_packing &p) {
+        p.write (o);
+        return o;
+      }
+    };
+
+    template<typename Dom>
+    class var_packing_domain:
+        public writeable,
+        public numerical_domain<typename Dom::number_t, typename Dom::varname_t>,
+        public bitwise_operators<typename Dom::number_t, typename Dom::varname_t>,
+        public division_operators<typename Dom::number_t, typename Dom::varname_t>,
+        public array_operators<typename Dom::number_t, typename Dom::varname_t>,
+        public pointer_operators<typename Dom::number_t, typename Dom::varname_t>,
+        public boolean_operators<typename Dom::number_t, typename Dom::varname_t> {
+
+     private:
+      typedef typename Dom::number_t N;
+      typedef typename Dom::varname_t V;
+
+     public:
+      typedef var_packing_domain<Dom> var_packing_domain_t;
+      using typename numerical_domain<N, V>::linear_expression_t;
+      using typename numerical_domain<N, V>::linear_constraint_t;
+      using typename numerical_domain<N, V>::linear_constraint_system_t;
+      using typename numerical_domain<N, V>::variable_t;
+      using typename numerical_domain<N, V>::number_t;
+      using typename numerical_domain<N, V>::varname_t;
+      typedef interval<number_t> interval_t;
+      typedef interval_domain<number_t, varname_t> interval_domain_t;
+      typedef var_packing<varname_t> packing_t;
+      typedef boost::shared_ptr<const packing_t> packing_ref_t;
+
+     private:
+      typedef patricia_tree_set<variable_t> variable_set_t;
+
+      // UNPACKED is the owner of the variables that are not packed
+      // and MIXED the owner of a set of variables that are in several
+      // packs or both in a pack and unpacked
+      enum { UNPACKED = -1, MIXED = -2 };
+
+      /// === Data shared by all the values of the same analysis context
+      struct current_packing_t {
+        packing_ref_t m_ref;
+      };
+
+      static packing_ref_t& current_packing () {
+        packing_ref_t &p = analysis_context::current ().get<current_packing_t> ().m_ref;
+        if (!p) p = boost::make_shared<const packing_t> ();
+        return p;
+      }
+
+      bool _is_bottom;
+      packing_ref_t _packing;
+      interval_domain_t _intervals;
+      std::vector<Dom> _packs;
+
+      var_packing_domain (bool is_bottom):
+          _is_bottom (is_bottom),
+          _packing (current_packing ()),
+          _intervals (interval_domain_t::top ()),
+          _packs (is_bottom ? 0 : _packing->num_packs (), Dom::top ()) { }
+
+      void set_to_bottom () {
+        _is_bottom = true;
+        _intervals = interval_domain_t::top ();
+        _packs.clear ();
+      }
+
+      // Move the value to the current packing if it was built with
+      // another one
+      void repack () {
+        packing_ref_t &cur = current_packing ();
+        if (_packing == cur) return;
+        CRAB_STATS_COUNT (getDomainName () + ".count.repack");
+        CRAB_STATS_SCOPE (getDomainName () + ".repack");
+        if (_is_bottom) {
+          _packing = cur;
+          return;
+        }
+        linear_constraint_system_t csts = to_linear_constraint_system ();
+        *this = top ();
+        *this += csts;
+      }
+
+      int owner (const varname_t &v) const {
+        boost::optional<unsigned> p = _packing->pack_of (v);
+        return p ? (int) *p : UNPACKED;
+      }
+
+      int owner (int o, const varname_t &v) const {
+        int ov = owner (v);
+        return (o == ov) ? o : MIXED;
+      }
+
+      int owner (const variable_set_t &vars) const {
+        boost::optional<int> res;
+        for (auto const &v: vars) {
+          int o = owner (v.name ());
+          if (!res) res = o;
+          else if (*res != o) return MIXED;
+        }
+        return res ? *res : UNPACKED;
+      }
+
+      // The intervals of the variables in intervals
+      template<typename Range>
+      interval_domain_t get_intervals (Range vars) {
+        interval_domain_t res = interval_domain_t::top ();
+        for (auto const &v: vars)
+          res.set (v, operator[] (v));
+        return res;
+      }
+
+      // Meet the interval of v with i
+      void refine (const varname_t &v, interval_t i) {
+        int o = owner (v);
+        if (o == UNPACKED) {
+          _intervals.set (v, _intervals [v] & i);
+          if (_intervals.is_bottom ()) set_to_bottom ();
+        } else {
+          linear_constraint_system_t csts;
+          if (boost::optional<number_t> lb = i.lb ().number ())
+            csts += linear_constraint_t (variable_t (v) >= *lb);
+          if (boost::optional<number_t> ub = i.ub ().number ())
+            csts += linear_constraint_t (variable_t (v) <= *ub);
+          _packs [o] += csts;
+          if (_packs [o].is_bottom ()) set_to_bottom ();
+        }
+      }
+
+      // Give x the interval of x in the temporary intervals tmp where
+      // an operation involving several packs was done
+      void assign_mixed (const varname_t &x, interval_domain_t &tmp) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.mixed");
+        set (x, tmp [x]);
+      }
+
+     public:
+
+      static var_packing_domain_t top () { return var_packing_domain_t (false); }
+
+      static var_packing_domain_t bottom () { return var_packing_domain_t (true); }
+
+      var_packing_domain (): var_packing_domain (false) { }
+
+      var_packing_domain (const var_packing_domain_t &o):
+          _is_bottom (o._is_bottom), _packing (o._packing),
+          _intervals (o._intervals), _packs (o._packs) { }
+
+      var_packing_domain_t& operator=(const var_packing_domain_t &o) {
+        if (this != &o) {
+          _is_bottom = o._is_bottom;
+          _packing = o._packing;
+          _intervals = o._intervals;
+          _packs = o._packs;
+        }
+        return *this;
+      }
+
+      bool is_bottom () { return _is_bottom; }
+
+      bool is_top () {
+        if (_is_bottom || !_intervals.is_top ()) return false;
+        for (auto &d: _packs)
+          if (!d.is_top ()) return false;
+        return true;
+      }
+
+      const packing_t& get_packing () const { return *_packing; }
+
+      bool operator<=(var_packing_domain_t o) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.leq");
+        CRAB_STATS_SCOPE (getDomainName () + ".leq");
+        repack (); o.repack ();
+        if (_is_bottom) return true;
+        if (o._is_bottom) return false;
+        if (!(_intervals <= o._intervals)) return false;
+        for (unsigned p=0; p < _packs.size (); p++)
+          if (!(_packs [p] <= o._packs [p])) return false;
+        return true;
+      }
+
+      bool operator==(var_packing_domain_t o) {
+        return (*this <= o && o <= *this);
+      }
+
+      void operator|=(var_packing_domain_t o) {
+        *this = *this | o;
+      }
+
+      var_packing_domain_t operator|(var_packing_domain_t o) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.join");
+        CRAB_STATS_SCOPE (getDomainName () + ".join");
+        repack (); o.repack ();
+        if (_is_bottom) return o;
+        if (o._is_bottom) return *this;
+        var_packing_domain_t res (*this);
+        res._intervals = _intervals | o._intervals;
+        for (unsigned p=0; p < _packs.size (); p++)
+          res._packs [p] = _packs [p] | o._packs [p];
+        return res;
+      }
+
+      var_packing_domain_t operator&(var_packing_domain_t o) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.meet");
+        CRAB_STATS_SCOPE (getDomainName () + ".meet");
+        repack (); o.repack ();
+        if (_is_bottom || o._is_bottom) return bottom ();
+        var_packing_domain_t res (*this);
+        res._intervals = _intervals & o._intervals;
+        if (res._intervals.is_bottom ()) return bottom ();
+        for (unsigned p=0; p < _packs.size (); p++) {
+          res._packs [p] = _packs [p] & o._packs [p];
+          if (res._packs [p].is_bottom ()) return bottom ();
+        }
+        return res;
+      }
+
+      var_packing_domain_t operator||(var_packing_domain_t o) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName () + ".widening");
+        repack (); o.repack ();
+        if (_is_bottom) return o;
+        if (o._is_bottom) return *this;
+        var_packing_domain_t res (*this);
+        res._intervals = _intervals || o._intervals;
+        for (unsigned p=0; p < _packs.size (); p++)
+          res._packs [p] = _packs [p] || o._packs [p];
+        return res;
+      }
+
+      template<typename Thresholds>
+      var_packing_domain_t widening_thresholds (var_packing_domain_t o,
+                                                const Thresholds &ts) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.widening");
+        CRAB_STATS_SCOPE (getDomainName () + ".widening");
+        repack (); o.repack ();
+        if (_is_bottom) return o;
+        if (o._is_bottom) return *this;
+        var_packing_domain_t res (*this);
+        res._intervals = _intervals.widening_thresholds (o._intervals, ts);
+        for (unsigned p=0; p < _packs.size (); p++)
+          res._packs [p] = _packs [p].widening_thresholds (o._packs [p], ts);
+        return res;
+      }
+
+      var_packing_domain_t operator&&(var_packing_domain_t o) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.narrowing");
+        CRAB_STATS_SCOPE (getDomainName () + ".narrowing");
+        repack (); o.repack ();
+        if (_is_bottom || o._is_bottom) return bottom ();
+        var_packing_domain_t res (*this);
+        res._intervals = _intervals && o._intervals;
+        if (res._intervals.is_bottom ()) return bottom ();
+        for (unsigned p=0; p < _packs.size (); p++) {
+          res._packs [p] = _packs [p] && o._packs [p];
+          if (res._packs [p].is_bottom ()) return bottom ();
+        }
+        return res;
+      }
+
+      void normalize () {
+        repack ();
+        for (auto &d: _packs)
+          domain_traits<Dom>::normalize (d);
+      }
+
+      void set (varname_t v, interval_t i) {
+        repack ();
+        if (_is_bottom) return;
+        if (i.is_bottom ()) {
+          set_to_bottom ();
+          return;
+        }
+        int o = owner (v);
+        if (o == UNPACKED) _intervals.set (v, i);
+        else _packs [o].set (v, i);
+      }
+
+      interval_t operator[](varname_t v) {
+        repack ();
+        if (_is_bottom) return interval_t::bottom ();
+        int o = owner (v);
+        return (o == UNPACKED) ? _intervals [v] : _packs [o][v];
+      }
+
+      void operator+=(linear_constraint_system_t csts) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.add_constraints");
+        CRAB_STATS_SCOPE (getDomainName () + ".add_constraints");
+        repack ();
+        if (_is_bottom) return;
+
+        // split the constraints by pack
+        linear_constraint_system_t unpacked, mixed;
+        std::vector<linear_constraint_system_t> packed (_packs.size ());
+        for (auto const &c: csts) {
+          int o = owner (c.variables ());
+          if (o == UNPACKED) unpacked += c;
+          else if (o == MIXED) mixed += c;
+          else packed [o] += c;
+        }
+
+        if (unpacked.size () > 0) {
+          _intervals += unpacked;
+          if (_intervals.is_bottom ()) {
+            set_to_bottom ();
+            return;
+          }
+        }
+        for (unsigned p=0; p < packed.size (); p++) {
+          if (packed [p].size () == 0) continue;
+          _packs [p] += packed [p];
+          if (_packs [p].is_bottom ()) {
+            set_to_bottom ();
+            return;
+          }
+        }
+        if (mixed.size () > 0) {
+          CRAB_STATS_COUNT (getDomainName () + ".count.mixed");
+          variable_set_t vars = mixed.variables ();
+          std::vector<varname_t> names;
+          for (auto const &v: vars) names.push_back (v.name ());
+          interval_domain_t tmp = get_intervals (names);
+          tmp += mixed;
+          if (tmp.is_bottom ()) {
+            set_to_bottom ();
+            return;
+          }
+          for (auto const &v: names) {
+            if (_is_bottom) return;
+            refine (v, tmp [v]);
+          }
+        }
+      }
+
+      void operator-=(varname_t v) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (v);
+        if (o == UNPACKED) _intervals -= v;
+        else _packs [o] -= v;
+      }
+
+      void assign (varname_t x, linear_expression_t e) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.assign");
+        CRAB_STATS_SCOPE (getDomainName () + ".assign");
+        repack ();
+        if (_is_bottom) return;
+        variable_set_t vars = e.variables ();
+        int o = owner (vars + variable_t (x));
+        if (o == UNPACKED) {
+          _intervals.assign (x, e);
+        } else if (o != MIXED) {
+          _packs [o].assign (x, e);
+        } else {
+          std::vector<varname_t> names;
+          for (auto const &v: vars) names.push_back (v.name ());
+          interval_domain_t tmp = get_intervals (names);
+          tmp.assign (x, e);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      void apply (operation_t op, varname_t x, varname_t y, varname_t z) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName () + ".apply");
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (owner (x), y), z);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, z);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, z);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y, z});
+          tmp.apply (op, x, y, z);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      void apply (operation_t op, varname_t x, varname_t y, number_t k) {
+        CRAB_STATS_COUNT (getDomainName () + ".count.apply");
+        CRAB_STATS_SCOPE (getDomainName () + ".apply");
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (x), y);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, k);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, k);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y});
+          tmp.apply (op, x, y, k);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      // bitwise_operators_api
+
+      void apply (conv_operation_t op, varname_t x, varname_t y, unsigned width) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (x), y);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, width);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, width);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y});
+          tmp.apply (op, x, y, width);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      void apply (conv_operation_t op, varname_t x, number_t k, unsigned width) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (x);
+        if (o == UNPACKED) _intervals.apply (op, x, k, width);
+        else _packs [o].apply (op, x, k, width);
+      }
+
+      void apply (bitwise_operation_t op, varname_t x, varname_t y, varname_t z) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (owner (x), y), z);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, z);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, z);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y, z});
+          tmp.apply (op, x, y, z);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      void apply (bitwise_operation_t op, varname_t x, varname_t y, number_t k) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (x), y);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, k);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, k);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y});
+          tmp.apply (op, x, y, k);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      // division_operators_api
+
+      void apply (div_operation_t op, varname_t x, varname_t y, varname_t z) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (owner (x), y), z);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, z);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, z);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y, z});
+          tmp.apply (op, x, y, z);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      void apply (div_operation_t op, varname_t x, varname_t y, number_t k) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (x), y);
+        if (o == UNPACKED) {
+          _intervals.apply (op, x, y, k);
+        } else if (o != MIXED) {
+          _packs [o].apply (op, x, y, k);
+        } else {
+          interval_domain_t tmp = get_intervals (std::vector<varname_t> {y});
+          tmp.apply (op, x, y, k);
+          assign_mixed (x, tmp);
+        }
+      }
+
+      template<typename Range>
+      void forget (Range vars) {
+        repack ();
+        if (_is_bottom) return;
+        std::vector<varname_t> unpacked;
+        std::vector<std::vector<varname_t> > packed (_packs.size ());
+        for (auto const &v: vars) {
+          int o = owner (v);
+          if (o == UNPACKED) unpacked.push_back (v);
+          else packed [o].push_back (v);
+        }
+        domain_traits<interval_domain_t>::forget (_intervals, unpacked.begin (),
+                                                  unpacked.end ());
+        for (unsigned p=0; p < packed.size (); p++) {
+          if (packed [p].empty ()) continue;
+          domain_traits<Dom>::forget (_packs [p], packed [p].begin (), packed [p].end ());
+        }
+      }
+
+      template<typename Range>
+      void project (Range vars) {
+        repack ();
+        if (_is_bottom) return;
+        std::vector<varname_t> unpacked;
+        std::vector<std::vector<varname_t> > packed (_packs.size ());
+        for (auto const &v: vars) {
+          int o = owner (v);
+          if (o == UNPACKED) unpacked.push_back (v);
+          else packed [o].push_back (v);
+        }
+        domain_traits<interval_domain_t>::project (_intervals, unpacked.begin (),
+                                                   unpacked.end ());
+        for (unsigned p=0; p < packed.size (); p++) {
+          if (packed [p].empty ()) _packs [p] = Dom::top ();
+          else domain_traits<Dom>::project (_packs [p], packed [p].begin (),
+                                            packed [p].end ());
+        }
+      }
+
+      void expand (varname_t x, varname_t new_x) {
+        repack ();
+        if (_is_bottom) return;
+        int o = owner (owner (x), new_x);
+        if (o == UNPACKED)
+          domain_traits<interval_domain_t>::expand (_intervals, x, new_x);
+        else if (o != MIXED)
+          domain_traits<Dom>::expand (_packs [o], x, new_x);
+        else
+          set (new_x, operator[] (x));
+      }
+
+      void write (crab_os &o) {
+        if (is_bottom ()) {
+          o << "_|_";
+          return;
+        }
+        linear_constraint_system_t csts = to_linear_constraint_system ();
+        o << csts;
+      }
+
+      linear_constraint_system_t to_linear_constraint_system () {
+        linear_constraint_system_t csts;
+        if (_is_bottom) {
+          csts += linear_constraint_t (linear_expression_t (number_t (1)) ==
+                                       linear_expression_t (number_t (0)));
+          return csts;
+        }
+        csts += _intervals.to_linear_constraint_system ();
+        for (auto &d: _packs)
+          csts += d.to_linear_constraint_system ();
+        return csts;
+      }
+
+      static std::string getDomainName () {
+        return "Packing(" + Dom::getDomainName () + ")";
+      }
+
+      //! Compute the packs of the CFG. The values built from now on
+      //! use them.
+      template<class CFG>
+      static void do_initialization (CFG cfg) {
+        CRAB_STATS_SCOPE (getDomainName () + ".packing");
+        current_packing () = packing_t::make (cfg);
+      }
+
+    }; // class var_packing_domain
+
+    template<typename Dom>
+    class domain_traits <var_packing_domain<Dom> > {
+     public:
+
+      typedef var_packing_domain<Dom> var_packing_domain_t;
+      typedef typename var_packing_domain_t::varname_t VariableName;
+
+      template<class CFG>
+      static void do_initialization (CFG cfg) {
+        var_packing_domain_t::do_initialization (cfg);
+      }
+
+      static void normalize (var_packing_domain_t& inv) {
+        inv.normalize ();
+      }
+
+      static void expand (var_packing_domain_t& inv, VariableName x, VariableName new_x) {
+        inv.expand (x, new_x);
+      }
+
+      template <typename Iter>
+      static void forget (var_packing_domain_t& inv, Iter it, Iter end) {
+        inv.forget (boost::make_iterator_range (it, end));
+      }
+
+      template <typename Iter>
+      static void project (var_packing_domain_t& inv, Iter it, Iter end) {
+        inv.project (boost::make_iterator_range (it, end));
+      }
+    };
+
+  } // end namespace domains
+} // end namespace crab
+
+#endif
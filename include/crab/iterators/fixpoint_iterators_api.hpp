@@ -49,9 +49,12 @@ namespace ikos {
   public:
     virtual void analyze(NodeName, AbstractValue&) = 0;
     
-    virtual void process_pre(NodeName, AbstractValue) = 0;
+    // Called once per node after the fixpoint is reached. The
+    // invariant is passed by reference so that it can be
+    // post-processed in place.
+    virtual void process_pre(NodeName, AbstractValue&) = 0;
     
-    virtual void process_post(NodeName, AbstractValue) = 0;
+    virtual void process_post(NodeName, AbstractValue&) = 0;
     
     virtual ~forward_fixpoint_iterator() { }
     
@@ -46,11 +46,16 @@
 #define IKOS_FWD_FIXPOINT_ITERATORS_HPP
 
 #include <map>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <boost/unordered_set.hpp>
 #include <crab/common/types.hpp>
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
 #include <crab/iterators/wto.hpp>
+#include <crab/iterators/invariant_table.hpp>
 #include <crab/iterators/fixpoint_iterators_api.hpp>
 #include <crab/iterators/thresholds.hpp>
 
@@ -63,6 +68,9 @@ namespace ikos {
 
     template< typename NodeName, typename CFG, typename AbstractValue >
     class wto_processor;
+
+    template< typename NodeName, typename CFG >
+    class wto_component_head;
     
   } // namespace interleaved_fwd_fixpoint_iterator_impl
   
@@ -71,20 +79,24 @@ namespace ikos {
       public forward_fixpoint_iterator< NodeName, CFG, AbstractValue > {
 
     friend class interleaved_fwd_fixpoint_iterator_impl::wto_iterator< NodeName, CFG, AbstractValue >;
+    friend class interleaved_fwd_fixpoint_iterator_impl::wto_processor< NodeName, CFG, AbstractValue >;
 
   public:
     typedef wto< NodeName, CFG> wto_t;
+    typedef ikos::invariant_table< NodeName, AbstractValue > invariant_table_t;
 
   private:
-    typedef std::map< NodeName, AbstractValue > invariant_table_t;
-    typedef boost::shared_ptr< invariant_table_t > invariant_table_ptr;
+    typedef typename invariant_table_t::node_index_t node_index_t;
+    typedef typename wto_t::wto_nesting_t wto_nesting_t;
     typedef interleaved_fwd_fixpoint_iterator_impl::wto_iterator< NodeName, CFG, AbstractValue > wto_iterator_t;
     typedef interleaved_fwd_fixpoint_iterator_impl::wto_processor< NodeName, CFG, AbstractValue > wto_processor_t;
     typedef crab::iterators::thresholds_t thresholds_t;
     
     CFG _cfg;
     wto_t _wto;
-    invariant_table_ptr _pre, _post;
+    // invariants are kept after the fixpoint is computed so that
+    // clients (e.g., fwd_analyzer) can query them without copies.
+    invariant_table_t _pre, _post;
     // number of iterations until triggering widening
     unsigned int _widening_delay;
     // number of narrowing iterations. If the narrowing operator is
@@ -98,26 +110,17 @@ namespace ikos {
     // set of thresholds to jump during widening
     thresholds_t _jump_set;
 
-    void set(invariant_table_ptr table, NodeName node, const AbstractValue& v) {
-      std::pair< typename invariant_table_t::iterator, bool > res = 
-          table->insert(std::make_pair(node, v));
-      if (!res.second) {
-        (res.first)->second = v;
-      }
-    }
-    
     void set_pre(NodeName node, const AbstractValue& v) {
-      this->set(this->_pre, node, v);
+      this->_pre.set(node, v);
     }
 
     void set_post(NodeName node, const AbstractValue& v) {
-      this->set(this->_post, node, v);
+      this->_post.set(node, v);
     }
 
-    AbstractValue get(invariant_table_ptr table, NodeName n) {
-      typename invariant_table_t::iterator it = table->find(n);
-      if (it != table->end()) {
-        return it->second;
+    AbstractValue get(const invariant_table_t& table, NodeName n) const {
+      if (const AbstractValue* v = table.find(n)) {
+        return *v;
       } else {
         return AbstractValue::bottom();
       }
@@ -198,8 +201,8 @@ namespace ikos {
                                       size_t jump_set_size): 
         _cfg(cfg),
         _wto(cfg),
-        _pre(boost::make_shared<invariant_table_t>()),
-        _post(boost::make_shared<invariant_table_t>()),
+        _pre(boost::make_shared<node_index_t>(_wto)),
+        _post(_pre.get_index()),
         _widening_delay(widening_delay),
         _descending_iterations(descending_iterations),
         _use_widening_jump_set (jump_set_size > 0) {
@@ -230,19 +233,36 @@ namespace ikos {
       return this->get(this->_post, node);
     }
 
+    const invariant_table_t& get_pre_table() const {
+      return this->_pre;
+    }
+
+    const invariant_table_t& get_post_table() const {
+      return this->_post;
+    }
+
+    invariant_table_t& get_pre_table() {
+      return this->_pre;
+    }
+
+    invariant_table_t& get_post_table() {
+      return this->_post;
+    }
+
     void run(AbstractValue init) {
-      crab::ScopedCrabStats __st__("Fixpo");
+      CRAB_STATS_SCOPE ("Fixpo");
+      reset ();
       this->set_pre(this->_cfg.entry(), init);
       wto_iterator_t iterator(this);
       this->_wto.accept(&iterator);
       wto_processor_t processor(this);
       this->_wto.accept(&processor);
-      reset ();
     }
 
     void run(AbstractValue init,
 	     std::map<NodeName,AbstractValue> &invars) {
-      crab::ScopedCrabStats __st__("Fixpo");
+      CRAB_STATS_SCOPE ("Fixpo");
+      reset ();
       this->set_pre(this->_cfg.entry(), init);
       wto_iterator_t iterator(this, &invars);
       this->_wto.accept(&iterator);
@@ -250,9 +270,76 @@ namespace ikos {
       this->_wto.accept(&processor);
     }
 
+    // Recompute the invariants after the CFG has been modified.
+    //
+    // changed must contain every node whose statements,
+    // predecessors or successors were modified (including new
+    // nodes). The WTO is recomputed and the invariants of the nodes
+    // which are not reachable from changed are reused. The
+    // interleaved iteration is restarted only on the top-level WTO
+    // components that contain a reachable node, starting from the
+    // earliest one.
+    //
+    // pre: run was called before and the entry has not changed.
+    void rerun(const std::vector<NodeName>& changed) {
+      typedef interleaved_fwd_fixpoint_iterator_impl::wto_component_head< NodeName, CFG > wto_head_t;
+
+      CRAB_STATS_SCOPE ("Fixpo");
+      const AbstractValue* entry_inv = this->_pre.find(this->_cfg.entry());
+      if (!entry_inv) {
+        CRAB_ERROR("fixpoint iterator: rerun called before run");
+      }
+      AbstractValue init(*entry_inv);
+
+      this->_wto = wto_t(this->_cfg);
+      boost::shared_ptr< node_index_t > index = boost::make_shared< node_index_t >(this->_wto);
+      this->_pre.reindex(index);
+      this->_post.reindex(index);
+
+      // nodes reachable from the changed ones
+      boost::unordered_set< NodeName > dirty;
+      std::vector< NodeName > worklist;
+      for (NodeName n : changed) {
+        std::size_t idx;
+        if (index->find(n, idx) && dirty.insert(n).second) {
+          worklist.push_back(n);
+        }
+      }
+      while (!worklist.empty()) {
+        NodeName n = worklist.back();
+        worklist.pop_back();
+        for (NodeName succ : this->_cfg.next_nodes(n)) {
+          if (dirty.insert(succ).second) {
+            worklist.push_back(succ);
+          }
+        }
+      }
+
+      // top-level components that contain a dirty node, identified
+      // by their head
+      boost::unordered_set< NodeName > dirty_components;
+      for (NodeName n : dirty) {
+        wto_nesting_t nesting = this->_wto.nesting(n);
+        typename wto_nesting_t::iterator it = nesting.begin();
+        dirty_components.insert(it == nesting.end() ? n : *it);
+      }
+
+      this->set_pre(this->_cfg.entry(), init);
+      wto_iterator_t iterator(this);
+      for (typename wto_t::iterator it = this->_wto.begin(); it != this->_wto.end(); ++it) {
+        wto_head_t head;
+        it->accept(&head);
+        if (dirty_components.count(head.get())) {
+          it->accept(&iterator);
+        }
+      }
+      wto_processor_t processor(this);
+      this->_wto.accept(&processor);
+    }
+
     void reset () {
-      this->_pre.reset();
-      this->_post.reset();      
+      this->_pre.clear();
+      this->_post.clear();
     }
         
   }; // class interleaved_fwd_fixpoint_iterator
@@ -410,22 +497,53 @@ namespace ikos {
     public:
       wto_processor(interleaved_iterator_t *iterator): _iterator(iterator) { }
       
+      void process(NodeName node) {
+        if (AbstractValue* pre = this->_iterator->_pre.find(node)) {
+          this->_iterator->process_pre(node, *pre);
+        }
+        if (AbstractValue* post = this->_iterator->_post.find(node)) {
+          this->_iterator->process_post(node, *post);
+        }
+      }
+
       void visit(wto_vertex_t& vertex) {
-        NodeName node = vertex.node();
-        this->_iterator->process_pre(node, this->_iterator->get_pre(node));
-        this->_iterator->process_post(node, this->_iterator->get_post(node));
+        process(vertex.node());
       }
       
       void visit(wto_cycle_t& cycle) {
-        NodeName head = cycle.head();
-        this->_iterator->process_pre(head, this->_iterator->get_pre(head));
-        this->_iterator->process_post(head, this->_iterator->get_post(head));
+        process(cycle.head());
         for (typename wto_cycle_t::iterator it = cycle.begin(); it != cycle.end(); ++it) {
           it->accept(this);
         }	
       }
       
     }; // class wto_processor
+
+    // Return the first node of a WTO component
+    template< typename NodeName, typename CFG >
+    class wto_component_head: public wto_component_visitor< NodeName, CFG > {
+
+    public:
+      typedef wto_vertex< NodeName, CFG > wto_vertex_t;
+      typedef wto_cycle< NodeName, CFG > wto_cycle_t;
+
+    private:
+      boost::optional< NodeName > _head;
+
+    public:
+      void visit(wto_vertex_t& vertex) {
+        this->_head = vertex.node();
+      }
+
+      void visit(wto_cycle_t& cycle) {
+        this->_head = cycle.head();
+      }
+
+      NodeName get() const {
+        return *this->_head;
+      }
+
+    }; // class wto_component_head
   
   } // interleaved_fwd_fixpoint_iterator_impl  
 } // namespace ikos
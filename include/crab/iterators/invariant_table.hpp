@@ -0,0 +1,175 @@
+#ifndef IKOS_INVARIANT_TABLE_HPP
+#define IKOS_INVARIANT_TABLE_HPP
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/unordered_map.hpp>
+#include <crab/iterators/wto.hpp>
+
+/*
+   Tables of invariants indexed by dense node numbers.
+
+   The node index is computed once from the WTO of the CFG and it is
+   shared by all the tables of a fixpoint iterator. Each table stores
+   its invariants contiguously in a vector so that lookups do not
+   need any tree traversal and iterating over a table visits its
+   entries in WTO order.
+*/
+
+namespace ikos {
+
+  // Map each node of a CFG to a dense index in [0, size ()).
+  template< typename NodeName >
+  class node_index {
+
+    typedef boost::unordered_map< NodeName, std::size_t > index_map_t;
+    index_map_t _index;
+
+  public:
+    node_index() { }
+
+    template< typename CFG >
+    node_index(wto< NodeName, CFG >& w) {
+      index_builder< CFG > builder(*this);
+      w.accept(&builder);
+    }
+
+    std::size_t size() const {
+      return this->_index.size();
+    }
+
+    // Return false if n has not been indexed
+    bool find(NodeName n, std::size_t& idx) const {
+      typename index_map_t::const_iterator it = this->_index.find(n);
+      if (it == this->_index.end()) return false;
+      idx = it->second;
+      return true;
+    }
+
+    std::size_t insert(NodeName n) {
+      return this->_index.insert(std::make_pair(n, this->_index.size())).first->second;
+    }
+
+  private:
+    template< typename CFG >
+    class index_builder: public wto_component_visitor< NodeName, CFG > {
+      node_index& _index;
+
+    public:
+      typedef wto_vertex< NodeName, CFG > wto_vertex_t;
+      typedef wto_cycle< NodeName, CFG > wto_cycle_t;
+
+      index_builder(node_index& index): _index(index) { }
+
+      void visit(wto_vertex_t& vertex) {
+        this->_index.insert(vertex.node());
+      }
+
+      void visit(wto_cycle_t& cycle) {
+        this->_index.insert(cycle.head());
+        for (typename wto_cycle_t::iterator it = cycle.begin(); it != cycle.end(); ++it) {
+          it->accept(this);
+        }
+      }
+    }; // class index_builder
+
+  }; // class node_index
+
+  template< typename NodeName, typename AbstractValue >
+  class invariant_table {
+
+  public:
+    typedef node_index< NodeName > node_index_t;
+    typedef boost::shared_ptr< node_index_t > node_index_ptr;
+    typedef std::pair< NodeName, AbstractValue > entry_t;
+
+  private:
+    typedef std::vector< entry_t > entry_vector_t;
+    static const std::size_t absent = static_cast< std::size_t >(-1);
+
+    node_index_ptr _index;
+    // _slots[i] is the position in _entries of the node with index i
+    std::vector< std::size_t > _slots;
+    entry_vector_t _entries;
+
+    std::size_t slot(NodeName n) const {
+      std::size_t idx;
+      if (!this->_index->find(n, idx) || idx >= this->_slots.size()) {
+        return absent;
+      }
+      return this->_slots[idx];
+    }
+
+  public:
+    typedef typename entry_vector_t::iterator iterator;
+    typedef typename entry_vector_t::const_iterator const_iterator;
+
+    invariant_table(node_index_ptr index): _index(index) {
+      this->_slots.assign(this->_index->size(), absent);
+    }
+
+    // Return a pointer to the invariant of n or null if n is not in
+    // the table.
+    AbstractValue* find(NodeName n) {
+      std::size_t s = this->slot(n);
+      return (s == absent) ? nullptr : &(this->_entries[s].second);
+    }
+
+    const AbstractValue* find(NodeName n) const {
+      std::size_t s = this->slot(n);
+      return (s == absent) ? nullptr : &(this->_entries[s].second);
+    }
+
+    void set(NodeName n, const AbstractValue& v) {
+      std::size_t idx = this->_index->insert(n);
+      if (idx >= this->_slots.size()) {
+        this->_slots.resize(idx + 1, absent);
+      }
+      std::size_t& s = this->_slots[idx];
+      if (s == absent) {
+        s = this->_entries.size();
+        this->_entries.push_back(entry_t(n, v));
+      } else {
+        this->_entries[s].second = v;
+      }
+    }
+
+    // Move the entries to a new node index. The entries of nodes
+    // that are not in the new index are discarded.
+    void reindex(node_index_ptr index) {
+      entry_vector_t entries;
+      entries.swap(this->_entries);
+      this->_index = index;
+      this->_slots.assign(this->_index->size(), absent);
+      for (typename entry_vector_t::iterator it = entries.begin(); it != entries.end(); ++it) {
+        std::size_t idx;
+        if (this->_index->find(it->first, idx)) {
+          this->_slots[idx] = this->_entries.size();
+          this->_entries.push_back(std::move(*it));
+        }
+      }
+    }
+
+    void clear() {
+      this->_slots.assign(this->_index->size(), absent);
+      this->_entries.clear();
+    }
+
+    node_index_ptr get_index() const { return this->_index; }
+
+    std::size_t size() const { return this->_entries.size(); }
+
+    iterator begin() { return this->_entries.begin(); }
+    iterator end() { return this->_entries.end(); }
+    const_iterator begin() const { return this->_entries.begin(); }
+    const_iterator end() const { return this->_entries.end(); }
+
+  }; // class invariant_table
+
+  template< typename NodeName, typename AbstractValue >
+  const std::size_t invariant_table< NodeName, AbstractValue >::absent;
+
+} // namespace ikos
+
+#endif // IKOS_INVARIANT_TABLE_HPP
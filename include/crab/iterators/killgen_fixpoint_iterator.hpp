@@ -15,6 +15,13 @@
 #include <crab/domains/patricia_trees.hpp>
 
 #include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
 
 namespace crab {
 
@@ -141,6 +148,233 @@ namespace crab {
       
     };
 
+    // A set of Element represented as a dense bitset.
+    //
+    // The elements are identified by their position in a universe
+    // (i.e., a vector of Element) built by the client analysis: a
+    // bitset only stores the positions. All operations are done one
+    // machine word at a time by loops that the compiler can
+    // vectorize. Bottom is the empty set.
+    template<class Element>
+    class bitset_killgen_domain: public ikos::writeable {
+
+      typedef bitset_killgen_domain<Element> bitset_killgen_domain_t;
+      typedef uint64_t word_t;
+      static const std::size_t word_bits = 64;
+
+     public:
+
+      typedef Element element_t;
+      typedef std::vector<Element> universe_t;
+
+     private:
+
+      bool _is_top;
+      std::vector<word_t> _words;
+      // to print the elements (it can be null)
+      const universe_t* _universe;
+
+      bitset_killgen_domain(bool is_top)
+          : ikos::writeable(), _is_top(is_top), _universe(nullptr) { }
+
+      word_t word(std::size_t i) const {
+        return i < _words.size() ? _words[i] : 0;
+      }
+
+      void reserve_words(std::size_t n) {
+        if (_words.size() < n) _words.resize(n, 0);
+      }
+
+     public:
+
+      class iterator {
+        const std::vector<word_t>* _words;
+        std::size_t _pos;
+
+        void skip() {
+          std::size_t n = _words->size() * word_bits;
+          while (_pos < n) {
+            word_t w = (*_words)[_pos / word_bits] >> (_pos % word_bits);
+            if (w == 0) {
+              _pos = (_pos / word_bits + 1) * word_bits;
+            } else {
+              while (!(w & 1)) { w >>= 1; ++_pos; }
+              return;
+            }
+          }
+          _pos = n;
+        }
+
+       public:
+        iterator(const std::vector<word_t>* words, std::size_t pos)
+            : _words(words), _pos(pos) { skip(); }
+
+        // the position of the element in the universe
+        std::size_t operator*() const { return _pos; }
+
+        iterator& operator++() { ++_pos; skip(); return *this; }
+
+        bool operator==(const iterator& o) const { return _pos == o._pos; }
+
+        bool operator!=(const iterator& o) const { return _pos != o._pos; }
+      };
+
+      static bitset_killgen_domain_t top() {
+        return bitset_killgen_domain_t(true);
+      }
+
+      static bitset_killgen_domain_t bottom() {
+        return bitset_killgen_domain_t(false);
+      }
+
+      bitset_killgen_domain()
+          : ikos::writeable(), _is_top(false), _universe(nullptr) { }
+
+      explicit bitset_killgen_domain(const universe_t* universe)
+          : ikos::writeable(), _is_top(false), _universe(universe) { }
+
+      bitset_killgen_domain(const bitset_killgen_domain_t& o)
+          : ikos::writeable(), _is_top(o._is_top),
+            _words(o._words), _universe(o._universe) { }
+
+      bitset_killgen_domain(bitset_killgen_domain_t&& o)
+          : ikos::writeable(), _is_top(o._is_top),
+            _words(std::move(o._words)), _universe(o._universe) { }
+
+      bitset_killgen_domain_t& operator=(const bitset_killgen_domain_t& o) {
+        if (this != &o) {
+          _is_top = o._is_top;
+          _words = o._words;
+          if (o._universe) _universe = o._universe;
+        }
+        return *this;
+      }
+
+      bitset_killgen_domain_t& operator=(bitset_killgen_domain_t&& o) {
+        _is_top = o._is_top;
+        _words = std::move(o._words);
+        if (o._universe) _universe = o._universe;
+        return *this;
+      }
+
+      iterator begin() const { return iterator(&_words, 0); }
+
+      iterator end() const { return iterator(&_words, _words.size() * word_bits); }
+
+      unsigned size() const {
+        unsigned n = 0;
+        for (word_t w: _words) n += std::bitset<word_bits>(w).count();
+        return n;
+      }
+
+      bool is_bottom() const {
+        if (_is_top) return false;
+        for (word_t w: _words)
+          if (w) return false;
+        return true;
+      }
+
+      bool is_top() const { return _is_top; }
+
+      bool contains(std::size_t pos) const {
+        return _is_top || (word(pos / word_bits) >> (pos % word_bits)) & 1;
+      }
+
+      void add(std::size_t pos) {
+        if (_is_top) return;
+        reserve_words(pos / word_bits + 1);
+        _words[pos / word_bits] |= (word_t) 1 << (pos % word_bits);
+      }
+
+      void remove(std::size_t pos) {
+        if (_is_top || pos / word_bits >= _words.size()) return;
+        _words[pos / word_bits] &= ~((word_t) 1 << (pos % word_bits));
+      }
+
+      bool operator<=(const bitset_killgen_domain_t& o) const {
+        if (o._is_top) return true;
+        if (_is_top) return false;
+        const std::size_t n = std::min(_words.size(), o._words.size());
+        const word_t* a = _words.data();
+        const word_t* b = o._words.data();
+        word_t diff = 0;
+        for (std::size_t i = 0; i < n; ++i) diff |= a[i] & ~b[i];
+        for (std::size_t i = n; i < _words.size(); ++i) diff |= a[i];
+        return diff == 0;
+      }
+
+      bool operator==(const bitset_killgen_domain_t& o) const {
+        if (_is_top || o._is_top) return _is_top == o._is_top;
+        const std::size_t n = std::max(_words.size(), o._words.size());
+        word_t diff = 0;
+        for (std::size_t i = 0; i < n; ++i) diff |= word(i) ^ o.word(i);
+        return diff == 0;
+      }
+
+      void operator-=(const bitset_killgen_domain_t& o) {
+        if (o._is_top) {
+          _is_top = false;
+          _words.clear();
+          return;
+        }
+        if (_is_top) return;
+        const std::size_t n = std::min(_words.size(), o._words.size());
+        word_t* a = _words.data();
+        const word_t* b = o._words.data();
+        for (std::size_t i = 0; i < n; ++i) a[i] &= ~b[i];
+      }
+
+      void operator+=(const bitset_killgen_domain_t& o) {
+        if (_is_top) return;
+        if (o._is_top) {
+          _is_top = true;
+          _words.clear();
+          return;
+        }
+        if (!_universe) _universe = o._universe;
+        reserve_words(o._words.size());
+        word_t* a = _words.data();
+        const word_t* b = o._words.data();
+        for (std::size_t i = 0, n = o._words.size(); i < n; ++i) a[i] |= b[i];
+      }
+
+      bitset_killgen_domain_t operator|(const bitset_killgen_domain_t& o) const {
+        bitset_killgen_domain_t res(*this);
+        res += o;
+        return res;
+      }
+
+      bitset_killgen_domain_t operator&(const bitset_killgen_domain_t& o) const {
+        if (_is_top) return o;
+        if (o._is_top) return *this;
+        bitset_killgen_domain_t res(*this);
+        if (!res._universe) res._universe = o._universe;
+        res._words.resize(std::min(_words.size(), o._words.size()));
+        word_t* a = res._words.data();
+        const word_t* b = o._words.data();
+        for (std::size_t i = 0, n = res._words.size(); i < n; ++i) a[i] &= b[i];
+        return res;
+      }
+
+      void write(crab_os& o) {
+        if (_is_top) {
+          o << "{...}";
+          return;
+        }
+        o << "{";
+        for (iterator it = begin(), et = end(); it != et;) {
+          if (_universe && *it < _universe->size()) {
+            o << (*_universe)[*it];
+          } else {
+            o << "#" << *it;
+          }
+          ++it;
+          if (it != et) o << ";";
+        }
+        o << "}";
+      }
+    };
+
     // To represent sets of pairs (Key,Value). 
     // Bottom means empty set rather than failure.
     template <typename Key, typename Value>
@@ -421,57 +655,93 @@ namespace crab {
       /// For a backward analysis, (1) will converge faster.
       /// For all of this, we decide not to reverse graphs and have
       /// two dual versions for the forward and backward analyses.
+      ///
+      /// Both use a worklist: a block is only analyzed again if the
+      /// result of one of its predecessors (successors for the
+      /// backward analysis) changed. The pending block that comes
+      /// first in the order is always analyzed first.
+
+      typedef typename CFG::node_t node_t;
+
+      // Solve the equations of the analysis in the given order. The
+      // blocks are identified by their rank in the order so that the
+      // loop does not access the CFG nor the tables.
+      void run_worklist (const std::vector<node_t> &order, bool is_forward,
+                         unsigned &iterations) {
+        const unsigned n = order.size ();
+        boost::unordered_map<node_t, unsigned> rank;
+        for (unsigned i=0; i < n; ++i) rank[order[i]] = i;
+        // sources[i]: the blocks whose results are merged to obtain
+        // the input of block i
+        // targets[i]: the blocks that must be analyzed again if the
+        // result of block i changes
+        std::vector<std::vector<unsigned> > sources (n), targets (n);
+        for (unsigned i=0; i < n; ++i) {
+          if (is_forward) {
+            for (auto p: _cfg.prev_nodes (order[i])) sources[i].push_back (rank[p]);
+            for (auto s: _cfg.next_nodes (order[i])) targets[i].push_back (rank[s]);
+          } else {
+            for (auto s: _cfg.next_nodes (order[i])) sources[i].push_back (rank[s]);
+            for (auto p: _cfg.prev_nodes (order[i])) targets[i].push_back (rank[p]);
+          }
+        }
 
-      void run_fwd_fixpo (std::vector<typename CFG::node_t> &order,
-                          unsigned &iterations){
-
-        order = crab::analyzer::graph_algo::weak_topo_sort(_cfg);
-        assert ((int)order.size () == std::distance(_cfg.begin(), _cfg.end()));
-        bool change = true;
+        std::vector<killgen_domain_t> results (n);
+        std::vector<bool> pending (n, true);
+        std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned> > worklist;
+        for (unsigned i=0; i < n; ++i) worklist.push (i);
         iterations = 0;
-        while (change) {
-          change = false;
+        while (!worklist.empty ()) {
+          unsigned i = worklist.top ();
+          worklist.pop ();
+          pending[i] = false;
           ++iterations;
-          for (auto &n: order) {
-            auto in = _analysis.entry();
-            for (auto p: _cfg.prev_nodes (n))
-              in = _analysis.merge(in, _out_map[p]); 
-            auto old_out = _out_map[n];
-            auto out = _analysis.analyze(n, in);
-            if (!(out <= old_out)) {
-              _out_map[n] = _analysis.merge(out, old_out);
-              change = true;
-            } else 
-              _in_map[n] = in;
+          auto input = _analysis.entry ();
+          for (unsigned j: sources[i]) input = _analysis.merge (input, results[j]);
+          auto result = _analysis.analyze (order[i], input);
+          if (!(result <= results[i])) {
+            results[i] = _analysis.merge (result, results[i]);
+            for (unsigned j: targets[i]) {
+              if (!pending[j]) {
+                pending[j] = true;
+                worklist.push (j);
+              }
+            }
+          }
+        }
+
+        // the fixpoint is reached
+        for (unsigned i=0; i < n; ++i) {
+          auto input = _analysis.entry ();
+          for (unsigned j: sources[i]) input = _analysis.merge (input, results[j]);
+          if (is_forward) {
+            _in_map[order[i]] = input;
+            _out_map[order[i]] = results[i];
+          } else {
+            _out_map[order[i]] = input;
+            _in_map[order[i]] = results[i];
           }
         }
       }
+
+      void run_fwd_fixpo (std::vector<node_t> &order,
+                          unsigned &iterations){
+        order = crab::analyzer::graph_algo::weak_topo_sort(_cfg);
+        assert ((int)order.size () == std::distance(_cfg.begin(), _cfg.end()));
+        run_worklist (order, true, iterations);
+      }
       
-      void run_bwd_fixpo (std::vector<typename CFG::node_t> &order,
+      void run_bwd_fixpo (std::vector<node_t> &order,
                           unsigned &iterations){
-
         order = crab::analyzer::graph_algo::weak_rev_topo_sort(_cfg);
         assert ((int)order.size () == std::distance(_cfg.begin(), _cfg.end()));
-        bool change = true;
-        iterations = 0;
-        while (change) {
-          change = false;
-          ++iterations;
-          for (auto &n: order) {
-            auto out = _analysis.entry();
-            for (auto p: _cfg.next_nodes (n))
-              out = _analysis.merge(out, _in_map[p]); 
-            auto old_in = _in_map[n];
-            auto in = _analysis.analyze(n, out);
-            if (!(in <= old_in)) {
-              _in_map[n] = _analysis.merge(in, old_in);
-              change = true;
-            } else 
-              _out_map[n] = out;
-          }
-        }
+        run_worklist (order, false, iterations);
       }
 
+     protected:
+
+      const KgAnalysisOps& get_analysis () const { return _analysis; }
+
      public:
 
       killgen_fixpoint_iterator (CFG cfg)
@@ -487,7 +757,7 @@ namespace crab {
 
         _analysis.init_fixpoint(); 
 
-        std::vector<typename CFG::node_t> order;
+        std::vector<node_t> order;
         unsigned iterations = 0;
         if (_analysis.is_forward())
           run_fwd_fixpo(order, iterations);
@@ -507,7 +777,7 @@ namespace crab {
 
         CRAB_LOG(_analysis.name(), 
                  crab::outs() << _analysis.name() << ": " 
-                              << "fixpoint reached in " << iterations << " iterations.\n"); 
+                              << "fixpoint reached after analyzing " << iterations << " blocks.\n"); 
         
         CRAB_LOG(_analysis.name(), 
                  crab::outs() << _analysis.name() << " sets:\n";
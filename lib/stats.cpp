@@ -2,48 +2,257 @@
 
 #ifdef HAVE_STATS
 #include "crab/common/stats.hpp"
+#include "crab/common/debug.hpp"
+
+#include <mutex>
+#include <vector>
 
 namespace crab
 {
-  std::map<std::string,unsigned> CrabStats::counters;
-  std::map<std::string,Stopwatch> CrabStats::sw;
   std::map<std::string,Averager> CrabStats::av;
   std::map<std::string,std::string> CrabStats::ss;
+  thread_local stats_impl::shard* CrabStats::s_local = nullptr;
+
+  // The statistics can be updated by several analyses running in
+  // parallel. The registry of names and shards is protected by
+  // stats_mutex. Counters and timers are kept in one shard per thread
+  // and merged when they are read.
+  static std::mutex stats_mutex;
+  typedef std::lock_guard<std::mutex> stats_lock_t;
+
+  namespace stats_impl {
+
+    struct name_table {
+      std::map<std::string, unsigned> m_ids;
+      std::vector<std::string> m_names;
+
+      unsigned intern (const std::string &n) {
+        auto it = m_ids.find (n);
+        if (it != m_ids.end ()) return it->second;
+        if (m_names.size () >= block_size * max_blocks)
+          CRAB_ERROR ("too many statistics names");
+        unsigned id = m_names.size ();
+        m_ids.insert (std::make_pair (n, id));
+        m_names.push_back (n);
+        return id;
+      }
+    };
+
+    static name_table counter_names;
+    static name_table timer_names;
+    // Shards are never freed so that the statistics of threads that
+    // have finished are still reported.
+    static std::vector<shard*> shards;
+    // Adjustment added to the sum of the shards of a counter (see uset)
+    static std::map<unsigned, long long> counter_base;
+
+    shard::shard () {
+      for (unsigned b=0; b < max_blocks; b++) {
+        m_counters [b].store (nullptr);
+        m_timers [b].store (nullptr);
+      }
+    }
+
+    shard::~shard () {
+      for (unsigned b=0; b < max_blocks; b++) {
+        delete [] m_counters [b].load ();
+        delete [] m_timers [b].load ();
+      }
+    }
+
+    std::atomic<unsigned long long>* shard::new_counters (unsigned b) {
+      auto c = new std::atomic<unsigned long long> [block_size];
+      for (unsigned i=0; i < block_size; i++) c [i].store (0);
+      m_counters [b].store (c, std::memory_order_release);
+      return c;
+    }
+
+    timer_slot* shard::new_timers (unsigned b) {
+      auto t = new timer_slot [block_size];
+      for (unsigned i=0; i < block_size; i++) {
+        t [i].m_elapsed.store (0);
+        t [i].m_started = 0;
+        t [i].m_running = false;
+        t [i].m_used.store (false);
+      }
+      m_timers [b].store (t, std::memory_order_release);
+      return t;
+    }
+
+    unsigned long long shard::read_counter (unsigned id) const {
+      auto c = m_counters [id / block_size].load (std::memory_order_acquire);
+      return c ? c [id % block_size].load (std::memory_order_relaxed) : 0;
+    }
+
+    const timer_slot* shard::read_timer (unsigned id) const {
+      auto t = m_timers [id / block_size].load (std::memory_order_acquire);
+      return t ? &t [id % block_size] : nullptr;
+    }
+
+    // pre: the owner thread is not updating the shard
+    void shard::clear () {
+      for (unsigned b=0; b < max_blocks; b++) {
+        if (auto c = m_counters [b].load ())
+          for (unsigned i=0; i < block_size; i++) c [i].store (0);
+        if (auto t = m_timers [b].load ())
+          for (unsigned i=0; i < block_size; i++) {
+            t [i].m_elapsed.store (0);
+            t [i].m_running = false;
+            t [i].m_used.store (false);
+          }
+      }
+    }
+
+    // pre: stats_mutex is held
+    static long long merged_counter (unsigned id) {
+      long long v = 0;
+      for (auto s: shards) v += s->read_counter (id);
+      auto it = counter_base.find (id);
+      if (it != counter_base.end ()) v += it->second;
+      return v;
+    }
+
+    // Ticks and time when the library was loaded, to convert ticks
+    // into time
+    static const long long ticks0 = stats_ticks ();
+    static const long long ns0 = stats_clock_ns ();
+
+    static long ticks_to_usecs (long long ticks) {
+      long long dt = stats_ticks () - ticks0;
+      long long dns = stats_clock_ns () - ns0;
+      double ns_per_tick = (dt > 0 && dns > 0) ? (double) dns / dt : 1.0;
+      return (long) (ticks * ns_per_tick / 1000);
+    }
+
+    // Return false if the timer has never been used.
+    // pre: stats_mutex is held
+    static bool merged_timer (unsigned id, const shard* local, long &usecs) {
+      bool used = false;
+      long long ticks = 0;
+      for (auto s: shards) {
+        const timer_slot* t = s->read_timer (id);
+        if (!t || !t->m_used.load (std::memory_order_relaxed)) continue;
+        used = true;
+        ticks += t->m_elapsed.load (std::memory_order_relaxed);
+        // only the calling thread can safely read its running timers
+        if (s == local && t->m_running)
+          ticks += stats_ticks () - t->m_started;
+      }
+      usecs = ticks_to_usecs (ticks);
+      return used;
+    }
+
+    // Merge all counters and timers into maps ordered by name
+    // pre: stats_mutex is held
+    static void merge (const shard* local,
+                       std::map<std::string, unsigned> &counters,
+                       std::map<std::string, long> &timers) {
+      for (unsigned id=0; id < counter_names.m_names.size (); id++) {
+        long long v = merged_counter (id);
+        if (v != 0 || counter_base.count (id))
+          counters [counter_names.m_names [id]] = v;
+      }
+      for (unsigned id=0; id < timer_names.m_names.size (); id++) {
+        long usecs;
+        if (merged_timer (id, local, usecs))
+          timers [timer_names.m_names [id]] = usecs;
+      }
+    }
+  } // end namespace stats_impl
+
+  using namespace stats_impl;
+
+  stats_impl::shard& CrabStats::new_shard () {
+    stats_lock_t lock (stats_mutex);
+    s_local = new shard ();
+    shards.push_back (s_local);
+    return *s_local;
+  }
+
+  stats_counter CrabStats::counter (const std::string &n) {
+    stats_lock_t lock (stats_mutex);
+    return stats_counter {counter_names.intern (n)};
+  }
+
+  stats_timer CrabStats::timer (const std::string &n) {
+    stats_lock_t lock (stats_mutex);
+    return stats_timer {timer_names.intern (n)};
+  }
 
+  // pre: no analysis is running in another thread
   void CrabStats::reset () {
-    counters.clear();
-    sw.clear();
+    stats_lock_t lock (stats_mutex);
+    for (auto s: shards) s->clear ();
+    counter_base.clear ();
     av.clear();
     ss.clear();
   }
 
-  void CrabStats::count (const std::string &name) { ++counters[name]; }
   void CrabStats::count_max (const std::string &name, unsigned v) {
-      counters[name] = std::max (counters[name], v);
+    stats_counter c = counter (name);
+    stats_lock_t lock (stats_mutex);
+    long long cur = merged_counter (c.m_id);
+    counter_base [c.m_id] += std::max ((long long) v - cur, 0LL);
+  }
+
+  double CrabStats::avg (const std::string &n, double v) {
+    stats_lock_t lock (stats_mutex);
+    return av[n].add (v);
+  }
+
+  unsigned CrabStats::uset (const std::string &n, unsigned v) {
+    stats_counter c = counter (n);
+    stats_lock_t lock (stats_mutex);
+    counter_base [c.m_id] += (long long) v - merged_counter (c.m_id);
+    return v;
+  }
+
+  unsigned CrabStats::get (stats_counter c) {
+    stats_lock_t lock (stats_mutex);
+    // a counter that has been read is reported as in the previous
+    // string-keyed implementation
+    counter_base [c.m_id];
+    return merged_counter (c.m_id);
+  }
+
+  unsigned CrabStats::get (const std::string &n) {
+    return get (counter (n));
   }
 
-  double CrabStats::avg (const std::string &n, double v) { return av[n].add (v); }
-  unsigned CrabStats::uset (const std::string &n, unsigned v)
-  { return counters [n] = v; }
-  unsigned CrabStats::get (const std::string &n) { return counters [n]; }
+  void CrabStats::sset (const std::string &n, std::string v) {
+    stats_lock_t lock (stats_mutex);
+    ss [n] = v;
+  }
+  std::string& CrabStats::sget (const std::string &n) {
+    stats_lock_t lock (stats_mutex);
+    return ss[n];
+  }
 
-  void CrabStats::sset (const std::string &n, std::string v) {ss [n] = v;}
-  std::string& CrabStats::sget (const std::string &n) {return ss[n];}
-  
-  void CrabStats::start (const std::string &name) { sw[name].start (); }
-  void CrabStats::stop (const std::string &name) { sw[name].stop (); }
-  void CrabStats::resume (const std::string &name) { sw[name].resume (); }
+  void CrabStats::start (stats_timer t) {
+    auto &s = local ().timer (t.m_id);
+    s.m_elapsed.store (0, std::memory_order_relaxed);
+    s.m_running = false;
+    resume (t);
+  }
 
   /** Outputs all statistics to std output */
   void CrabStats::Print (crab_os &OS) {
+    stats_lock_t lock (stats_mutex);
+    std::map<std::string, unsigned> counters;
+    std::map<std::string, long> timers;
+    merge (s_local, counters, timers);
+
     OS << "\n\n************** STATS ***************** \n";
     for (auto &kv : ss)
       OS << kv.first << ": " << kv.second << "\n";
     for (auto &kv : counters)
       OS << kv.first << ": " << kv.second << "\n";
 
-    for (auto &kv : sw)
-      OS << kv.first << ": " << kv.second << "\n";
+    for (auto &kv : timers) {
+      OS << kv.first << ": ";
+      Stopwatch::Print (OS, kv.second);
+      OS << "\n";
+    }
 
     for (auto &kv : av)
       OS << kv.first << ": " << kv.second << "\n";
@@ -54,16 +263,21 @@ namespace crab
 
   void CrabStats::PrintBrunch (crab_os &OS)
   {
+    stats_lock_t lock (stats_mutex);
+    std::map<std::string, unsigned> counters;
+    std::map<std::string, long> timers;
+    merge (s_local, counters, timers);
+
     OS << "\n\n************** BRUNCH STATS ***************** \n";
-    for (auto &kv : ss) 
+    for (auto &kv : ss)
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
-    
+
     for (auto &kv : counters)
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
 
-    for (auto &kv : sw)
-      OS << "BRUNCH_STAT " << kv.first << " " 
-         << (kv.second).toSeconds() << "\n";
+    for (auto &kv : timers)
+      OS << "BRUNCH_STAT " << kv.first << " "
+         << ((double) kv.second / 1000000) << "\n";
 
     for (auto &kv : av)
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
@@ -72,9 +286,8 @@ namespace crab
   }
 
 
-  void Stopwatch::Print (crab_os &out) const
+  void Stopwatch::Print (crab_os &out, long time)
   {
-    long time = getTimeElapsed ();
     long h = time/3600000000L;
     long m = time/60000000L - h*60;
     float s = ((float)time/1000000L) - m*60 - h*3600;
@@ -82,8 +295,13 @@ namespace crab
     if (h > 0) out << h << "h";
     if (m > 0) out << m << "m";
     out << s << "s";
-  }  
-    
+  }
+
+  void Stopwatch::Print (crab_os &out) const
+  {
+    Print (out, getTimeElapsed ());
+  }
+
   void Averager::Print (crab_os &out) const { out << avg; }
 }
-#endif 
+#endif
@@ -0,0 +1,114 @@
+#include "../program_options.hpp"
+#include <crab/common/bignums.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/domains/intervals.hpp>
+
+/* 
+   Microbenchmark for z_number and q_number.
+
+   It runs the same arithmetic on GMP numbers (mpz_class and
+   mpq_class) and on ikos numbers, checks that both agree and
+   reports the time spent by each one.
+*/
+
+using namespace std;
+using namespace ikos;
+
+template<typename Z>
+Z z_kernel (const std::vector<long>& vals, unsigned rounds) {
+  Z acc (0);
+  for (unsigned r=0; r < rounds; r++) {
+    for (unsigned i=0; i+1 < vals.size (); i++) {
+      Z x (vals [i]);
+      Z y (vals [i+1]);
+      Z s = x + y;
+      Z d = x - y;
+      Z m = (x % 1000) * (y % 1000);
+      if (s < d) acc = acc + m;
+      else       acc = acc - m;
+      if (acc > 1000000000) acc = acc / 3;
+    }
+  }
+  return acc;
+}
+
+template<typename Q>
+Q q_kernel (const std::vector<long>& vals, unsigned rounds) {
+  Q acc (0);
+  for (unsigned r=0; r < rounds; r++) {
+    for (unsigned i=0; i+1 < vals.size (); i++) {
+      Q x (vals [i] % 1000);
+      Q y ((vals [i+1] % 7) + 8);
+      Q q = x / y;
+      if (q < acc) acc = acc - q;
+      else         acc = acc + q / 2;
+    }
+  }
+  return acc;
+}
+
+// bound arithmetic as done by the interval domain
+template<typename Number>
+interval<Number> itv_kernel (const std::vector<long>& vals, unsigned rounds) {
+  typedef interval<Number> interval_t;
+  interval_t acc (Number (0));
+  for (unsigned r=0; r < rounds; r++) {
+    for (unsigned i=0; i+1 < vals.size (); i++) {
+      interval_t x (Number (vals [i] % 100), Number (vals [i+1] % 100 + 100));
+      interval_t y = x + interval_t (Number (1));
+      acc = (acc | (x * y)) & interval_t (Number (-100000), Number (100000));
+    }
+  }
+  return acc;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  std::vector<long> vals;
+  long seed = 17;
+  for (unsigned i=0; i < 1000; i++) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    vals.push_back (seed - 1073741824);
+  }
+  const unsigned rounds = 200;
+
+  crab::Stopwatch sw;
+
+  sw.start ();
+  mpz_class r1 = z_kernel<mpz_class> (vals, rounds);
+  sw.stop ();
+  crab::outs () << "mpz_class: " << sw << "\n";
+
+  sw.start ();
+  z_number r2 = z_kernel<z_number> (vals, rounds);
+  sw.stop ();
+  crab::outs () << "z_number:  " << sw << "\n";
+
+  if (z_number (r1) != r2) {
+    crab::outs () << "ERROR: " << r1.get_str () << " != " << r2 << "\n";
+    return 1;
+  }
+
+  sw.start ();
+  mpq_class r3 = q_kernel<mpq_class> (vals, rounds);
+  sw.stop ();
+  crab::outs () << "mpq_class: " << sw << "\n";
+
+  sw.start ();
+  q_number r4 = q_kernel<q_number> (vals, rounds);
+  sw.stop ();
+  crab::outs () << "q_number:  " << sw << "\n";
+
+  if (q_number (r3) != r4) {
+    crab::outs () << "ERROR: " << r3.get_str () << " != " << r4 << "\n";
+    return 1;
+  }
+
+  sw.start ();
+  interval<z_number> r5 = itv_kernel<z_number> (vals, rounds);
+  sw.stop ();
+  crab::outs () << "interval<z_number>: " << sw << " result=" << r5 << "\n";
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+
+/*
+   Benchmark for the memory layout of the CFG.
+
+   It reports the time spent building a large CFG, cloning it and
+   visiting all its statements as the transfer function loop of the
+   fixpoint iterator does.
+*/
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+
+z_cfg_t* make_cfg (variable_factory_t &vfac, unsigned num_blocks, unsigned num_stmts) {
+  z_cfg_t* cfg = new z_cfg_t("b0", "b" + to_string (num_blocks - 1));
+  vector<z_var> vars;
+  for (unsigned i=0; i < 16; i++)
+    vars.push_back (z_var (vfac ["v" + to_string (i)]));
+
+  for (unsigned b=0; b < num_blocks; b++) {
+    z_basic_block_t& bb = cfg->insert ("b" + to_string (b));
+    for (unsigned s=0; s < num_stmts; s++) {
+      z_var &lhs = vars [(b + s) % vars.size ()];
+      z_var &op = vars [(b * 3 + s) % vars.size ()];
+      switch (s % 4) {
+        case 0: bb.add (lhs, op, 1); break;
+        case 1: bb.assign (lhs, op + 2); break;
+        case 2: bb.assume (op <= lhs + 10); break;
+        default: bb.havoc (lhs.name ()); break;
+      }
+    }
+    if (b > 0) cfg->get_node ("b" + to_string (b - 1)) >> bb;
+  }
+  return cfg;
+}
+
+// touch every statement through a virtual call as the abstract
+// transformer does
+struct count_visitor: public statement_visitor<ikos::z_number, varname_t> {
+  typedef statement_visitor<ikos::z_number, varname_t> base_t;
+  std::size_t m_count;
+  count_visitor (): m_count (0) { }
+  std::size_t uses (const z_cfg_t::statement_t &s) {
+    auto const &l = s.get_live ();
+    return std::distance (l.uses_begin (), l.uses_end ());
+  }
+  void visit (base_t::bin_op_t &s) { m_count += (s.op () == crab::BINOP_ADD); }
+  void visit (base_t::assign_t &s) { m_count += uses (s); }
+  void visit (base_t::assume_t &s) { m_count += uses (s); }
+  void visit (base_t::havoc_t &) { m_count++; }
+};
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  const unsigned num_blocks = 20000;
+  const unsigned stmts_per_block = 10;
+  const unsigned rounds = 3;
+  const unsigned passes = 20;
+
+  variable_factory_t vfac;
+  crab::Stopwatch sw;
+  double construct_time = 0, clone_time = 0, visit_time = 0;
+  std::size_t count = 0;
+
+  for (unsigned i=0; i < rounds; i++) {
+    sw.start ();
+    z_cfg_t* cfg = make_cfg (vfac, num_blocks, stmts_per_block);
+    sw.stop ();
+    if (i == 0 || sw.toSeconds () < construct_time) construct_time = sw.toSeconds ();
+
+    sw.start ();
+    boost::shared_ptr<z_cfg_t> copy = cfg->clone ();
+    sw.stop ();
+    if (i == 0 || sw.toSeconds () < clone_time) clone_time = sw.toSeconds ();
+
+    count_visitor vis;
+    sw.start ();
+    for (unsigned p=0; p < passes; p++)
+      for (auto &b: *copy)
+        for (auto &s: b) s.accept (&vis);
+    sw.stop ();
+    if (i == 0 || sw.toSeconds () < visit_time) visit_time = sw.toSeconds ();
+    count = vis.m_count;
+
+    crab::crab_string_os s1, s2;
+    s1 << *cfg;
+    s2 << *copy;
+    if (s1.str () != s2.str ()) {
+      crab::outs () << "ERROR: the clone differs from the original CFG\n";
+      delete cfg;
+      return 1;
+    }
+    delete cfg;
+  }
+
+  crab::outs () << num_blocks * stmts_per_block << " statements\n"
+                << "construction: " << construct_time << "s\n"
+                << "clone:        " << clone_time << "s\n"
+                << "visit (x" << passes << "):  " << visit_time << "s ("
+                << count << ")\n";
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <crab/cfg/cfg_binary.hpp>
+
+/*
+   Benchmark for the binary CFG format.
+
+   It builds a synthetic program statement by statement, writes it
+   in binary format and reports the time spent building the program
+   programmatically and loading it back from the file.
+*/
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+
+z_cfg_t* make_function (variable_factory_t &vfac, unsigned f,
+                        unsigned num_blocks, unsigned num_stmts) {
+  vector<pair<varname_t,crab::variable_type> > params;
+  params.push_back (make_pair (vfac["x"], crab::INT_TYPE));
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["f" + to_string (f)], params);
+  z_cfg_t* cfg = new z_cfg_t("b0", "b" + to_string (num_blocks - 1), decl);
+  vector<z_var> vars;
+  for (unsigned i=0; i < 8; i++)
+    vars.push_back (z_var (vfac ["v" + to_string (i)]));
+  z_var x (vfac ["x"]);
+
+  for (unsigned b=0; b < num_blocks; b++) {
+    z_basic_block_t& bb = cfg->insert ("b" + to_string (b));
+    for (unsigned s=0; s < num_stmts; s++) {
+      z_var &lhs = vars [(b + s) % vars.size ()];
+      z_var &op = vars [(b * 3 + s) % vars.size ()];
+      switch (s % 5) {
+        case 0: bb.add (lhs, op, x); break;
+        case 1: bb.assign (lhs, op + 2 * x - 1); break;
+        case 2: bb.assume (op <= lhs + 10); break;
+        case 3: bb.mul (lhs, op, 7); break;
+        default: bb.havoc (lhs.name ()); break;
+      }
+    }
+    if (b > 0) cfg->get_node ("b" + to_string (b - 1)) >> bb;
+    // a back edge every few blocks
+    if (b % 4 == 3) bb >> cfg->get_node ("b" + to_string (b - 3));
+  }
+  cfg->get_node ("b" + to_string (num_blocks - 1)).ret (vfac ["v0"], crab::INT_TYPE);
+  return cfg;
+}
+
+std::size_t num_stmts (const vector<z_cfg_t*> &cfgs) {
+  std::size_t n = 0;
+  for (auto cfg: cfgs)
+    for (auto &b: *cfg) n += b.size ();
+  return n;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  const unsigned num_funcs = 100;
+  const unsigned num_blocks = 50;
+  const unsigned stmts_per_block = 10;
+  const unsigned rounds = 3;
+  const string file = "cfg_load_bench.cfg";
+
+  // best time of several rounds
+  double construct_time = 0, load_time = 0;
+  crab::Stopwatch sw;
+
+  variable_factory_t vfac;
+  vector<z_cfg_t*> built;
+  for (unsigned i=0; i < rounds; i++) {
+    for (auto cfg: built) delete cfg;
+    built.clear ();
+    sw.start ();
+    for (unsigned f=0; f < num_funcs; f++)
+      built.push_back (make_function (vfac, f, num_blocks, stmts_per_block));
+    sw.stop ();
+    if (i == 0 || sw.toSeconds () < construct_time) construct_time = sw.toSeconds ();
+  }
+  crab::outs () << "construction: " << construct_time << "s ("
+                << num_stmts (built) << " statements)\n";
+
+  cfg_writer<z_cfg_t> w;
+  sw.start ();
+  for (auto cfg: built) w.add (*cfg);
+  bool res = w.save (file);
+  sw.stop ();
+  crab::outs () << "write:        " << sw << " (" << w.str ().size () << " bytes)\n";
+
+  // the variables are loaded into the same factory so that the
+  // loaded CFGs are printed exactly as the original ones
+  cfg_reader<z_cfg_t> r ([&vfac] (const string &s) { return vfac [s]; },
+                         [] (const string &s) { return s; });
+  vector<cfg_reader<z_cfg_t>::cfg_ptr> loaded;
+  for (unsigned i=0; i < rounds; i++) {
+    loaded.clear ();
+    sw.start ();
+    res &= r.load (file, loaded);
+    sw.stop ();
+    if (i == 0 || sw.toSeconds () < load_time) load_time = sw.toSeconds ();
+  }
+  crab::outs () << "load:         " << load_time << "s\n";
+
+  vector<z_cfg_t*> loaded_cfgs;
+  for (auto cfg: loaded) loaded_cfgs.push_back (cfg.get ());
+  res &= (loaded.size () == built.size () && num_stmts (loaded_cfgs) == num_stmts (built));
+  for (unsigned i=0; res && i < built.size (); i++) {
+    crab::crab_string_os s1, s2;
+    s1 << *built [i];
+    s2 << *loaded [i];
+    res &= (s1.str () == s2.str ());
+  }
+  if (!res) crab::outs () << "ERROR: the loaded CFGs differ from the original ones\n";
+
+  std::remove (file.c_str ());
+  for (auto cfg: built) delete cfg;
+  return res ? 0 : 1;
+}
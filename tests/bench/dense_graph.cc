@@ -0,0 +1,108 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <algorithm>
+#include <random>
+
+/*
+   Benchmark for the dense graph representation of SplitDBM.
+
+   It simulates the fixpoint of a loop over variables that are all
+   related: the loop body shifts the variables by constants and the
+   result is joined and widened with the loop head, then met with the
+   loop guard. It reports the time with the adaptive sparse graphs
+   and with the dense graphs, and checks that both compute the same
+   DBM.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+typedef SplitDBM<ikos::z_number, varname_t,
+                 SDBM_impl::DefaultParams<ikos::z_number, SDBM_impl::GraphRep::dense> >
+        dense_sdbm_t;
+typedef SplitDBM<ikos::z_number, varname_t,
+                 SDBM_impl::DefaultParams<ikos::z_number, SDBM_impl::GraphRep::hybrid> >
+        hybrid_sdbm_t;
+
+template<typename Dom>
+Dom make_dbm (const vector<z_var> &vars) {
+  Dom d;
+  for (unsigned i=0; i + 1 < vars.size (); i++) {
+    d += z_lin_cst_t (vars [i] - vars [i + 1] <= 1);
+    d += z_lin_cst_t (vars [i + 1] - vars [i] <= 2);
+  }
+  d += z_lin_cst_t (vars [0] >= 0);
+  d += z_lin_cst_t (vars [0] <= 100);
+  return d;
+}
+
+template<typename Dom>
+string to_string (Dom &d) {
+  vector<string> csts;
+  for (auto c: d.to_linear_constraint_system ()) {
+    crab::crab_string_os o;
+    o << c;
+    csts.push_back (o.str ());
+  }
+  sort (csts.begin (), csts.end ());
+  string res;
+  for (auto &c: csts) res += c + "; ";
+  return res;
+}
+
+template<typename Dom>
+double run (const vector<z_var> &vars, unsigned iters, string &res) {
+  Dom init = make_dbm<Dom> (vars);
+  crab::Stopwatch sw;
+  sw.start ();
+  Dom head;
+  for (unsigned k=0; k < iters; k++) {
+    mt19937 gen (k);
+    head = init;
+    for (unsigned it=0; it < 3; it++) {
+      Dom body = head;
+      body += z_lin_cst_t (vars [0] <= 1000);
+      for (unsigned s=0; s < vars.size (); s++) {
+        const z_var &x = vars [gen () % vars.size ()];
+        body.assign (x.name (), x + (int) (gen () % 3));
+      }
+      Dom next = head | body;
+      head = head || next;
+    }
+    head = head & init;
+  }
+  sw.stop ();
+  res = to_string (head);
+  return sw.toSeconds () * 1000;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+  crab::outs () << "variables\tadapt_ss (ms)\tdense (ms)\thybrid (ms)\n";
+  for (unsigned n = 8; n <= 64; n *= 2) {
+    vector<z_var> vars;
+    for (unsigned i=0; i < n; i++)
+      vars.push_back (z_var (vfac ["x" + std::to_string (i)]));
+    unsigned iters = 2000 / n;
+    string sparse_res, dense_res, hybrid_res;
+    double sparse = run<z_sdbm_domain_t> (vars, iters, sparse_res);
+    double dense = run<dense_sdbm_t> (vars, iters, dense_res);
+    double hybrid = run<hybrid_sdbm_t> (vars, iters, hybrid_res);
+    crab::outs () << n << "\t\t" << (long) sparse << "\t\t" << (long) dense
+                  << "\t\t" << (long) hybrid << "\n";
+    if (sparse_res != dense_res) {
+      crab::outs () << "ERROR: the dense graphs computed a different DBM\n";
+      ok = false;
+    }
+    if (sparse_res != hybrid_res) {
+      crab::outs () << "ERROR: the hybrid graphs computed a different DBM\n";
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <crab/analysis/liveness.hpp>
+
+/*
+   Benchmark for the liveness analysis.
+
+   It reports the time of the liveness analysis on CFGs made of
+   nested loops over an increasing number of variables. Each block
+   only defines and uses a few variables but many of them are live
+   across the loops.
+*/
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::analyzer;
+
+// A chain of loops: block b jumps back to block b - 8 every 8 blocks
+z_cfg_t* make_cfg (variable_factory_t &vfac, unsigned num_blocks, unsigned num_vars) {
+  z_cfg_t* cfg = new z_cfg_t("b0", "b" + to_string (num_blocks - 1));
+  vector<z_var> vars;
+  for (unsigned i=0; i < num_vars; i++)
+    vars.push_back (z_var (vfac ["v" + to_string (i)]));
+
+  vector<z_basic_block_t*> blocks;
+  for (unsigned b=0; b < num_blocks; b++) {
+    z_basic_block_t& bb = cfg->insert ("b" + to_string (b));
+    blocks.push_back (&bb);
+    for (unsigned s=0; s < 4; s++) {
+      z_var &lhs = vars [(b * 7 + s) % num_vars];
+      z_var &op = vars [(b * 13 + s * 5 + 1) % num_vars];
+      bb.add (lhs, op, 1);
+    }
+    if (b > 0) *blocks [b - 1] >> bb;
+    if (b >= 8 && b % 8 == 0) bb >> *blocks [b - 8];
+  }
+  // all the variables are used at the exit
+  for (unsigned i=0; i + 1 < num_vars; i += 2)
+    blocks.back ()->add (vars [i], vars [i], vars [i + 1]);
+  return cfg;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  crab::Stopwatch sw;
+  crab::outs () << "blocks\tvariables\tliveness (ms)\tavg live vars\n";
+  for (unsigned n = 500; n <= 8000; n *= 2) {
+    unsigned num_vars = n / 2;
+    z_cfg_t* cfg = make_cfg (vfac, n, num_vars);
+    z_cfg_ref_t cfg_ref (*cfg);
+    sw.start ();
+    liveness<z_cfg_ref_t> live (cfg_ref);
+    live.exec ();
+    sw.stop ();
+    unsigned total, max, avg;
+    live.get_stats (total, max, avg);
+    crab::outs () << n << "\t" << num_vars << "\t\t"
+                  << (long) (sw.toSeconds () * 1000) << "\t\t" << avg << "\n";
+    delete cfg;
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <crab/analysis/fwd_analyzer.hpp>
+
+/*
+   Benchmark for the packing domain.
+
+   The CFG is a sequence of loops, each one over its own group of
+   variables, so SplitDBM keeps all the variables in one graph while
+   the packing domain keeps one small SplitDBM per loop. It reports
+   the time of the analysis with both domains and checks that they
+   compute the same intervals at the exit.
+*/
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+// for (i=0, x=y; i < n; i++, x++) { } for each group of variables
+z_cfg_t* make_cfg (variable_factory_t &vfac, unsigned num_loops,
+                   vector<varname_t> &vars) {
+  z_cfg_t* cfg = new z_cfg_t ("b0", "exit");
+  z_basic_block_t* prev = &cfg->insert ("b0");
+  for (unsigned l=0; l < num_loops; l++) {
+    string s = to_string (l);
+    z_var i (vfac ["i" + s]), n (vfac ["n" + s]), x (vfac ["x" + s]), y (vfac ["y" + s]);
+    vars.insert (vars.end (), { i.name (), n.name (), x.name (), y.name () });
+    z_basic_block_t& head = cfg->insert ("head" + s);
+    z_basic_block_t& body = cfg->insert ("body" + s);
+    z_basic_block_t& out  = cfg->insert ("out" + s);
+    prev->assign (i, 0);
+    prev->assign (x, y);
+    prev->assume (y >= 0);
+    prev->assume (n <= 100);
+    *prev >> head;
+    head >> body; body >> head; head >> out;
+    body.assume (i <= n - 1);
+    body.add (i, i, 1);
+    body.add (x, x, 1);
+    out.assume (i >= n);
+    prev = &out;
+  }
+  z_basic_block_t& exit = cfg->insert ("exit");
+  *prev >> exit;
+  return cfg;
+}
+
+template<typename Dom>
+double run (z_cfg_t* cfg, const vector<varname_t> &vars, vector<z_interval_t> &res) {
+  crab::Stopwatch sw;
+  sw.start ();
+  intra_fwd_analyzer<z_cfg_ref_t, Dom> a (*cfg, Dom::top ());
+  a.run ();
+  sw.stop ();
+  auto inv = a [cfg->exit ()];
+  for (auto v: vars)
+    res.push_back (inv [v]);
+  return sw.toSeconds () * 1000;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+  crab::outs () << "loops\tvariables\tSplitDBM (ms)\tpacking (ms)\n";
+  for (unsigned n = 8; n <= 64; n *= 2) {
+    vector<varname_t> vars;
+    z_cfg_t* cfg = make_cfg (vfac, n, vars);
+    vector<z_interval_t> res, pack_res;
+    double sdbm = run<z_sdbm_domain_t> (cfg, vars, res);
+    double pack = run<z_pack_sdbm_domain_t> (cfg, vars, pack_res);
+    crab::outs () << n << "\t" << vars.size () << "\t\t" << (long) sdbm << "\t\t"
+                  << (long) pack << "\n";
+    for (unsigned k=0; k < vars.size (); k++) {
+      if (!(res [k] == pack_res [k])) {
+        crab::outs () << "ERROR: different intervals for " << vars [k] << "\n";
+        ok = false;
+      }
+    }
+    delete cfg;
+  }
+  return ok ? 0 : 1;
+}
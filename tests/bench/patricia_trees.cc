@@ -0,0 +1,90 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <crab/domains/patricia_trees.hpp>
+#include <algorithm>
+#include <random>
+
+/*
+   Benchmark for the hash-consing of patricia trees.
+
+   Two sets of variables with the same elements are built
+   independently, inserting the elements in different orders, as
+   the live variables computed at two program points are. It reports
+   the time per union, inclusion and equality with and without
+   hash-consing and checks that both agree.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace ikos;
+
+typedef patricia_tree_set<varname_t> set_t;
+
+struct result {
+  double join, leq, eq;
+  unsigned acc;
+};
+
+set_t make_set (const vector<varname_t> &vars, unsigned n, unsigned seed) {
+  vector<unsigned> order (n);
+  for (unsigned i=0; i < n; i++) order [i] = i;
+  shuffle (order.begin (), order.end (), mt19937 (seed));
+  set_t s;
+  for (unsigned i: order) s += vars [i];
+  return s;
+}
+
+result bench (const vector<varname_t> &vars, unsigned n, unsigned iters) {
+  set_t a = make_set (vars, n, 1);
+  set_t b = make_set (vars, n, 2);
+  crab::Stopwatch sw;
+  result r;
+  r.acc = 0;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) r.acc += (a | b).size ();
+  sw.stop ();
+  r.join = sw.toSeconds () * 1e9 / iters;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) r.acc += (a <= b);
+  sw.stop ();
+  r.leq = sw.toSeconds () * 1e9 / iters;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) r.acc += (a == b);
+  sw.stop ();
+  r.eq = sw.toSeconds () * 1e9 / iters;
+  return r;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<varname_t> vars;
+  for (unsigned i=0; i < 1024; i++)
+    vars.push_back (vfac ["v" + std::to_string (i)]);
+
+  bool res = true;
+  crab::outs () << "ns/op      union (plain/hash-consed)   "
+                << "subset (plain/hash-consed)   equal (plain/hash-consed)\n";
+  for (unsigned n = 4; n <= 1024; n *= 4) {
+    unsigned iters = std::max (1000000 / n, 1000u);
+    patricia_tree_hash_consing (false);
+    result p = bench (vars, n, iters);
+    patricia_tree_hash_consing (true);
+    result h = bench (vars, n, iters);
+    crab::outs () << "n=" << n << "\t"
+                  << (long) p.join << "/" << (long) h.join << "\t\t\t"
+                  << (long) p.leq << "/" << (long) h.leq << "\t\t\t"
+                  << (long) p.eq << "/" << (long) h.eq << "\n";
+    if (p.acc != h.acc) {
+      crab::outs () << "ERROR: results differ with hash-consing\n";
+      res = false;
+    }
+  }
+  patricia_tree_hash_consing (false);
+  return res ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <crab/domains/flat_maps.hpp>
+#include <crab/domains/separate_domains.hpp>
+
+/*
+   Benchmark for the environments of separate_domain.
+
+   For environments of increasing size it reports the time per
+   operation of patricia trees and flat maps on the operations that
+   dominate a fixpoint with the interval domain: updating a variable
+   of a copy (transfer functions), join, inclusion and meet. The
+   environments compared differ only in a few variables, as the
+   invariants of consecutive iterations do.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace ikos;
+
+typedef interval<z_number> interval_t;
+typedef separate_domain<varname_t, interval_t,
+                        patricia_tree<varname_t, interval_t> > tree_env_t;
+typedef separate_domain<varname_t, interval_t,
+                        flat_map<varname_t, interval_t> > flat_env_t;
+
+struct result {
+  double set, join, leq, meet;
+};
+
+template<typename Env>
+result bench (const vector<varname_t> &vars, unsigned n, unsigned iters) {
+  Env a;
+  for (unsigned i=0; i < n; i++)
+    a.set (vars [i], interval_t (z_number (0), z_number (i)));
+  // b is obtained from a by updating a few variables
+  Env b (a);
+  for (unsigned i=0; i < n; i += 8)
+    b.set (vars [i], interval_t (z_number (0), z_number (i + 1)));
+  crab::Stopwatch sw;
+  result r;
+  unsigned acc = 0;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) {
+    Env c (a);
+    c.set (vars [k % n], interval_t (z_number (1), z_number (k)));
+    acc += c.is_top ();
+  }
+  sw.stop ();
+  r.set = sw.toSeconds () * 1e9 / iters;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) acc += (a | b).is_top ();
+  sw.stop ();
+  r.join = sw.toSeconds () * 1e9 / iters;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) acc += (a <= b);
+  sw.stop ();
+  r.leq = sw.toSeconds () * 1e9 / iters;
+
+  sw.start ();
+  for (unsigned k=0; k < iters; k++) acc += (a & b).is_bottom ();
+  sw.stop ();
+  r.meet = sw.toSeconds () * 1e9 / iters;
+
+  if (acc == (unsigned) -1) crab::outs () << "";
+  return r;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<varname_t> vars;
+  for (unsigned i=0; i < 512; i++)
+    vars.push_back (vfac ["v" + std::to_string (i)]);
+
+  crab::outs () << "ns/op      set (tree/flat)   join (tree/flat)   "
+                << "leq (tree/flat)   meet (tree/flat)\n";
+  unsigned crossover = 0;
+  for (unsigned n = 2; n <= 512; n *= 2) {
+    unsigned iters = std::max (2000000 / n, 2000u);
+    result t = bench<tree_env_t> (vars, n, iters);
+    result f = bench<flat_env_t> (vars, n, iters);
+    crab::outs () << "n=" << n << "\t"
+                  << (long) t.set << "/" << (long) f.set << "\t\t"
+                  << (long) t.join << "/" << (long) f.join << "\t\t"
+                  << (long) t.leq << "/" << (long) f.leq << "\t\t"
+                  << (long) t.meet << "/" << (long) f.meet << "\n";
+    if (!crossover && t.set + t.join + t.leq + t.meet < f.set + f.join + f.leq + f.meet)
+      crossover = n;
+  }
+  if (crossover)
+    crab::outs () << "patricia trees are faster from " << crossover << " variables\n";
+  else
+    crab::outs () << "flat maps are faster for all sizes\n";
+  return 0;
+}
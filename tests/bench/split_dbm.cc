@@ -0,0 +1,92 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <random>
+
+/*
+   Benchmark for the closure of SplitDBM after assignments.
+
+   A straight-line block assigns many temporaries from the variables
+   of a DBM, overwriting the temporaries several times, and then
+   forgets them as if they were dead at the end of the block. The
+   result is joined with the initial state. It reports the time with
+   the closure after each assignment and with the closure deferred
+   until it is needed, and checks that both compute the same DBM.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+template<typename Number>
+class EagerParams: public SDBM_impl::DefaultParams<Number> {
+ public:
+  enum { lazy_closure = 0 };
+};
+
+typedef SplitDBM<ikos::z_number, varname_t, EagerParams<ikos::z_number> > eager_sdbm_t;
+
+template<typename Dom>
+Dom make_dbm (const vector<z_var> &vars) {
+  Dom d;
+  for (unsigned i=0; i + 1 < vars.size (); i++) {
+    d += z_lin_cst_t (vars [i] - vars [i + 1] <= 1);
+    d += z_lin_cst_t (vars [i + 1] - vars [i] <= 2);
+  }
+  d += z_lin_cst_t (vars [0] >= 0);
+  d += z_lin_cst_t (vars [0] <= 100);
+  return d;
+}
+
+template<typename Dom>
+double run (const vector<z_var> &vars, const vector<z_var> &temps,
+            unsigned stmts, unsigned iters, string &res) {
+  Dom init = make_dbm<Dom> (vars);
+  crab::Stopwatch sw;
+  sw.start ();
+  Dom d;
+  for (unsigned k=0; k < iters; k++) {
+    mt19937 gen (k);
+    d = init;
+    for (unsigned s=0; s < stmts; s++) {
+      const z_var &t = temps [gen () % temps.size ()];
+      const z_var &x = vars [gen () % vars.size ()];
+      d.assign (t.name (), x + (int) s);
+    }
+    for (auto &t: temps)
+      d -= t.name ();
+    d = d | init;
+  }
+  sw.stop ();
+  crab::crab_string_os o;
+  auto csts = d.to_linear_constraint_system ();
+  o << csts;
+  res = o.str ();
+  return sw.toSeconds () * 1000;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+  crab::outs () << "variables\tassignments\teager (ms)\tlazy (ms)\n";
+  for (unsigned n = 16; n <= 128; n *= 2) {
+    vector<z_var> vars, temps;
+    for (unsigned i=0; i < n; i++)
+      vars.push_back (z_var (vfac ["x" + std::to_string (i)]));
+    for (unsigned i=0; i < 8; i++)
+      temps.push_back (z_var (vfac ["t" + std::to_string (i)]));
+    unsigned stmts = 64, iters = 200;
+    string eager_res, lazy_res;
+    double eager = run<eager_sdbm_t> (vars, temps, stmts, iters, eager_res);
+    double lazy = run<z_sdbm_domain_t> (vars, temps, stmts, iters, lazy_res);
+    crab::outs () << n << "\t\t" << stmts << "\t\t" << (long) eager << "\t\t"
+                  << (long) lazy << "\n";
+    if (eager_res != lazy_res) {
+      crab::outs () << "ERROR: the lazy closure computed a different DBM\n";
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
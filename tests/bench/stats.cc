@@ -0,0 +1,79 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <thread>
+
+/*
+   Benchmark for the statistics of the abstract domains.
+
+   It reports the cost of counting and timing an operation through
+   string names and through interned names, and the cost of copying
+   and joining intervals, which are counted and timed on every call.
+   It also checks that the counters updated by several threads are
+   merged correctly.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+static std::string name () { return "Bench"; }
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  const unsigned n = 1000000;
+  crab::Stopwatch sw;
+
+  sw.start ();
+  for (unsigned i=0; i < n; i++) {
+    crab::CrabStats::count (name () + ".count.string");
+    crab::ScopedCrabStats __st__(name () + ".string");
+  }
+  sw.stop ();
+  crab::outs () << "string names:   " << sw << "\n";
+
+  sw.start ();
+  for (unsigned i=0; i < n; i++) {
+    CRAB_STATS_COUNT (name () + ".count.interned");
+    CRAB_STATS_SCOPE (name () + ".interned");
+  }
+  sw.stop ();
+  crab::outs () << "interned names: " << sw << "\n";
+
+  variable_factory_t vfac;
+  varname_t x = vfac ["x"];
+  varname_t y = vfac ["y"];
+  z_interval_domain_t inv1, inv2;
+  inv1.assign (x, 1);
+  inv2.assign (x, 2);
+  inv2.assign (y, 5);
+  sw.start ();
+  for (unsigned i=0; i < n; i++) {
+    z_interval_domain_t inv3 (inv1);
+    inv3 |= inv2;
+  }
+  sw.stop ();
+  crab::outs () << "intervals copy+join: " << sw << "\n";
+
+  // counters updated concurrently are merged when they are read
+  const unsigned num_threads = 4;
+  vector<thread> threads;
+  for (unsigned t=0; t < num_threads; t++)
+    threads.push_back (thread ([] () {
+          for (unsigned i=0; i < 100000; i++)
+            CRAB_STATS_COUNT ("Bench.count.threads");
+        }));
+  for (auto &t: threads) t.join ();
+
+  bool res = true;
+#ifdef HAVE_STATS
+  res &= (crab::CrabStats::get ("Bench.count.string") == n);
+  res &= (crab::CrabStats::get ("Bench.count.interned") == n);
+  res &= (crab::CrabStats::get ("Bench.count.threads") == num_threads * 100000);
+  res &= (crab::CrabStats::get (z_interval_domain_t::getDomainName () + ".count.copy") >= n);
+#endif
+  if (!res) crab::outs () << "ERROR: unexpected counter values\n";
+  if (stats_enabled) crab::CrabStats::Print (crab::outs ());
+  return res ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/cfg/cfg_binary.hpp>
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::cg_impl;
+
+/* Write CFGs in binary format, load them back with a fresh variable
+   factory and check that they are printed in the same way. */
+
+z_cfg_t* callee (variable_factory_t &vfac) {
+  vector<pair<varname_t,crab::variable_type> > params;
+  params.push_back (make_pair (vfac["x"], crab::INT_TYPE));
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["foo"], params);
+  z_var x (vfac ["x"]);
+  z_var y (vfac ["y"]);
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit = cfg->insert ("exit");
+  entry >> exit;
+  entry.add (y, x, 1);
+  exit.ret (vfac ["y"], crab::INT_TYPE);
+  return cfg;
+}
+
+z_cfg_t* caller (variable_factory_t &vfac) {
+  vector<pair<varname_t,crab::variable_type> > params;
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["main"], params);
+  z_var i (vfac ["i"]);
+  z_var n (vfac ["n"]);
+  z_var r (vfac ["r"]);
+  varname_t a = vfac ["A"];
+  varname_t b = vfac ["B"];
+  varname_t v = vfac ["v"];
+  varname_t p = vfac ["p"];
+  varname_t q = vfac ["q"];
+  varname_t b1 = vfac ["b1"];
+  varname_t b2 = vfac ["b2"];
+  varname_t b3 = vfac ["b3"];
+  typedef crab::pointer_constraint<varname_t> ptr_cst_t;
+
+  z_cfg_t* cfg = new z_cfg_t("entry", "ret", decl, ARR);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& loop = cfg->insert ("loop");
+  z_basic_block_t& body = cfg->insert ("body");
+  z_basic_block_t& out = cfg->insert ("out");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  entry >> loop; loop >> body; body >> loop; loop >> out; out >> ret;
+
+  entry.assign (i, 0);
+  entry.havoc (n.name ());
+  entry.assume (n <= ikos::z_number ("100000000000000000000"));
+  entry.array_assume (a, crab::ARR_INT_TYPE, 0, n - 1, v);
+  entry.array_assign (b, a, crab::ARR_INT_TYPE);
+  entry.ptr_new_object (p, 7);
+  entry.ptr_null (q);
+  entry.bool_assign (b1, i <= n);
+  entry.bool_assign (b2, b1);
+  body.bool_assume (b1);
+  body.array_load (v, a, crab::ARR_INT_TYPE, i, 4);
+  body.array_store (b, crab::ARR_INT_TYPE, i, v, 4, true);
+  body.mul (r, i, 3);
+  body.select (r, i, r, n);
+  body.add (i, i, 1);
+  body.ptr_assign (q, p, i * 4);
+  body.ptr_load (v, p);
+  body.ptr_store (p, v);
+  out.bool_not_assume (b1);
+  out.bool_and (b3, b1, b2);
+  out.bool_select (b3, b1, b2, b3);
+  out.ptr_assume (ptr_cst_t::mk_diseq_null (p));
+  out.ptr_assume (ptr_cst_t::mk_eq (p, q));
+  out.ptr_assertion (ptr_cst_t::mk_diseq (p, q), crab::cfg::debug_info ("main.c", 12, 3));
+  out.assertion (i >= n, crab::cfg::debug_info ("main.c", 14, 5));
+  out.bool_assert (b3);
+  vector<pair<varname_t,crab::variable_type> > args;
+  args.push_back (make_pair (vfac["i"], crab::INT_TYPE));
+  out.callsite (make_pair (vfac["r"], crab::INT_TYPE), vfac ["foo"], args);
+  ret.ret (vfac["r"], crab::INT_TYPE);
+  return cfg;
+}
+
+q_cfg_t* rationals (variable_factory_t &vfac) {
+  q_var x (vfac ["x"]);
+  q_var y (vfac ["y"]);
+  q_cfg_t* cfg = new q_cfg_t("entry");
+  q_basic_block_t& entry = cfg->insert ("entry");
+  entry.assign (x, ikos::q_number (1, 3));
+  entry.add (y, x, ikos::q_number ("-7/2"));
+  entry.assume (y <= ikos::q_number ("123456789012345678901234567890/7"));
+  return cfg;
+}
+
+template<typename CFG>
+string to_str (CFG &cfg) {
+  crab::crab_string_os os;
+  os << cfg;
+  if (auto decl = cfg.get_func_decl ())
+    os << *decl << "\n";
+  for (auto &b: cfg)
+    for (auto &s: b)
+      if (s.get_debug_info ().has_debug ())
+        os << s << "\n" << s.get_debug_info ();
+  return os.str ();
+}
+
+template<typename CFG>
+bool check (vector<CFG*> cfgs, const string &file) {
+  typedef cfg_reader<CFG> reader_t;
+  cfg_writer<CFG> w;
+  for (auto cfg: cfgs) w.add (*cfg);
+  if (!w.save (file)) return false;
+
+  variable_factory_t vfac;
+  reader_t r ([&vfac] (const string &s) { return vfac [s]; },
+              [] (const string &s) { return s; });
+  vector<typename reader_t::cfg_ptr> loaded;
+  bool res = r.load (file, loaded) && loaded.size () == cfgs.size ();
+  for (unsigned i=0; res && i < cfgs.size (); i++) {
+    string s1 = to_str (*cfgs [i]);
+    string s2 = to_str (*loaded [i]);
+    crab::outs () << s2 << "\n";
+    if (s1 != s2) {
+      crab::outs () << "ERROR: expected\n" << s1 << "\n";
+      res = false;
+    }
+  }
+
+  // a truncated input must be rejected
+  string buf = w.str ();
+  vector<typename reader_t::cfg_ptr> tmp;
+  if (r.read (buf.data (), buf.data () + buf.size () / 2, tmp) || !tmp.empty ()) {
+    crab::outs () << "ERROR: truncated input was accepted\n";
+    res = false;
+  }
+  std::remove (file.c_str ());
+  return res;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* t1 = callee (vfac);
+  z_cfg_t* t2 = caller (vfac);
+  q_cfg_t* t3 = rationals (vfac);
+
+  bool res = true;
+  res &= check<z_cfg_t> ({ t1, t2 }, "cfg_binary_z.cfg");
+  res &= check<q_cfg_t> ({ t3 }, "cfg_binary_q.cfg");
+
+  // all the functions of a call graph
+  vector<z_cfg_ref_t> cfgs = { *t1, *t2 };
+  z_cg_t cg (cfgs);
+  cfg_writer<z_cfg_t> w;
+  w.add_call_graph (cg);
+  variable_factory_t vfac2;
+  cfg_reader<z_cfg_t> r ([&vfac2] (const string &s) { return vfac2 [s]; },
+                         [] (const string &s) { return s; });
+  string buf = w.str ();
+  vector<cfg_reader<z_cfg_t>::cfg_ptr> loaded;
+  res &= r.read (buf.data (), buf.data () + buf.size (), loaded);
+  vector<z_cfg_ref_t> loaded_refs;
+  for (auto cfg: loaded) loaded_refs.push_back (*cfg);
+  z_cg_t loaded_cg (loaded_refs);
+  crab::outs () << "Call graph with " << loaded_cg.num_nodes () << " functions\n";
+  res &= (loaded_cg.num_nodes () == cg.num_nodes ());
+
+  delete t1;
+  delete t2;
+  delete t3;
+  return res ? 0 : 1;
+}
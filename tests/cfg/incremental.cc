@@ -0,0 +1,100 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+
+  // Defining program variables
+  z_var i (vfac ["i"]);
+  z_var k (vfac ["k"]);
+  z_var nd (vfac ["nd"]);
+  z_var inc (vfac ["inc"]);
+  // entry and exit block
+  auto cfg = new z_cfg_t("x0","ret");
+  // adding blocks
+  z_basic_block_t& x0 = cfg->insert ("x0");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& bb2   = cfg->insert ("bb2");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  // adding control flow
+  x0 >> entry; entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f;
+  bb1_t >> bb2; bb2 >> bb1; bb1_f >> ret;
+  // adding statements
+  x0.assign (k, 0);
+  entry.assign (i, 0);
+  bb1_t.assume (i <= 99);
+  bb1_f.assume (i >= 100);
+  bb2.havoc(nd.name());
+  bb2.select(inc,nd,1,2);
+  bb2.add(i, i, inc);
+
+  return cfg;
+}
+
+// Modify the CFG and return the modified blocks
+vector<string> edit (z_cfg_t* cfg, variable_factory_t &vfac) {
+  z_var i (vfac ["i"]);
+  z_var k (vfac ["k"]);
+  // change the loop body
+  z_basic_block_t& bb2 = cfg->get_node ("bb2");
+  bb2.add(k, k, 1);
+  // insert a new block before the exit
+  z_basic_block_t& bb1_f = cfg->get_node ("bb1_f");
+  z_basic_block_t& ret = cfg->get_node ("ret");
+  z_basic_block_t& bb3 = cfg->insert ("bb3");
+  bb1_f -= ret;
+  bb1_f >> bb3; bb3 >> ret;
+  bb3.assign (i, k);
+  return { "bb2", "bb1_f", "bb3", "ret" };
+}
+
+// Compare the invariants of the incremental analysis with the ones
+// of an analysis from scratch.
+template<typename Dom>
+bool check (variable_factory_t &vfac) {
+  typedef intra_fwd_analyzer<z_cfg_ref_t, Dom> analyzer_t;
+
+  z_cfg_t* cfg = prog (vfac);
+  analyzer_t a (*cfg, Dom::top ());
+  a.run ();
+  a.rerun (edit (cfg, vfac));
+  crab::outs() << *cfg << "\n";
+
+  analyzer_t b (*cfg, Dom::top ());
+  b.run ();
+
+  bool res = true;
+  crab::outs() << "Invariants using " << Dom::getDomainName () << "\n";
+  for (auto &bb : *cfg) {
+    Dom inv1 = a[bb.label ()];
+    Dom inv2 = b[bb.label ()];
+    crab::outs() << bb.label () << "=" << inv1 << "\n";
+    if (!(inv1 <= inv2 && inv2 <= inv1)) {
+      crab::outs() << "ERROR: expected " << inv2 << "\n";
+      res = false;
+    }
+  }
+  crab::outs() << "Abstract trace: " << a.get_wto () << "\n";
+  delete cfg;
+  return res;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool res = true;
+  res &= check<z_interval_domain_t> (vfac);
+  res &= check<z_sdbm_domain_t> (vfac);
+  return res ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <thread>
+
+using namespace std;
+using namespace crab::cfg_impl;
+
+/* Variable names are handles to the names stored in the factory.
+   Check that they are resolved when printed, that the same name
+   always gives the same handle, also when the names are requested by
+   several threads, and that shadow variables get their own names. */
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  bool res = true;
+  variable_factory_t vfac;
+  varname_t x = vfac ["x"];
+  varname_t y = vfac ["y"];
+  varname_t x2 = vfac ["x"];
+  if (!(x == x2) || x == y || x.str () != "x" || y.str () != "y" ||
+      !x.get () || *(x.get ()) != "x") {
+    crab::outs () << "ERROR: wrong names\n";
+    res = false;
+  }
+  if (sizeof (varname_t) > 2 * sizeof (void*)) {
+    crab::outs () << "ERROR: the names are not handles\n";
+    res = false;
+  }
+
+  varname_t s1 = vfac.get ();
+  varname_t s2 = vfac.get (42);
+  varname_t s3 = vfac.get (42);
+  if (s1 == s2 || !(s2 == s3) || s1.get () ||
+      s1.str () != "@V_" + std::to_string (s1.index ())) {
+    crab::outs () << "ERROR: wrong shadow variables\n";
+    res = false;
+  }
+
+  // several threads request the same names
+  const unsigned n = 1000;
+  vector<vector<varname_t> > names (4);
+  vector<thread> threads;
+  for (unsigned t=0; t < names.size (); t++) {
+    threads.push_back (thread ([&vfac, &names, t, n] () {
+      for (unsigned i=0; i < n; i++)
+        names [t].push_back (vfac ["v" + std::to_string ((i * (t + 1)) % n)]);
+    }));
+  }
+  for (auto &t: threads) t.join ();
+  for (unsigned t=0; t < names.size (); t++) {
+    for (unsigned i=0; i < n; i++) {
+      varname_t v = names [t][i];
+      if (!(v == vfac ["v" + std::to_string ((i * (t + 1)) % n)]) ||
+          v.str () != "v" + std::to_string ((i * (t + 1)) % n)) {
+        crab::outs () << "ERROR: wrong name for " << v << "\n";
+        res = false;
+      }
+    }
+  }
+
+  crab::outs () << x << " " << y << " " << (res ? "OK" : "FAILED") << "\n";
+  return res ? 0 : 1;
+}
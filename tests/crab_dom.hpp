@@ -16,6 +16,7 @@
 #include <crab/domains/nullity.hpp>
 #include <crab/domains/flat_boolean_domain.hpp>                      
 #include <crab/domains/combined_domains.hpp>                      
+#include <crab/domains/var_packing.hpp>
 
 namespace crab {
 
@@ -47,6 +48,7 @@ namespace crab {
     typedef term_domain<term::TDomInfo<ikos::z_number,varname_t,z_sdbm_domain_t> > z_term_dbm_t;
     typedef term_domain<term::TDomInfo<ikos::z_number,varname_t,z_dis_interval_domain_t> > z_term_dis_int_t;
     typedef reduced_numerical_domain_product2<z_term_dis_int_t,z_sdbm_domain_t> z_num_domain_t;
+    typedef var_packing_domain<z_sdbm_domain_t> z_pack_sdbm_domain_t;
     // Pointer domains over integers
     typedef nullity_domain<ikos::z_number, varname_t> z_nullity_domain_t;
     // Numerical x pointer domains over integers
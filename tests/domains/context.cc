@@ -0,0 +1,101 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+#include <crab/common/analysis_context.hpp>
+#include <thread>
+
+/*
+   Independent analyses running concurrently, each one with its own
+   analysis context, must produce the same invariants as when they
+   run sequentially.
+
+   The array graph domain keeps the landmarks of the analyzed CFG in
+   the context and the term domain its variable factory.
+*/
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+// forall 0 <= i < n. a[i] = v
+z_cfg_t* prog (variable_factory_t &vfac, int n, int v) {
+  z_var i (vfac ["i"]);
+  z_var k (vfac ["k"]);
+  z_var val (vfac ["val"]);
+  z_var last (vfac ["last"]);
+  varname_t a = vfac ["A"];
+  varname_t tmp = vfac ["tmp"];
+
+  z_cfg_t* cfg = new z_cfg_t ("entry","ret",ARR);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& bb2   = cfg->insert ("bb2");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f;
+  bb1_t >> bb2; bb2 >> bb1; bb1_f >> ret;
+  entry.assign (i, 0);
+  entry.assign (k, n);
+  bb1_t.assume (i <= n - 1);
+  bb1_f.assume (i >= n);
+  bb2.assign (val, v);
+  bb2.array_store (a, crab::ARR_INT_TYPE, i, val.name (), 1);
+  bb2.add (i, i, 1);
+  ret.sub (last, k, 1);
+  ret.array_load (tmp, a, crab::ARR_INT_TYPE, last, 1);
+  return cfg;
+}
+
+template<typename Dom>
+string analyze (int n) {
+  crab::analysis_context ctx;
+  crab::analysis_context::scope s (ctx);
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac, n, 100 + n);
+  intra_fwd_analyzer<z_cfg_ref_t, Dom> a (*cfg, Dom::top ());
+  a.run ();
+  crab::crab_string_os o;
+  for (auto &b : *cfg) {
+    auto inv = a [b.label ()];
+    o << get_label_str (b.label ()) << "=" << inv << "\n";
+  }
+  delete cfg;
+  return o.str ();
+}
+
+template<typename Dom>
+bool check (unsigned num_progs) {
+  vector<string> seq (num_progs), par (num_progs);
+  for (unsigned i=0; i < num_progs; i++)
+    seq [i] = analyze<Dom> (i + 2);
+
+  vector<thread> threads;
+  for (unsigned i=0; i < num_progs; i++)
+    threads.push_back (thread ([&par, i] () { par [i] = analyze<Dom> (i + 2); }));
+  for (auto &t: threads) t.join ();
+
+  bool res = true;
+  for (unsigned i=0; i < num_progs; i++) {
+    if (seq [i] != par [i]) {
+      crab::outs () << "ERROR: " << Dom::getDomainName ()
+                    << " differs on program " << i << "\n";
+      res = false;
+    }
+  }
+  crab::outs () << "Invariants using " << Dom::getDomainName () << "\n"
+                << seq [0] << "\n";
+  return res;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  bool res = true;
+  res &= check<z_ag_sdbm_intv_t> (8);
+  res &= check<z_term_domain_t> (8);
+  return res ? 0 : 1;
+}
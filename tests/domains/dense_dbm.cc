@@ -0,0 +1,182 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <algorithm>
+#include <random>
+
+/*
+   SplitDBM must compute the same invariants with the dense and the
+   adaptive sparse graph representations.
+
+   Random blocks of assignments, forgets and constraints are applied
+   to both DBMs. Each block is then met, joined or widened with the
+   state of the previous block and the constraints of both DBMs are
+   compared up to their order.
+
+   The row kernels of the dense graphs are also compared with their
+   scalar versions on rows with missing edges and weights close to
+   overflowing.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+typedef SplitDBM<ikos::z_number, varname_t,
+                 SDBM_impl::DefaultParams<ikos::z_number, SDBM_impl::GraphRep::dense> >
+        dense_sdbm_t;
+
+// The constraints of d, sorted since the order of the edges of the
+// DBMs may differ
+template<typename Dom>
+string to_string (Dom &d) {
+  vector<string> csts;
+  for (auto c: d.to_linear_constraint_system ()) {
+    crab::crab_string_os o;
+    o << c;
+    csts.push_back (o.str ());
+  }
+  sort (csts.begin (), csts.end ());
+  string res;
+  for (auto &c: csts) res += c + "; ";
+  return res;
+}
+
+// Compare the row kernels with the scalar ones
+unsigned check_row_ops () {
+  typedef crab::DenseRowOps<long> ops_t;
+  typedef crab::DenseRowScalarOps<long> scalar_ops_t;
+  const long inf = ops_t::infty ();
+  const long big = numeric_limits<long>::max () / 2;
+  mt19937 gen (3);
+  auto rnd_wt = [&gen, inf, big] () {
+    switch (gen () % 5) {
+      case 0: return inf;
+      case 1: return big + (long) (gen () % 5);
+      case 2: return -big - (long) (gen () % 5);
+      default: return (long) (gen () % 21) - 10;
+    }
+  };
+  unsigned errors = 0;
+  for (unsigned k=0; k < 1000; k++) {
+    size_t n = gen () % 19;
+    vector<long> a (n), b (n), r1 (n), r2 (n);
+    for (size_t i=0; i < n; i++) { a [i] = rnd_wt (); b [i] = rnd_wt (); }
+    ops_t::join (r1.data (), a.data (), b.data (), n);
+    scalar_ops_t::join (r2.data (), a.data (), b.data (), n);
+    errors += (r1 != r2);
+    ops_t::meet (r1.data (), a.data (), b.data (), n);
+    scalar_ops_t::meet (r2.data (), a.data (), b.data (), n);
+    errors += (r1 != r2);
+    errors += (ops_t::widen (r1.data (), a.data (), b.data (), n) !=
+               scalar_ops_t::widen (r2.data (), a.data (), b.data (), n));
+    errors += (r1 != r2);
+    long w = rnd_wt ();
+    if (w == inf) w = 0;
+    r1 = a; r2 = a;
+    ops_t::relax (r1.data (), w, b.data (), n);
+    scalar_ops_t::relax (r2.data (), w, b.data (), n);
+    errors += (r1 != r2);
+    errors += (ops_t::min_plus (a.data (), b.data (), n) !=
+               scalar_ops_t::min_plus (a.data (), b.data (), n));
+    errors += (ops_t::count (a.data (), n) != scalar_ops_t::count (a.data (), n));
+  }
+  // the sums that overflow are ignored
+  long x [] = { big + 2, -big, 1 }, y [] = { big + 2, -big - 3, inf };
+  if (ops_t::min_plus (x, y, 3) != inf)
+    errors++;
+  long row [] = { 5, 5, 5 };
+  ops_t::relax (row, -big, y, 3);
+  if (row [0] != 2 || row [1] != 5 || row [2] != 5)
+    errors++;
+  if (errors > 0)
+    crab::outs () << "ERROR: the row kernels differ from the scalar ones\n";
+  return errors;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 12; i++)
+    vars.push_back (z_var (vfac ["x" + std::to_string (i)]));
+
+  mt19937 gen (11);
+  auto rnd = [&gen] (unsigned n) { return (unsigned) (gen () % n); };
+  auto cst = [&rnd] () { return ikos::z_number ((long) rnd (21) - 10); };
+
+  z_sdbm_domain_t sparse, sparse_prev;
+  dense_sdbm_t dense, dense_prev;
+  unsigned errors = check_row_ops ();
+  for (unsigned block=0; block < 300; block++) {
+    for (unsigned step=0; step < 15; step++) {
+      z_var &x = vars [rnd (vars.size ())];
+      z_var &y = vars [rnd (vars.size ())];
+      z_var &z = vars [rnd (vars.size ())];
+      ikos::z_number k = cst ();
+      switch (rnd (8)) {
+        case 0: case 1: case 2:
+          sparse.assign (x.name (), y + k);
+          dense.assign (x.name (), y + k);
+          break;
+        case 3:
+          sparse.assign (x.name (), y + z);
+          dense.assign (x.name (), y + z);
+          break;
+        case 4:
+          sparse -= x.name ();
+          dense -= x.name ();
+          break;
+        case 5: {
+          z_lin_cst_t c (x - y <= k + 5);
+          sparse += c;
+          dense += c;
+          break;
+        }
+        default: {
+          z_lin_cst_t c (x <= k + 20);
+          sparse += c;
+          dense += c;
+          z_lin_cst_t d (x >= k - 20);
+          sparse += d;
+          dense += d;
+          break;
+        }
+      }
+    }
+    switch (block % 4) {
+      case 0:
+        sparse = sparse | sparse_prev;
+        dense = dense | dense_prev;
+        break;
+      case 1:
+        sparse = sparse_prev || sparse;
+        dense = dense_prev || dense;
+        break;
+      case 2:
+        sparse = sparse & sparse_prev;
+        dense = dense & dense_prev;
+        break;
+      default:
+        break;
+    }
+    if (to_string (sparse) != to_string (dense)) {
+      crab::outs () << "ERROR: different constraints in block " << block << "\n"
+                    << "sparse: " << to_string (sparse) << "\n"
+                    << "dense: " << to_string (dense) << "\n";
+      errors++;
+    }
+    if (sparse.is_bottom () != dense.is_bottom ()) {
+      crab::outs () << "ERROR: different bottom in block " << block << "\n";
+      errors++;
+    }
+    sparse_prev = sparse;
+    dense_prev = dense;
+    if (sparse.is_bottom () || block % 10 == 9) {
+      sparse = z_sdbm_domain_t::top ();
+      dense = dense_sdbm_t::top ();
+    }
+  }
+  crab::outs () << (errors == 0 ? "OK" : "FAILED") << "\n";
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/domains/flat_maps.hpp>
+#include <crab/domains/separate_domains.hpp>
+#include <random>
+
+/*
+   The environments of separate_domain backed by flat maps and by
+   adaptive maps must behave as the ones backed by patricia trees.
+
+   A random sequence of operations is applied to the three kinds of
+   environments and their results are compared after each step. The
+   adaptive maps switch to patricia trees after 8 bindings so that
+   both representations and the conversions are exercised.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace ikos;
+
+typedef interval<z_number> interval_t;
+typedef separate_domain<varname_t, interval_t,
+                        patricia_tree<varname_t, interval_t> > tree_env_t;
+typedef separate_domain<varname_t, interval_t,
+                        flat_map<varname_t, interval_t> > flat_env_t;
+typedef separate_domain<varname_t, interval_t,
+                        adaptive_map<varname_t, interval_t, 8> > adaptive_env_t;
+
+template<typename Env>
+string to_string (Env e) {
+  crab::crab_string_os o;
+  e.write (o);
+  return o.str ();
+}
+
+struct envs {
+  tree_env_t t;
+  flat_env_t f;
+  adaptive_env_t a;
+
+  bool check (const string &op) {
+    string st = to_string (t), sf = to_string (f), sa = to_string (a);
+    if (st != sf || st != sa) {
+      crab::outs () << "ERROR after " << op << ":\n"
+                    << "  patricia: " << st << "\n"
+                    << "  flat:     " << sf << "\n"
+                    << "  adaptive: " << sa << "\n";
+      return false;
+    }
+    return true;
+  }
+};
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<varname_t> vars;
+  for (unsigned i=0; i < 24; i++)
+    vars.push_back (vfac ["v" + std::to_string (i)]);
+
+  mt19937 gen (42);
+  auto rnd = [&gen] (unsigned n) { return (unsigned) (gen () % n); };
+  auto rnd_interval = [&] () {
+    int lb = (int) rnd (20) - 10;
+    return interval_t (z_number (lb), z_number (lb + (int) rnd (10)));
+  };
+
+  const unsigned num_envs = 4;
+  vector<envs> e (num_envs);
+  bool res = true;
+  for (unsigned step=0; step < 20000 && res; step++) {
+    envs &x = e [rnd (num_envs)];
+    envs &y = e [rnd (num_envs)];
+    switch (rnd (9)) {
+      case 0: case 1: case 2: {
+        varname_t v = vars [rnd (vars.size ())];
+        interval_t i = rnd (20) == 0 ? interval_t::top () : rnd_interval ();
+        x.t.set (v, i); x.f.set (v, i); x.a.set (v, i);
+        res = x.check ("set");
+        break;
+      }
+      case 3: {
+        varname_t v = vars [rnd (vars.size ())];
+        x.t -= v; x.f -= v; x.a -= v;
+        res = x.check ("forget");
+        break;
+      }
+      case 4: {
+        x.t = x.t | y.t; x.f = x.f | y.f; x.a = x.a | y.a;
+        res = x.check ("join");
+        break;
+      }
+      case 5: {
+        x.t = x.t & y.t; x.f = x.f & y.f; x.a = x.a & y.a;
+        res = x.check ("meet");
+        // keep the environments away from bottom
+        if (x.t.is_bottom ()) x = envs ();
+        break;
+      }
+      case 6: {
+        x.t = x.t || y.t; x.f = x.f || y.f; x.a = x.a || y.a;
+        res = x.check ("widening");
+        break;
+      }
+      case 7: {
+        bool bt = x.t <= y.t, bf = x.f <= y.f, ba = x.a <= y.a;
+        if (bt != bf || bt != ba) {
+          crab::outs () << "ERROR: inclusion differs on\n"
+                        << "  " << to_string (x.t) << "\n"
+                        << "  " << to_string (y.t) << "\n";
+          res = false;
+        }
+        break;
+      }
+      default: {
+        x = y;
+        res = x.check ("copy");
+        break;
+      }
+    }
+  }
+
+  crab::outs () << (res ? "OK" : "FAILED") << "\n";
+  return res ? 0 : 1;
+}
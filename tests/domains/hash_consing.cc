@@ -0,0 +1,96 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/domains/patricia_trees.hpp>
+#include <random>
+#include <set>
+#include <thread>
+
+/*
+   Patricia trees must behave the same with hash-consing enabled.
+
+   Several threads apply random operations to sets of variables and
+   compare them with std::set after each step. Since all threads use
+   the same variables, the hash-consed trees are shared by the
+   threads.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace ikos;
+
+typedef patricia_tree_set<varname_t> set_t;
+typedef std::set<varname_t> ref_set_t;
+
+bool same (const set_t &s, const ref_set_t &r) {
+  if (s.size () != r.size ()) return false;
+  for (auto v: s)
+    if (!r.count (v)) return false;
+  return true;
+}
+
+bool run (const vector<varname_t> &vars, unsigned seed) {
+  mt19937 gen (seed);
+  auto rnd = [&gen] (unsigned n) { return (unsigned) (gen () % n); };
+  const unsigned num_sets = 4;
+  vector<set_t> s (num_sets);
+  vector<ref_set_t> r (num_sets);
+  for (unsigned step=0; step < 20000; step++) {
+    unsigned i = rnd (num_sets), j = rnd (num_sets);
+    varname_t v = vars [rnd (vars.size ())];
+    switch (rnd (6)) {
+      case 0: case 1:
+        s [i] += v; r [i].insert (v);
+        break;
+      case 2:
+        s [i] -= v; r [i].erase (v);
+        break;
+      case 3:
+        s [i] |= s [j]; r [i].insert (r [j].begin (), r [j].end ());
+        break;
+      case 4: {
+        s [i] &= s [j];
+        ref_set_t x;
+        for (auto w: r [i]) if (r [j].count (w)) x.insert (w);
+        r [i] = x;
+        break;
+      }
+      default: {
+        bool incl = includes (r [j].begin (), r [j].end (),
+                              r [i].begin (), r [i].end ());
+        if ((s [i] <= s [j]) != incl || (s [i] == s [j]) != (r [i] == r [j]))
+          return false;
+        break;
+      }
+    }
+    if (!same (s [i], r [i])) return false;
+  }
+  return true;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<varname_t> vars;
+  for (unsigned i=0; i < 40; i++)
+    vars.push_back (vfac ["v" + std::to_string (i)]);
+
+  patricia_tree_hash_consing (true);
+  const unsigned num_threads = 8;
+  vector<char> ok (num_threads, 0);
+  vector<thread> threads;
+  for (unsigned i=0; i < num_threads; i++)
+    threads.push_back (thread ([&vars, &ok, i] () { ok [i] = run (vars, i); }));
+  for (auto &t: threads) t.join ();
+  patricia_tree_hash_consing (false);
+
+  bool res = true;
+  for (unsigned i=0; i < num_threads; i++) {
+    if (!ok [i]) {
+      crab::outs () << "ERROR: thread " << i << " computed a wrong set\n";
+      res = false;
+    }
+  }
+  crab::outs () << (res ? "OK" : "FAILED") << "\n";
+  return res ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/common/stats.hpp>
+#include <algorithm>
+#include <random>
+
+/*
+   SplitDBM must compute the same invariants with the hybrid and the
+   adaptive sparse graph representations.
+
+   The blocks alternate between phases where the joins and widenings
+   are computed on tightly related variables, so the graphs of the
+   hybrid DBM switch to the dense representation, and phases where
+   most relations are lost by the joins, so they switch back to the
+   sparse one. The constraints of both DBMs are compared up to their
+   order after each block.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+typedef SplitDBM<ikos::z_number, varname_t,
+                 SDBM_impl::DefaultParams<ikos::z_number, SDBM_impl::GraphRep::hybrid> >
+        hybrid_sdbm_t;
+
+// The constraints of d, sorted since the order of the edges of the
+// DBMs may differ
+template<typename Dom>
+string to_string (Dom &d) {
+  vector<string> csts;
+  for (auto c: d.to_linear_constraint_system ()) {
+    crab::crab_string_os o;
+    o << c;
+    csts.push_back (o.str ());
+  }
+  sort (csts.begin (), csts.end ());
+  string res;
+  for (auto &c: csts) res += c + "; ";
+  return res;
+}
+
+// A random state of the block: in the dense phase all variables
+// are bounded and related to the next one, otherwise they only have
+// a lower bound.
+template<typename Dom, typename Rnd>
+Dom make_state (const vector<z_var> &vars, bool dense, Rnd &rnd) {
+  Dom d;
+  if (dense) {
+    for (unsigned i=0; i < vars.size (); i++) {
+      d += z_lin_cst_t (vars [i] >= 0);
+      d += z_lin_cst_t (vars [i] <= 20 + rnd (5));
+      if (i + 1 < vars.size ()) {
+        d += z_lin_cst_t (vars [i] - vars [i + 1] <= rnd (5));
+        d += z_lin_cst_t (vars [i + 1] - vars [i] <= rnd (5));
+      }
+    }
+  } else {
+    for (auto &x: vars)
+      d += z_lin_cst_t (x >= rnd (5));
+  }
+  return d;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 12; i++)
+    vars.push_back (z_var (vfac ["x" + std::to_string (i)]));
+
+  z_sdbm_domain_t sparse;
+  hybrid_sdbm_t hybrid;
+  unsigned errors = 0;
+  for (unsigned block=0; block < 100; block++) {
+    bool dense = (block / 10) % 2 == 0;
+    // the same random states for both representations
+    mt19937 gen (block), hgen (block);
+    auto rnd = [&gen] (unsigned n) { return (unsigned) (gen () % n); };
+    auto hrnd = [&hgen] (unsigned n) { return (unsigned) (hgen () % n); };
+    z_sdbm_domain_t s1 = make_state<z_sdbm_domain_t> (vars, dense, rnd);
+    hybrid_sdbm_t h1 = make_state<hybrid_sdbm_t> (vars, dense, hrnd);
+    if (dense) {
+      z_sdbm_domain_t s2 = make_state<z_sdbm_domain_t> (vars, dense, rnd);
+      hybrid_sdbm_t h2 = make_state<hybrid_sdbm_t> (vars, dense, hrnd);
+      sparse = s1 | s2;
+      hybrid = h1 | h2;
+      if (block % 3 == 0) {
+        sparse = s1 || sparse;
+        hybrid = h1 || hybrid;
+      }
+    } else {
+      sparse = sparse | s1;
+      hybrid = hybrid | h1;
+    }
+    if (to_string (sparse) != to_string (hybrid)) {
+      crab::outs () << "ERROR: different constraints in block " << block << "\n"
+                    << "sparse: " << to_string (sparse) << "\n"
+                    << "hybrid: " << to_string (hybrid) << "\n";
+      errors++;
+    }
+  }
+
+#ifdef HAVE_STATS
+  unsigned to_dense = crab::CrabStats::get (hybrid_sdbm_t::getDomainName () + ".count.to_dense");
+  unsigned to_sparse = crab::CrabStats::get (hybrid_sdbm_t::getDomainName () + ".count.to_sparse");
+  crab::outs () << "switches to dense: " << to_dense << ", to sparse: " << to_sparse << "\n";
+  if (to_dense == 0 || to_sparse == 0) {
+    crab::outs () << "ERROR: the hybrid graphs did not switch\n";
+    errors++;
+  }
+#endif
+  crab::outs () << (errors == 0 ? "OK" : "FAILED") << "\n";
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <algorithm>
+#include <random>
+
+/*
+   SplitDBM must compute the same invariants whether the closure after
+   an assignment is deferred or not.
+
+   Random blocks of assignments, forgets and constraints are applied
+   to a lazy and an eager SplitDBM. The intervals of the variables are
+   compared after each step and the constraints of both DBMs at the
+   end of each block, where both are also joined with the state of
+   the previous block. The constraints are compared up to their
+   order.
+*/
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+template<typename Number>
+class EagerParams: public SDBM_impl::DefaultParams<Number> {
+ public:
+  enum { lazy_closure = 0 };
+};
+
+typedef SplitDBM<ikos::z_number, varname_t, EagerParams<ikos::z_number> > eager_sdbm_t;
+
+// The constraints of d, sorted since the order of the edges of the
+// DBMs may differ
+template<typename Dom>
+string to_string (Dom &d) {
+  vector<string> csts;
+  for (auto c: d.to_linear_constraint_system ()) {
+    crab::crab_string_os o;
+    o << c;
+    csts.push_back (o.str ());
+  }
+  sort (csts.begin (), csts.end ());
+  string res;
+  for (auto &c: csts) res += c + "; ";
+  return res;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 10; i++)
+    vars.push_back (z_var (vfac ["x" + std::to_string (i)]));
+
+  mt19937 gen (7);
+  auto rnd = [&gen] (unsigned n) { return (unsigned) (gen () % n); };
+  auto cst = [&rnd] () { return ikos::z_number ((long) rnd (21) - 10); };
+
+  z_sdbm_domain_t lazy, lazy_prev;
+  eager_sdbm_t eager, eager_prev;
+  unsigned errors = 0;
+  for (unsigned block=0; block < 200; block++) {
+    for (unsigned step=0; step < 20; step++) {
+      z_var &x = vars [rnd (vars.size ())];
+      z_var &y = vars [rnd (vars.size ())];
+      z_var &z = vars [rnd (vars.size ())];
+      ikos::z_number k = cst ();
+      switch (rnd (8)) {
+        case 0: case 1: case 2:
+          lazy.assign (x.name (), y + k);
+          eager.assign (x.name (), y + k);
+          break;
+        case 3:
+          lazy.assign (x.name (), y + z);
+          eager.assign (x.name (), y + z);
+          break;
+        case 4: {
+          z_lin_t e (k);
+          lazy.assign (x.name (), e);
+          eager.assign (x.name (), e);
+          break;
+        }
+        case 5:
+          lazy -= x.name ();
+          eager -= x.name ();
+          break;
+        case 6: {
+          z_lin_cst_t c (x - y <= k + 5);
+          lazy += c;
+          eager += c;
+          break;
+        }
+        default: {
+          z_lin_cst_t c (x <= k + 20);
+          lazy += c;
+          eager += c;
+          break;
+        }
+      }
+      for (auto &v: vars) {
+        if (!(lazy [v.name ()] == eager [v.name ()])) {
+          crab::outs () << "ERROR: different intervals for " << v << " in block "
+                        << block << "\n";
+          errors++;
+        }
+      }
+    }
+    if (to_string (lazy) != to_string (eager)) {
+      crab::outs () << "ERROR: different constraints in block " << block << "\n"
+                    << "lazy: " << to_string (lazy) << "\n"
+                    << "eager: " << to_string (eager) << "\n";
+      errors++;
+    }
+    if (block % 2) {
+      lazy = lazy | lazy_prev;
+      eager = eager | eager_prev;
+    }
+    lazy_prev = lazy;
+    eager_prev = eager;
+    if (lazy.is_bottom ()) {
+      lazy = z_sdbm_domain_t::top ();
+      eager = eager_sdbm_t::top ();
+    }
+  }
+  crab::outs () << (errors == 0 ? "OK" : "FAILED") << "\n";
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+/*
+   The packing domain must keep the relations between the variables
+   of the same pack and compute the same intervals as SplitDBM when
+   no relation between packs is needed.
+
+   The program has two independent loops so there are two packs
+   ({i,n} and {j,m}) and k is not packed.
+*/
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+z_cfg_t* prog (variable_factory_t &vfac) {
+  z_var i (vfac ["i"]);
+  z_var n (vfac ["n"]);
+  z_var j (vfac ["j"]);
+  z_var m (vfac ["m"]);
+  z_var k (vfac ["k"]);
+
+  z_cfg_t* cfg = new z_cfg_t ("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& bb2   = cfg->insert ("bb2");
+  z_basic_block_t& bb2_t = cfg->insert ("bb2_t");
+  z_basic_block_t& bb2_f = cfg->insert ("bb2_f");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f; bb1_t >> bb1;
+  bb1_f >> bb2;
+  bb2 >> bb2_t; bb2 >> bb2_f; bb2_t >> bb2;
+  bb2_f >> ret;
+  entry.assign (i, 0);
+  entry.assign (j, 0);
+  entry.assign (k, 5);
+  entry.assume (n >= 1);
+  entry.assume (m <= 50);
+  bb1_t.assume (i <= n - 1);
+  bb1_t.add (i, i, 1);
+  bb1_f.assume (i >= n);
+  bb2_t.assume (j <= m - 1);
+  bb2_t.add (j, j, 2);
+  bb2_f.assume (j >= m);
+  ret.add (k, k, 1);
+  return cfg;
+}
+
+int main (int argc, char** argv) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  vector<varname_t> vars = { vfac ["i"], vfac ["n"], vfac ["j"], vfac ["m"], vfac ["k"] };
+
+  intra_fwd_analyzer<z_cfg_ref_t, z_sdbm_domain_t> a (*cfg, z_sdbm_domain_t::top ());
+  a.run ();
+  intra_fwd_analyzer<z_cfg_ref_t, z_pack_sdbm_domain_t> pa (*cfg, z_pack_sdbm_domain_t::top ());
+  pa.run ();
+
+  bool res = true;
+  for (auto &b : *cfg) {
+    auto inv = a [b.label ()];
+    auto pinv = pa [b.label ()];
+    crab::outs () << get_label_str (b.label ()) << "=" << pinv << "\n";
+    for (auto v: vars) {
+      if (!(inv [v] == pinv [v])) {
+        crab::outs () << "ERROR: different intervals for " << v << " at "
+                      << get_label_str (b.label ()) << "\n";
+        res = false;
+      }
+    }
+  }
+
+  auto pinv = pa [cfg->exit ()];
+  crab::outs () << pinv.get_packing () << "\n";
+  if (pinv.get_packing ().num_packs () != 2 || pinv.get_packing ().pack_of (vfac ["k"])) {
+    crab::outs () << "ERROR: wrong packs\n";
+    res = false;
+  }
+  // i = n and m <= j at the exit
+  z_var i (vfac ["i"]), n (vfac ["n"]), j (vfac ["j"]), m (vfac ["m"]);
+  z_lin_cst_sys_t csts;
+  csts += z_lin_cst_t (i - n <= 0);
+  csts += z_lin_cst_t (n - i <= 0);
+  csts += z_lin_cst_t (m - j <= 0);
+  for (auto c: csts) {
+    z_pack_sdbm_domain_t neg = pinv;
+    neg += c.negate ();
+    if (!neg.is_bottom ()) {
+      crab::outs () << "ERROR: " << c << " does not hold at the exit\n";
+      res = false;
+    }
+  }
+  // an operation involving both packs is done on intervals
+  pinv.assign (i.name (), j + m);
+  if (!(pinv [i.name ()] == pinv [j.name ()] + pinv [m.name ()])) {
+    crab::outs () << "ERROR: wrong interval for " << i << "\n";
+    res = false;
+  }
+
+  delete cfg;
+  crab::outs () << (res ? "OK" : "FAILED") << "\n";
+  return res ? 0 : 1;
+}
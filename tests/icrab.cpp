@@ -11,7 +11,8 @@ void inter_run_impl (CG* cg,
 		     unsigned widening, 
 		     unsigned narrowing, 
 		     unsigned jump_set_size,
-		     bool enable_stats) {
+		     bool enable_stats,
+		     unsigned num_threads) {
   
   typedef crab::cg::call_graph_ref<CG> cg_ref_t;
   cg_ref_t cg_ref (*cg);
@@ -20,7 +21,8 @@ void inter_run_impl (CG* cg,
 	       << "summary domain=" << BUDom::getDomainName () 
 	       << "and forward domain=" << TDDom::getDomainName () << "\n";
   
-  InterFwdAnalyzer a (cg_ref, nullptr /*live*/, widening, narrowing, jump_set_size);
+  InterFwdAnalyzer a (cg_ref, nullptr /*live*/, widening, narrowing, jump_set_size,
+		      num_threads);
   a.Run ();
   
   // Print invariants
@@ -61,11 +63,12 @@ void inter_run (crab::cg_impl::z_cg_t* cg,
 		unsigned widening, 
 		unsigned narrowing, 
 		unsigned jump_set_size,
-		bool enable_stats) {
+		bool enable_stats,
+		unsigned num_threads) {
   using namespace crab::analyzer;
   typedef inter_fwd_analyzer<crab::cg_impl::z_cg_ref_t, BUDom, TDDom> inter_fwd_analyzer_t;
   inter_run_impl<crab::cg_impl::z_cg_t, BUDom, TDDom, inter_fwd_analyzer_t>
-    (cg, run_liveness, widening, narrowing, jump_set_size, enable_stats);
+    (cg, run_liveness, widening, narrowing, jump_set_size, enable_stats, num_threads);
 }
 
 ///////
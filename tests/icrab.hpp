@@ -10,7 +10,8 @@ extern void inter_run (crab::cg_impl::z_cg_t* cg,
 		       unsigned widening, 
 		       unsigned narrowing, 
 		       unsigned jump_set_size,
-		       bool enable_stats);
+		       bool enable_stats,
+		       unsigned num_threads);
    
 #endif 
 
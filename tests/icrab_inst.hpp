@@ -2,7 +2,7 @@
 
 #define Z_RUNNER(BUDOM,TDDOM)		    \
 template void inter_run<BUDOM,TDDOM>	    \
-(crab::cg_impl::z_cg_t*, bool, unsigned, unsigned, unsigned, bool);
+(crab::cg_impl::z_cg_t*, bool, unsigned, unsigned, unsigned, bool, unsigned);
 
 Z_RUNNER(crab::domain_impl::z_dbm_domain_t, crab::domain_impl::z_interval_domain_t)
 #ifdef HAVE_APRON
@@ -171,12 +171,12 @@ int main (int argc, char** argv ) {
   typedef call_graph_ref<callgraph_t> callgraph_ref_t;
 
   boost::scoped_ptr<callgraph_t> cg(new callgraph_t(cfgs));
-  inter_run<z_dbm_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled);
+  inter_run<z_dbm_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled, num_threads);
 #ifdef HAVE_APRON  
-  inter_run<z_opt_oct_apron_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled);
+  inter_run<z_opt_oct_apron_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled, num_threads);
 #endif   
-  inter_run<z_term_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled);
-  inter_run<z_num_domain_t, z_num_domain_t> (&*cg, false, 2, 2, 20, stats_enabled);  
+  inter_run<z_term_domain_t, z_interval_domain_t> (&*cg, false, 2, 2, 20, stats_enabled, num_threads);
+  inter_run<z_num_domain_t, z_num_domain_t> (&*cg, false, 2, 2, 20, stats_enabled, num_threads);  
   
   delete t1;
   delete t2;
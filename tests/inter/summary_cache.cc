@@ -0,0 +1,155 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+#include <crab/cg/cg_bgl.hpp>
+#include <crab/analysis/graphs/sccg_bgl.hpp>
+#include <crab/analysis/inter_fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::cg;
+
+z_cfg_t* foo (variable_factory_t &vfac) {
+  vector<pair<varname_t,crab::variable_type> > params;
+  params.push_back (make_pair (vfac["x"], crab::INT_TYPE));
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["foo"], params);
+  // Defining program variables
+  z_var x (vfac ["x"]);
+  z_var y (vfac ["y"]);
+  z_var z (vfac ["z"]);
+  // entry and exit block
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  // adding blocks
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit   = cfg->insert ("exit");
+  // adding control flow
+  entry >> exit;
+  // adding statements
+  entry.assume (x >= 0);
+  entry.add (y, x, 1);
+  exit.add (z , y , 2);
+  exit.ret (vfac ["z"], crab::INT_TYPE);
+  return cfg;
+}
+
+z_cfg_t* bar (variable_factory_t &vfac) {
+  vector<pair<varname_t,crab::variable_type> > params;
+  params.push_back (make_pair (vfac["a"], crab::INT_TYPE));
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["bar"], params);
+  // Defining program variables
+  z_var a (vfac ["a"]);
+  z_var x (vfac ["x1"]);
+  z_var w (vfac ["w1"]);
+  // entry and exit block
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  // adding blocks
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit   = cfg->insert ("exit");
+  // adding control flow
+  entry >> exit;
+  // adding statements
+  entry.assign (x, a);
+  entry.assign (w, 5);
+  vector<pair<varname_t,crab::variable_type> > args;
+  args.push_back (make_pair (vfac["x1"], crab::INT_TYPE));
+  exit.callsite (make_pair (vfac["y1"], crab::INT_TYPE), vfac ["foo"], args);
+  exit.ret (vfac["y1"], crab::INT_TYPE);
+  return cfg;
+}
+
+z_cfg_t* m (variable_factory_t &vfac)  {
+  vector<pair<varname_t,crab::variable_type> > params;
+  function_decl<varname_t> decl (crab::INT_TYPE, vfac["main"], params);
+  // Defining program variables
+  z_var x (vfac ["x2"]);
+  // entry and exit block
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  // adding blocks
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit   = cfg->insert ("exit");
+  // adding control flow
+  entry >> exit;
+  // adding statements
+  entry.assign(x, 3);
+  vector<pair<varname_t,crab::variable_type> > args;
+  args.push_back (make_pair (vfac["x2"], crab::INT_TYPE));
+  entry.callsite (make_pair (vfac["y2"], crab::INT_TYPE), vfac ["bar"], args);
+  exit.ret (vfac["y2"], crab::INT_TYPE);
+  return cfg;
+}
+
+typedef call_graph<z_cfg_ref_t> callgraph_t;
+typedef call_graph_ref<callgraph_t> callgraph_ref_t;
+
+// Run the analysis using the summaries stored in file and return the
+// number of summaries that were reused.
+template<typename Dom>
+unsigned run (callgraph_t &cg, const string &file,
+              vector<Dom> &summaries) {
+  typedef inter_fwd_analyzer<callgraph_ref_t, Dom, z_interval_domain_t> analyzer_t;
+  typename analyzer_t::summ_cache_t cache;
+  cache.load (file);
+  analyzer_t a (callgraph_ref_t (cg), nullptr, 1, 2, 20, 1, &cache);
+  a.Run ();
+  summaries.clear ();
+  for (auto &v: boost::make_iterator_range (callgraph_ref_t (cg).nodes ())) {
+    auto cfg = v.get_cfg ();
+    if (a.has_summary (cfg)) {
+      auto fdecl = cfg.get_func_decl ();
+      Dom sum = a.get_summary (cfg);
+      crab::outs() << "Summary for " << *fdecl << ": " << sum << "\n";
+      summaries.push_back (sum);
+    }
+  }
+  cache.save (file);
+  return cache.num_hits ();
+}
+
+// If exact then the reused summaries must be equal to the computed
+// ones. Otherwise they only need to be sound.
+template<typename Dom>
+bool check (variable_factory_t &vfac, const string &name, bool exact) {
+  string file = "summary_cache_" + name + ".db";
+  std::remove (file.c_str ());
+
+  z_cfg_t* t1 = foo (vfac);
+  z_cfg_t* t2 = bar (vfac);
+  z_cfg_t* t3 = m (vfac);
+  vector<z_cfg_ref_t> cfgs = { *t1, *t2, *t3 };
+  callgraph_t cg (cfgs);
+
+  bool res = true;
+  vector<Dom> s1, s2, s3;
+  // nothing is cached the first time
+  res &= (run<Dom> (cg, file, s1) == 0);
+  // foo and bar are reused the second time
+  res &= (run<Dom> (cg, file, s2) == 2);
+  res &= (s1.size () == s2.size ());
+  for (unsigned i=0; res && i < s1.size (); i++)
+    res &= (s1 [i] <= s2 [i] && (!exact || s2 [i] <= s1 [i]));
+  // after modifying foo the summaries of foo and bar are recomputed
+  t1->get_node ("exit").add (z_var (vfac ["z"]), z_var (vfac ["z"]), 1);
+  res &= (run<Dom> (cg, file, s3) == 0);
+
+  std::remove (file.c_str ());
+  delete t1;
+  delete t2;
+  delete t3;
+  if (!res) crab::outs() << "ERROR: unexpected summaries for " << Dom::getDomainName () << "\n";
+  return res;
+}
+
+int main (int argc, char** argv ) {
+
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool res = true;
+  res &= check<z_interval_domain_t> (vfac, "intervals", true);
+  res &= check<z_sdbm_domain_t> (vfac, "sdbm", true);
+  res &= check<z_num_domain_t> (vfac, "num", false);
+  return res ? 0 : 1;
+}
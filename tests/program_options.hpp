@@ -7,12 +7,16 @@
 
 namespace {
   bool stats_enabled = false;                                                                         
+  unsigned num_threads = 1;                                                                           
   #define SET_TEST_OPTIONS(ARGC,ARGV)                                                                 \
   boost::program_options::options_description po("Test Options");                                     \
   po.add_options()                                                                                    \
   ("log",  boost::program_options::value<std::vector<std::string> >(), "Enable specified log level"); \
   po.add_options()                                                                                    \
       ("stats",boost::program_options::bool_switch(&stats_enabled), "Enable stats");                  \
+  po.add_options()                                                                                    \
+      ("threads",boost::program_options::value<unsigned>(&num_threads)->default_value(1),             \
+       "Number of threads used by the inter-procedural analysis");                                    \
   boost::program_options::options_description cmmdline_options;                                       \
   cmmdline_options.add(po);                                                                           \
   boost::program_options::variables_map vm;                                                           \